@@ -21,10 +21,22 @@ typedef enum {
     MOMENT_PARAM_REDUCED,
     MOMENT_PARAM_EPOCH,
     MOMENT_PARAM_PRECISION,
+    MOMENT_PARAM_FROM,
+    MOMENT_PARAM_TO,
+    MOMENT_PARAM_WEEKEND,
+    MOMENT_PARAM_HOLIDAYS,
+    MOMENT_PARAM_DAY_OF_WEEK,
+    MOMENT_PARAM_ORDINAL,
+    MOMENT_PARAM_EASTER,
+    MOMENT_PARAM_COMPUTUS,
+    MOMENT_PARAM_OBSERVED,
 } moment_param_t;
 
 typedef int64_t I64V;
 
+/* A mutable moment, Time::Moment::Builder */
+typedef moment_t moment_builder_t;
+
 #if IVSIZE >= 8
 # define SvI64V(sv)         (I64V)SvIV(sv)
 # define newSVi64v(i64)     newSViv((IV)i64)
@@ -62,6 +74,14 @@ typedef int64_t I64V;
 #define MY_CXT_KEY "Time::Moment::_guts" XS_VERSION
 typedef struct {
     HV *stash;
+    HV *duration_stash;
+    HV *interval_stash;
+    HV *interval_set_stash;
+    HV *range_stash;
+    HV *builder_stash;
+    HV *business_stash;
+    HV *cron_stash;
+    HV *rrule_stash;
 } my_cxt_t;
 
 START_MY_CXT
@@ -69,11 +89,23 @@ START_MY_CXT
 static void
 setup_my_cxt(pTHX_ pMY_CXT) {
     MY_CXT.stash = gv_stashpvs("Time::Moment", GV_ADD);
+    MY_CXT.duration_stash = gv_stashpvs("Time::Moment::Duration", GV_ADD);
+    MY_CXT.interval_stash = gv_stashpvs("Time::Moment::Interval", GV_ADD);
+    MY_CXT.interval_set_stash = gv_stashpvs("Time::Moment::IntervalSet", GV_ADD);
+    MY_CXT.range_stash = gv_stashpvs("Time::Moment::Range", GV_ADD);
+    MY_CXT.builder_stash = gv_stashpvs("Time::Moment::Builder", GV_ADD);
+    MY_CXT.business_stash = gv_stashpvs("Time::Moment::BusinessCalendar", GV_ADD);
+    MY_CXT.cron_stash = gv_stashpvs("Time::Moment::Cron", GV_ADD);
+    MY_CXT.rrule_stash = gv_stashpvs("Time::Moment::Recurrence", GV_ADD);
 }
 
 static moment_param_t
 moment_param(const char *s, const STRLEN len) {
     switch (len) {
+        case 2:
+            if (memEQ(s, "to", 2))
+                return MOMENT_PARAM_TO;
+            break;
         case 3:
             if (memEQ(s, "day", 3))
                 return MOMENT_PARAM_DAY;
@@ -83,6 +115,8 @@ moment_param(const char *s, const STRLEN len) {
                 return MOMENT_PARAM_YEAR;
             if (memEQ(s, "hour", 4))
                 return MOMENT_PARAM_HOUR;
+            if (memEQ(s, "from", 4))
+                return MOMENT_PARAM_FROM;
             break;
         case 5:
             if (memEQ(s, "month", 5))
@@ -97,12 +131,26 @@ moment_param(const char *s, const STRLEN len) {
                 return MOMENT_PARAM_SECOND;
             if (memEQ(s, "offset", 6))
                 return MOMENT_PARAM_OFFSET;
+            if (memEQ(s, "easter", 6))
+                return MOMENT_PARAM_EASTER;
             break;
         case 7:
             if (memEQ(s, "lenient", 7))
                 return MOMENT_PARAM_LENIENT;
             if (memEQ(s, "reduced", 7))
                 return MOMENT_PARAM_REDUCED;
+            if (memEQ(s, "weekend", 7))
+                return MOMENT_PARAM_WEEKEND;
+            if (memEQ(s, "ordinal", 7))
+                return MOMENT_PARAM_ORDINAL;
+            break;
+        case 8:
+            if (memEQ(s, "holidays", 8))
+                return MOMENT_PARAM_HOLIDAYS;
+            if (memEQ(s, "computus", 8))
+                return MOMENT_PARAM_COMPUTUS;
+            if (memEQ(s, "observed", 8))
+                return MOMENT_PARAM_OBSERVED;
             break;
         case 9:
             if (memEQ(s, "precision", 9))
@@ -112,6 +160,10 @@ moment_param(const char *s, const STRLEN len) {
             if (memEQ(s, "nanosecond", 10))
                 return MOMENT_PARAM_NANOSECOND;
             break;
+        case 11:
+            if (memEQ(s, "day_of_week", 11))
+                return MOMENT_PARAM_DAY_OF_WEEK;
+            break;
     }
     return MOMENT_PARAM_UNKNOWN;
 }
@@ -125,6 +177,274 @@ THX_sv_moment_param(pTHX_ SV *sv) {
     return moment_param(str, len);
 }
 
+/* Returns the unit named as in the plus_<unit> methods, or -1 */
+static int
+moment_unit(const char *s, const STRLEN len) {
+    switch (len) {
+        case 4:
+            if (memEQ(s, "days", 4))
+                return MOMENT_UNIT_DAYS;
+            break;
+        case 5:
+            if (memEQ(s, "years", 5))
+                return MOMENT_UNIT_YEARS;
+            if (memEQ(s, "weeks", 5))
+                return MOMENT_UNIT_WEEKS;
+            if (memEQ(s, "hours", 5))
+                return MOMENT_UNIT_HOURS;
+            break;
+        case 6:
+            if (memEQ(s, "months", 6))
+                return MOMENT_UNIT_MONTHS;
+            break;
+        case 7:
+            if (memEQ(s, "minutes", 7))
+                return MOMENT_UNIT_MINUTES;
+            if (memEQ(s, "seconds", 7))
+                return MOMENT_UNIT_SECONDS;
+            break;
+        case 11:
+            if (memEQ(s, "nanoseconds", 11))
+                return MOMENT_UNIT_NANOS;
+            break;
+        case 12:
+            if (memEQ(s, "milliseconds", 12))
+                return MOMENT_UNIT_MILLIS;
+            if (memEQ(s, "microseconds", 12))
+                return MOMENT_UNIT_MICROS;
+            break;
+    }
+    return -1;
+}
+
+static moment_unit_t
+THX_sv_moment_unit(pTHX_ SV *sv) {
+    const char *str;
+    STRLEN len;
+    int u;
+
+    str = SvPV_const(sv, len);
+    u = moment_unit(str, len);
+    if (u < 0)
+        croak("Unrecognised unit: '%"SVf"'", sv);
+    return (moment_unit_t)u;
+}
+
+/* Returns the field named as its accessor method, or -1 */
+static int
+moment_field(const char *s, const STRLEN len) {
+    switch (len) {
+        case 3:
+            if (memEQ(s, "rdn", 3))
+                return MOMENT_FIELD_RATA_DIE_DAY;
+            break;
+        case 4:
+            if (memEQ(s, "year", 4))
+                return MOMENT_FIELD_YEAR;
+            if (memEQ(s, "week", 4))
+                return MOMENT_FIELD_WEEK_OF_YEAR;
+            if (memEQ(s, "hour", 4))
+                return MOMENT_FIELD_HOUR_OF_DAY;
+            break;
+        case 5:
+            if (memEQ(s, "month", 5))
+                return MOMENT_FIELD_MONTH_OF_YEAR;
+            break;
+        case 6:
+            if (memEQ(s, "minute", 6))
+                return MOMENT_FIELD_MINUTE_OF_HOUR;
+            if (memEQ(s, "second", 6))
+                return MOMENT_FIELD_SECOND_OF_MINUTE;
+            break;
+        case 7:
+            if (memEQ(s, "quarter", 7))
+                return MOMENT_FIELD_QUARTER_OF_YEAR;
+            break;
+        case 9:
+            if (memEQ(s, "precision", 9))
+                return MOMENT_FIELD_PRECISION;
+            break;
+        case 10:
+            if (memEQ(s, "nanosecond", 10))
+                return MOMENT_FIELD_NANO_OF_SECOND;
+            break;
+        case 11:
+            if (memEQ(s, "day_of_year", 11))
+                return MOMENT_FIELD_DAY_OF_YEAR;
+            if (memEQ(s, "day_of_week", 11))
+                return MOMENT_FIELD_DAY_OF_WEEK;
+            if (memEQ(s, "millisecond", 11))
+                return MOMENT_FIELD_MILLI_OF_SECOND;
+            if (memEQ(s, "microsecond", 11))
+                return MOMENT_FIELD_MICRO_OF_SECOND;
+            break;
+        case 12:
+            if (memEQ(s, "day_of_month", 12))
+                return MOMENT_FIELD_DAY_OF_MONTH;
+            break;
+        case 13:
+            if (memEQ(s, "minute_of_day", 13))
+                return MOMENT_FIELD_MINUTE_OF_DAY;
+            if (memEQ(s, "second_of_day", 13))
+                return MOMENT_FIELD_SECOND_OF_DAY;
+            break;
+        case 14:
+            if (memEQ(s, "day_of_quarter", 14))
+                return MOMENT_FIELD_DAY_OF_QUARTER;
+            break;
+        case 18:
+            if (memEQ(s, "millisecond_of_day", 18))
+                return MOMENT_FIELD_MILLI_OF_DAY;
+            break;
+    }
+    return -1;
+}
+
+static moment_component_t
+THX_sv_moment_field(pTHX_ SV *sv) {
+    const char *str;
+    STRLEN len;
+    int c;
+
+    str = SvPV_const(sv, len);
+    c = moment_field(str, len);
+    if (c < 0)
+        croak("Unrecognised field: '%"SVf"'", sv);
+    return (moment_component_t)c;
+}
+
+static moment_packed_t
+THX_sv_packed_format(pTHX_ SV *sv) {
+    const char *str;
+    STRLEN len;
+
+    str = SvPV_const(sv, len);
+    if (len == 6 && memEQ(str, "moment", 6))
+        return MOMENT_PACKED_MOMENT;
+    switch (moment_unit(str, len)) {
+        case MOMENT_UNIT_SECONDS: return MOMENT_PACKED_SECONDS;
+        case MOMENT_UNIT_MILLIS:  return MOMENT_PACKED_MILLIS;
+        case MOMENT_UNIT_MICROS:  return MOMENT_PACKED_MICROS;
+        case MOMENT_UNIT_NANOS:   return MOMENT_PACKED_NANOS;
+    }
+    croak("Unrecognised packed format: '%"SVf"'", sv);
+}
+
+/* Returns the elements of a packed buffer and stores their number in np */
+static const char *
+THX_sv_2packed(pTHX_ SV *sv, moment_packed_t f, const char *name, size_t *np) {
+    const size_t width = moment_packed_width(f);
+    const char *buf;
+    STRLEN len;
+
+    buf = SvPVbyte(sv, len);
+    if (len % width)
+        croak("%s is not a packed buffer of %d-byte elements", name, (int)width);
+    *np = len / width;
+    return buf;
+}
+
+/* As above, but for a buffer that is modified in place */
+static char *
+THX_sv_2packed_mutable(pTHX_ SV *sv, moment_packed_t f, const char *name, size_t *np) {
+    const size_t width = moment_packed_width(f);
+    char *buf;
+    STRLEN len;
+
+    if (SvREADONLY(sv))
+        croak("%s", PL_no_modify);
+    buf = SvPVbyte_force(sv, len);
+    if (len % width)
+        croak("%s is not a packed buffer of %d-byte elements", name, (int)width);
+    *np = len / width;
+    return buf;
+}
+
+/* Returns a new string of len bytes for a kernel to fill */
+static SV *
+THX_newSVpacked(pTHX_ size_t len) {
+    SV *sv = newSV(len + 1);
+
+    SvPOK_only(sv);
+    SvCUR_set(sv, len);
+    *SvEND(sv) = '\0';
+    return sv;
+}
+
+/*
+ * Applies a transform in place to a buffer of moments; returns the number
+ * of elements left unchanged and stores a mortal bitmap of them in failed
+ */
+static size_t
+THX_packed_transform(pTHX_ SV *buffer, moment_packed_op_t op, moment_unit_t u, int64_t v, SV **failed) {
+    char *buf;
+    size_t n, count;
+
+    buf = THX_sv_2packed_mutable(aTHX_ buffer, MOMENT_PACKED_MOMENT, "buffer", &n);
+    *failed = sv_2mortal(THX_newSVpacked(aTHX_ (n + 7) / 8));
+    count = moment_packed_transform(buf, n, op, u, v, (unsigned char *)SvPVX(*failed));
+    SvSETMAGIC(buffer);
+    return count;
+}
+
+/*
+ * Returns the zone map in a string, validated; a zone map that was read
+ * into a string at an unaligned address is copied into a mortal string.
+ */
+static const moment_zonemap_t *
+THX_sv_2zonemap(pTHX_ SV *sv) {
+    const char *blob;
+    STRLEN len;
+
+    blob = SvPVbyte(sv, len);
+    moment_zonemap_check(blob, len);
+    if (PTR2UV(blob) % sizeof(int64_t)) {
+        SV *copy = sv_2mortal(THX_newSVpacked(aTHX_ len));
+        Copy(blob, SvPVX(copy), len, char);
+        blob = SvPVX(copy);
+    }
+    return (const moment_zonemap_t *)blob;
+}
+
+#define FIELD_SET_MAX_SPAN (1 << 20)
+
+/* Reads a value or an ARRAY reference of values of a field into a set, freed at scope exit */
+static void
+THX_sv_2field_set(pTHX_ SV *name, SV *sv, moment_component_t c, moment_field_set_t *fs) {
+    AV *av = NULL;
+    IV min = 0, max = -1;
+    uint64_t *set;
+    I32 i, n = 1;
+
+    SvGETMAGIC(sv);
+    if (SvROK(sv)) {
+        if (SvTYPE(SvRV(sv)) != SVt_PVAV)
+            croak("Parameter '%"SVf"' is not an integer or an ARRAY reference", name);
+        av = (AV *)SvRV(sv);
+        n = av_len(av) + 1;
+    }
+    for (i = 0; i < n; i++) {
+        SV **svp = av ? av_fetch(av, i, 0) : &sv;
+        const IV v = svp ? SvIV(*svp) : 0;
+        if (i == 0 || v < min) min = v;
+        if (i == 0 || v > max) max = v;
+    }
+    if (min < INT32_MIN || max > INT32_MAX || max - min >= FIELD_SET_MAX_SPAN)
+        croak("Parameter '%"SVf"' has values spanning more than %d", name, FIELD_SET_MAX_SPAN);
+
+    Newxz(set, (max - min + 1 + 63) / 64 + 1, uint64_t);
+    SAVEFREEPV(set);
+    for (i = 0; i < n; i++) {
+        SV **svp = av ? av_fetch(av, i, 0) : &sv;
+        const IV v = (svp ? SvIV(*svp) : 0) - min;
+        set[v >> 6] |= UINT64_C(1) << (v & 63);
+    }
+    fs->field = c;
+    fs->min   = (int32_t)min;
+    fs->max   = (int32_t)max;
+    fs->set   = set;
+}
+
 static SV *
 THX_sv_as_object(pTHX_ SV *sv, const char *name) {
     dSP;
@@ -244,6 +564,17 @@ THX_sv_2moment(pTHX_ SV *sv, const char *name) {
     return *THX_sv_2moment_ptr(aTHX_ sv, name);
 }
 
+/* Anchors an interval that consists of only a duration at the reference */
+static void
+THX_interval_anchor(pTHX_ moment_iso_interval_t *interval, SV *reference) {
+    if (!reference || !SvOK(reference))
+        croak("%s", moment_status_message(MOMENT_ERR_INTERVAL_ANCHOR));
+    interval->start = *THX_sv_2moment_ptr(aTHX_ reference, "reference");
+    interval->end = moment_plus_period(&interval->start, &interval->period);
+    if (moment_compare_instant(&interval->end, &interval->start) < 0)
+        croak("%s", moment_status_message(MOMENT_ERR_INTERVAL_ORDER));
+}
+
 static SV *
 THX_sv_2moment_coerce_sv(pTHX_ SV *sv, HV *stash) {
     SV *res, *rv;
@@ -261,6 +592,301 @@ THX_sv_2moment_coerce_sv(pTHX_ SV *sv, HV *stash) {
     return res;
 }
 
+static SV *
+THX_newSVduration(pTHX_ const moment_duration_t *d, HV *stash) {
+    SV *pv = newSVpvn((const char *)d, sizeof(moment_duration_t));
+    SV *sv = newRV_noinc(pv);
+    sv_bless(sv, stash);
+    return sv;
+}
+
+static SV *
+THX_sv_set_duration(pTHX_ SV *sv, const moment_duration_t *d) {
+    if (!SvROK(sv))
+        croak("panic: sv_set_duration called with nonreference");
+    sv_setpvn_mg(SvRV(sv), (const char *)d, sizeof(moment_duration_t));
+    SvTEMP_off(sv);
+    return sv;
+}
+
+static bool
+THX_sv_isa_duration(pTHX_ SV *sv) {
+    dMY_CXT;
+    return THX_sv_isa_stash(aTHX_ sv, "Time::Moment::Duration",
+        MY_CXT.duration_stash, sizeof(moment_duration_t));
+}
+
+static moment_duration_t *
+THX_sv_2duration_ptr(pTHX_ SV *sv, const char *name) {
+    if (!THX_sv_isa_duration(aTHX_ sv))
+        croak("%s is not an instance of Time::Moment::Duration", name);
+    return (moment_duration_t *)SvPVX_const(SvRV(sv));
+}
+
+static SV *
+THX_newSVinterval(pTHX_ const moment_interval_t *iv, HV *stash) {
+    SV *pv = newSVpvn((const char *)iv, sizeof(moment_interval_t));
+    SV *sv = newRV_noinc(pv);
+    sv_bless(sv, stash);
+    return sv;
+}
+
+static bool
+THX_sv_isa_interval(pTHX_ SV *sv) {
+    dMY_CXT;
+    return THX_sv_isa_stash(aTHX_ sv, "Time::Moment::Interval",
+        MY_CXT.interval_stash, sizeof(moment_interval_t));
+}
+
+static moment_interval_t *
+THX_sv_2interval_ptr(pTHX_ SV *sv, const char *name) {
+    if (!THX_sv_isa_interval(aTHX_ sv))
+        croak("%s is not an instance of Time::Moment::Interval", name);
+    return (moment_interval_t *)SvPVX_const(SvRV(sv));
+}
+
+/* The intervals of a set are stored back to back, so its length varies */
+static bool
+THX_sv_isa_interval_set(pTHX_ SV *sv) {
+    dMY_CXT;
+    SV *rv;
+
+    SvGETMAGIC(sv);
+    if (!SvROK(sv))
+        return FALSE;
+    rv = SvRV(sv);
+    if (!(SvOBJECT(rv) && SvSTASH(rv) && SvPOKp(rv) && SvCUR(rv) % sizeof(moment_interval_t) == 0))
+        return FALSE;
+    return (SvSTASH(rv) == MY_CXT.interval_set_stash
+         || sv_derived_from(sv, "Time::Moment::IntervalSet"));
+}
+
+static const moment_interval_t *
+THX_sv_2interval_set_ptr(pTHX_ SV *sv, const char *name, size_t *np) {
+    if (!THX_sv_isa_interval_set(aTHX_ sv))
+        croak("%s is not an instance of Time::Moment::IntervalSet", name);
+    *np = SvCUR(SvRV(sv)) / sizeof(moment_interval_t);
+    return (const moment_interval_t *)SvPVX_const(SvRV(sv));
+}
+
+/* Accepts a Time::Moment::IntervalSet or a single Time::Moment::Interval */
+static const moment_interval_t *
+THX_sv_2interval_set(pTHX_ SV *sv, const char *name, size_t *np) {
+    const moment_interval_t *iv;
+
+    if (THX_sv_isa_interval_set(aTHX_ sv))
+        return THX_sv_2interval_set_ptr(aTHX_ sv, name, np);
+    if (!THX_sv_isa_interval(aTHX_ sv))
+        croak("%s is not an instance of Time::Moment::IntervalSet or Time::Moment::Interval", name);
+    iv = (const moment_interval_t *)SvPVX_const(SvRV(sv));
+    *np = moment_interval_is_empty(iv) ? 0 : 1;
+    return iv;
+}
+
+/* Stores a moment in the target of an iterator, in place when no one else can observe it */
+static void
+THX_sv_set_target_moment(pTHX_ SV *target, const moment_t *mt) {
+    dMY_CXT;
+    if (SvROK(target) && SvREFCNT(SvRV(target)) == 1 && THX_sv_isa_moment(aTHX_ target))
+        THX_sv_set_moment(aTHX_ target, mt);
+    else
+        sv_setsv_mg(target, sv_2mortal(THX_newSVmoment(aTHX_ mt, MY_CXT.stash)));
+}
+
+/* Appends a moment to a packed string of moments, growing it geometrically */
+static void
+THX_sv_cat_moment(pTHX_ SV *sv, const moment_t *mt) {
+    const STRLEN cur = SvCUR(sv);
+    if (SvLEN(sv) <= cur + sizeof(moment_t))
+        SvGROW(sv, 2 * (cur + sizeof(moment_t)));
+    Copy(mt, SvPVX(sv) + cur, 1, moment_t);
+    SvCUR_set(sv, cur + sizeof(moment_t));
+}
+
+static SV *
+THX_newSVrange(pTHX_ const moment_range_t *r, HV *stash) {
+    SV *pv = newSVpvn((const char *)r, sizeof(moment_range_t));
+    SV *sv = newRV_noinc(pv);
+    sv_bless(sv, stash);
+    return sv;
+}
+
+static moment_range_t *
+THX_sv_2range_ptr(pTHX_ SV *sv, const char *name) {
+    dMY_CXT;
+    if (!THX_sv_isa_stash(aTHX_ sv, "Time::Moment::Range",
+        MY_CXT.range_stash, sizeof(moment_range_t)))
+        croak("%s is not an instance of Time::Moment::Range", name);
+    return (moment_range_t *)SvPVX(SvRV(sv));
+}
+
+static SV *
+THX_newSVcron(pTHX_ const moment_cron_t *cron, HV *stash) {
+    SV *pv = newSVpvn((const char *)cron, sizeof(moment_cron_t));
+    SV *sv = newRV_noinc(pv);
+    sv_bless(sv, stash);
+    return sv;
+}
+
+static const moment_cron_t *
+THX_sv_2cron_ptr(pTHX_ SV *sv, const char *name) {
+    dMY_CXT;
+    if (!THX_sv_isa_stash(aTHX_ sv, "Time::Moment::Cron",
+        MY_CXT.cron_stash, sizeof(moment_cron_t)))
+        croak("%s is not an instance of Time::Moment::Cron", name);
+    return (const moment_cron_t *)SvPVX_const(SvRV(sv));
+}
+
+static moment_rrule_t *
+THX_sv_2rrule_ptr(pTHX_ SV *sv, const char *name) {
+    dMY_CXT;
+    if (!THX_sv_isa_stash(aTHX_ sv, "Time::Moment::Recurrence",
+        MY_CXT.rrule_stash, sizeof(moment_rrule_t)))
+        croak("%s is not an instance of Time::Moment::Recurrence", name);
+    return (moment_rrule_t *)SvPVX(SvRV(sv));
+}
+
+static moment_builder_t *
+THX_sv_2builder_ptr(pTHX_ SV *sv, const char *name) {
+    dMY_CXT;
+    if (!THX_sv_isa_stash(aTHX_ sv, "Time::Moment::Builder",
+        MY_CXT.builder_stash, sizeof(moment_builder_t)))
+        croak("%s is not an instance of Time::Moment::Builder", name);
+    return (moment_builder_t *)SvPVX_const(SvRV(sv));
+}
+
+/* A calendar is stored as is, its length is given by its range of years */
+static const moment_business_t *
+THX_sv_2business_ptr(pTHX_ SV *sv, const char *name) {
+    dMY_CXT;
+    const moment_business_t *bc;
+    SV *rv;
+
+    SvGETMAGIC(sv);
+    if (!SvROK(sv))
+        goto error;
+    rv = SvRV(sv);
+    if (!(SvOBJECT(rv) && SvSTASH(rv) && SvPOKp(rv) && SvCUR(rv) >= sizeof(moment_business_t)))
+        goto error;
+    if (!(SvSTASH(rv) == MY_CXT.business_stash
+       || sv_derived_from(sv, "Time::Moment::BusinessCalendar")))
+        goto error;
+    bc = (const moment_business_t *)SvPVX_const(rv);
+    if (SvCUR(rv) != sizeof(moment_business_t)
+                   + bc->words * sizeof(uint64_t)
+                   + (bc->words + 1) * sizeof(uint32_t))
+        goto error;
+    return bc;
+  error:
+    croak("%s is not an instance of Time::Moment::BusinessCalendar", name);
+}
+
+static moment_observed_t
+THX_sv_moment_observed(pTHX_ SV *sv) {
+    const char *str;
+    STRLEN len;
+
+    str = SvPV_const(sv, len);
+    if (len == 4 && memEQ(str, "none", 4))
+        return MOMENT_OBSERVED_NONE;
+    if (len == 7 && memEQ(str, "nearest", 7))
+        return MOMENT_OBSERVED_NEAREST;
+    if (len == 4 && memEQ(str, "next", 4))
+        return MOMENT_OBSERVED_NEXT;
+    if (len == 8 && memEQ(str, "previous", 8))
+        return MOMENT_OBSERVED_PREVIOUS;
+    croak("Parameter 'observed' must be one of 'none', 'nearest', 'next' or 'previous'");
+}
+
+static dt_computus_t
+THX_sv_moment_computus(pTHX_ SV *sv) {
+    const char *str;
+    STRLEN len;
+
+    str = SvPV_const(sv, len);
+    if (len == 7 && memEQ(str, "western", 7))
+        return DT_WESTERN;
+    if (len == 8 && memEQ(str, "orthodox", 8))
+        return DT_ORTHODOX;
+    croak("Parameter 'computus' must be one of 'western' or 'orthodox'");
+}
+
+static void
+THX_sv_2holiday(pTHX_ SV *sv, moment_holiday_t *h) {
+    HV *hv;
+    HE *he;
+
+    SvGETMAGIC(sv);
+    if (!SvROK(sv) || SvTYPE(SvRV(sv)) != SVt_PVHV)
+        croak("holiday is not a HASH reference or an instance of Time::Moment");
+    Zero(h, 1, moment_holiday_t);
+    h->computus = DT_WESTERN;
+    h->from = 1;
+    h->to = 9999;
+
+    hv = (HV *)SvRV(sv);
+    hv_iterinit(hv);
+    while ((he = hv_iternext(hv))) {
+        SV * const key = hv_iterkeysv(he);
+        SV * const val = HeVAL(he);
+
+        switch (THX_sv_moment_param(aTHX_ key)) {
+            case MOMENT_PARAM_MONTH:       h->month = (int)SvIV(val);                        break;
+            case MOMENT_PARAM_DAY:         h->day = (int)SvIV(val);                          break;
+            case MOMENT_PARAM_DAY_OF_WEEK: h->day_of_week = (int)SvIV(val);                  break;
+            case MOMENT_PARAM_ORDINAL:     h->ordinal = (int)SvIV(val);                      break;
+            case MOMENT_PARAM_EASTER:      h->easter = (int)SvIV(val);                       break;
+            case MOMENT_PARAM_COMPUTUS:    h->computus = THX_sv_moment_computus(aTHX_ val);  break;
+            case MOMENT_PARAM_OBSERVED:    h->observed = THX_sv_moment_observed(aTHX_ val);  break;
+            case MOMENT_PARAM_FROM:        h->from = (int)SvIV(val);                         break;
+            case MOMENT_PARAM_TO:          h->to = (int)SvIV(val);                           break;
+            default:
+                croak("Unrecognised parameter: '%"SVf"'", key);
+        }
+    }
+}
+
+/* Returns a buffer SV with room for n intervals */
+static SV *
+THX_newSVinterval_buffer(pTHX_ size_t n) {
+    SV *pv = newSV(n * sizeof(moment_interval_t) + 1);
+    SvPOK_only(pv);
+    return pv;
+}
+
+/* Blesses a buffer SV holding n intervals in canonical form */
+static SV *
+THX_newSVinterval_set(pTHX_ SV *pv, size_t n, HV *stash) {
+    SV *sv;
+
+    SvCUR_set(pv, n * sizeof(moment_interval_t));
+    sv = newRV_noinc(pv);
+    sv_bless(sv, stash);
+    return sv;
+}
+
+static SV *
+THX_api_newSVmoment(pTHX_ const moment_t *mt) {
+    dMY_CXT;
+    return THX_newSVmoment(aTHX_ mt, MY_CXT.stash);
+}
+
+static const moment_t *
+THX_api_sv_2moment_ptr(pTHX_ SV *sv, const char *name) {
+    return THX_sv_2moment_ptr(aTHX_ sv, name);
+}
+
+static const moment_api_t moment_api = {
+    MOMENT_API_VERSION,
+    sizeof(moment_api_t),
+    THX_moment_from_epoch,
+    THX_api_newSVmoment,
+    THX_sv_isa_moment,
+    THX_api_sv_2moment_ptr,
+    moment_to_string_buffer,
+    moment_compare_instant,
+};
+
 #define dSTASH_CONSTRUCTOR(sv, name, dstash) \
     HV * const stash = THX_stash_constructor(aTHX_ sv, STR_WITH_LEN(name), dstash)
 
@@ -271,6 +897,42 @@ THX_sv_2moment_coerce_sv(pTHX_ SV *sv, HV *stash) {
     dMY_CXT; \
     dSTASH_CONSTRUCTOR(sv, "Time::Moment", MY_CXT.stash)
 
+#define dSTASH_CONSTRUCTOR_DURATION(sv) \
+    dMY_CXT; \
+    dSTASH_CONSTRUCTOR(sv, "Time::Moment::Duration", MY_CXT.duration_stash)
+
+#define dSTASH_DURATION \
+    dMY_CXT; \
+    HV * const stash = MY_CXT.duration_stash
+
+#define dSTASH_RANGE \
+    dMY_CXT; \
+    HV * const stash = MY_CXT.range_stash
+
+#define dSTASH_CONSTRUCTOR_BUILDER(sv) \
+    dMY_CXT; \
+    dSTASH_CONSTRUCTOR(sv, "Time::Moment::Builder", MY_CXT.builder_stash)
+
+#define dSTASH_CONSTRUCTOR_RRULE(sv) \
+    dMY_CXT; \
+    dSTASH_CONSTRUCTOR(sv, "Time::Moment::Recurrence", MY_CXT.rrule_stash)
+
+#define dSTASH_CONSTRUCTOR_CRON(sv) \
+    dMY_CXT; \
+    dSTASH_CONSTRUCTOR(sv, "Time::Moment::Cron", MY_CXT.cron_stash)
+
+#define dSTASH_CONSTRUCTOR_BUSINESS(sv) \
+    dMY_CXT; \
+    dSTASH_CONSTRUCTOR(sv, "Time::Moment::BusinessCalendar", MY_CXT.business_stash)
+
+#define dSTASH_CONSTRUCTOR_INTERVAL(sv) \
+    dMY_CXT; \
+    dSTASH_CONSTRUCTOR(sv, "Time::Moment::Interval", MY_CXT.interval_stash)
+
+#define dSTASH_CONSTRUCTOR_INTERVAL_SET(sv) \
+    dMY_CXT; \
+    dSTASH_CONSTRUCTOR(sv, "Time::Moment::IntervalSet", MY_CXT.interval_set_stash)
+
 #define newSVmoment(m, stash) \
     THX_newSVmoment(aTHX_ m, stash)
 
@@ -289,27 +951,120 @@ THX_sv_2moment_coerce_sv(pTHX_ SV *sv, HV *stash) {
 #define sv_isa_moment(sv) \
     THX_sv_isa_moment(aTHX_ sv)
 
-#define croak_cmp(sv1, sv2, swap, name) \
-    THX_croak_cmp(aTHX_ sv1, sv2, swap, name)
+#define newSVduration(d, stash) \
+    THX_newSVduration(aTHX_ d, stash)
 
-#define sv_moment_param(sv) \
-    THX_sv_moment_param(aTHX_ sv)
+#define sv_set_duration(sv, d) \
+    THX_sv_set_duration(aTHX_ sv, d);
 
-#define sv_reusable(sv) \
-    (SvTEMP(sv) && SvREFCNT(sv) == 1 && SvROK(sv) && SvREFCNT(SvRV(sv)) == 1)
+#define sv_2duration_ptr(sv, name) \
+    THX_sv_2duration_ptr(aTHX_ sv, name)
 
-XS(XS_Time_Moment_nil) {
-    dVAR; dXSARGS;
-    PERL_UNUSED_VAR(items);
-    XSRETURN_EMPTY;
-}
+#define sv_isa_duration(sv) \
+    THX_sv_isa_duration(aTHX_ sv)
 
-XS(XS_Time_Moment_stringify) {
-    dVAR; dXSARGS;
-    if (items < 1)
-        croak("Wrong number of arguments to Time::Moment::(\"\"");
-    ST(0) = moment_to_string(sv_2moment_ptr(ST(0), "self"), FALSE);
-    XSRETURN(1);
+#define newSVinterval(iv, stash) \
+    THX_newSVinterval(aTHX_ iv, stash)
+
+#define sv_2interval_ptr(sv, name) \
+    THX_sv_2interval_ptr(aTHX_ sv, name)
+
+#define sv_isa_interval(sv) \
+    THX_sv_isa_interval(aTHX_ sv)
+
+#define sv_2interval_set_ptr(sv, name, np) \
+    THX_sv_2interval_set_ptr(aTHX_ sv, name, np)
+
+#define sv_2interval_set(sv, name, np) \
+    THX_sv_2interval_set(aTHX_ sv, name, np)
+
+#define newSVinterval_buffer(n) \
+    THX_newSVinterval_buffer(aTHX_ n)
+
+#define newSVinterval_set(pv, n, stash) \
+    THX_newSVinterval_set(aTHX_ pv, n, stash)
+
+#define newSVrange(r, stash) \
+    THX_newSVrange(aTHX_ r, stash)
+
+#define sv_2range_ptr(sv, name) \
+    THX_sv_2range_ptr(aTHX_ sv, name)
+
+#define sv_2builder_ptr(sv, name) \
+    THX_sv_2builder_ptr(aTHX_ sv, name)
+
+#define sv_set_target_moment(sv, m) \
+    THX_sv_set_target_moment(aTHX_ sv, m)
+
+#define sv_cat_moment(sv, m) \
+    THX_sv_cat_moment(aTHX_ sv, m)
+
+#define sv_2rrule_ptr(sv, name) \
+    THX_sv_2rrule_ptr(aTHX_ sv, name)
+
+#define sv_moment_field(sv) \
+    THX_sv_moment_field(aTHX_ sv)
+
+#define sv_2packed_mutable(sv, f, name, np) \
+    THX_sv_2packed_mutable(aTHX_ sv, f, name, np)
+
+#define newSVpacked(len) \
+    THX_newSVpacked(aTHX_ len)
+
+#define packed_transform(buffer, op, u, v, failed) \
+    THX_packed_transform(aTHX_ buffer, op, u, v, failed)
+
+#define sv_2field_set(name, sv, c, fs) \
+    THX_sv_2field_set(aTHX_ name, sv, c, fs)
+
+#define sv_packed_format(sv) \
+    THX_sv_packed_format(aTHX_ sv)
+
+#define sv_2packed(sv, f, name, np) \
+    THX_sv_2packed(aTHX_ sv, f, name, np)
+
+#define interval_anchor(interval, reference) \
+    THX_interval_anchor(aTHX_ interval, reference)
+
+#define sv_2zonemap(sv) \
+    THX_sv_2zonemap(aTHX_ sv)
+
+#define newSVcron(cron, stash) \
+    THX_newSVcron(aTHX_ cron, stash)
+
+#define sv_2cron_ptr(sv, name) \
+    THX_sv_2cron_ptr(aTHX_ sv, name)
+
+#define sv_2business_ptr(sv, name) \
+    THX_sv_2business_ptr(aTHX_ sv, name)
+
+#define sv_2holiday(sv, h) \
+    THX_sv_2holiday(aTHX_ sv, h)
+
+#define sv_moment_unit(sv) \
+    THX_sv_moment_unit(aTHX_ sv)
+
+#define croak_cmp(sv1, sv2, swap, name) \
+    THX_croak_cmp(aTHX_ sv1, sv2, swap, name)
+
+#define sv_moment_param(sv) \
+    THX_sv_moment_param(aTHX_ sv)
+
+#define sv_reusable(sv) \
+    (SvTEMP(sv) && SvREFCNT(sv) == 1 && SvROK(sv) && SvREFCNT(SvRV(sv)) == 1)
+
+XS(XS_Time_Moment_nil) {
+    dVAR; dXSARGS;
+    PERL_UNUSED_VAR(items);
+    XSRETURN_EMPTY;
+}
+
+XS(XS_Time_Moment_stringify) {
+    dVAR; dXSARGS;
+    if (items < 1)
+        croak("Wrong number of arguments to Time::Moment::(\"\"");
+    ST(0) = moment_to_string(sv_2moment_ptr(ST(0), "self"), FALSE);
+    XSRETURN(1);
 }
 
 XS(XS_Time_Moment_ncmp) {
@@ -337,6 +1092,50 @@ XS(XS_Time_Moment_ncmp) {
     XSRETURN_IV(moment_compare_instant(m1, m2));
 }
 
+XS(XS_Time_Moment_Duration_stringify) {
+    dVAR; dXSARGS;
+    if (items < 1)
+        croak("Wrong number of arguments to Time::Moment::Duration::(\"\"");
+    ST(0) = moment_duration_to_string(sv_2duration_ptr(ST(0), "self"));
+    XSRETURN(1);
+}
+
+XS(XS_Time_Moment_Duration_ncmp) {
+    dVAR; dXSARGS;
+    const moment_duration_t *d1, *d2;
+    bool swap;
+    SV *svd1, *svd2;
+
+    if (items < 3)
+        croak("Wrong number of arguments to Time::Moment::Duration::(<=>");
+
+    svd1 = ST(0);
+    svd2 = ST(1);
+    swap = cBOOL(SvTRUE(ST(2)));
+
+    if (!sv_isa_duration(svd2))
+        croak_cmp(svd1, svd2, swap, "Time::Moment::Duration");
+    d1 = sv_2duration_ptr(svd1, "self");
+    d2 = sv_2duration_ptr(svd2, "other");
+    if (swap) {
+        const moment_duration_t *tmp = d1;
+        d1 = d2;
+        d2 = tmp;
+    }
+    XSRETURN_IV(moment_duration_compare(d1, d2));
+}
+
+XS(XS_Time_Moment_Interval_stringify) {
+    dVAR; dXSARGS;
+    const moment_interval_t *iv;
+
+    if (items < 1)
+        croak("Wrong number of arguments to Time::Moment::Interval::(\"\"");
+    iv = sv_2interval_ptr(ST(0), "self");
+    ST(0) = moment_interval_to_string(&iv->start, &iv->end);
+    XSRETURN(1);
+}
+
 #ifdef HAS_GETTIMEOFDAY
 static moment_t
 THX_moment_now(pTHX_ bool utc) {
@@ -384,6 +1183,14 @@ BOOT:
     newXS("Time::Moment::()", XS_Time_Moment_nil, file);
     newXS("Time::Moment::(\"\"", XS_Time_Moment_stringify, file);
     newXS("Time::Moment::(<=>", XS_Time_Moment_ncmp, file);
+    sv_setsv(get_sv("Time::Moment::Duration::()", GV_ADD), &PL_sv_yes);
+    newXS("Time::Moment::Duration::()", XS_Time_Moment_nil, file);
+    newXS("Time::Moment::Duration::(\"\"", XS_Time_Moment_Duration_stringify, file);
+    newXS("Time::Moment::Duration::(<=>", XS_Time_Moment_Duration_ncmp, file);
+    sv_setsv(get_sv("Time::Moment::Interval::()", GV_ADD), &PL_sv_yes);
+    newXS("Time::Moment::Interval::()", XS_Time_Moment_nil, file);
+    newXS("Time::Moment::Interval::(\"\"", XS_Time_Moment_Interval_stringify, file);
+    (void)hv_stores(PL_modglobal, MOMENT_API_KEY, newSViv(PTR2IV(&moment_api)));
 }
 
 #ifdef USE_ITHREADS
@@ -523,6 +1330,26 @@ from_string(klass, string, ...)
   OUTPUT:
     RETVAL
 
+void
+from_interval_string(klass, string, reference=NULL)
+    SV *klass
+    SV *string
+    SV *reference
+  PREINIT:
+    dSTASH_CONSTRUCTOR_MOMENT(klass);
+    moment_iso_interval_t interval;
+    const char *str;
+    STRLEN len;
+  PPCODE:
+    str = SvPV_const(string, len);
+    interval = moment_interval_from_string(str, len);
+    if (interval.form == MOMENT_INTERVAL_DURATION)
+        interval_anchor(&interval, reference);
+    EXTEND(SP, 2);
+    mPUSHs(newSVmoment(&interval.start, stash));
+    mPUSHs(newSVmoment(&interval.end, stash));
+    XSRETURN(2);
+
 moment_t
 from_rd(klass, jd, ...)
     SV *klass
@@ -687,6 +1514,119 @@ delta_years(self, other)
     delta = moment_delta_unit(self, other, (moment_unit_t)ix);
     XSRETURN_I64V(delta);
 
+void
+delta_ymd(self, other)
+    const moment_t *self
+    const moment_t *other
+  ALIAS:
+    Time::Moment::delta_ymd = 0
+    Time::Moment::delta_yqd = 1
+  PREINIT:
+    int y, m, d;
+  PPCODE:
+    if (ix == 0)
+        moment_delta_ymd(self, other, &y, &m, &d);
+    else
+        moment_delta_yqd(self, other, &y, &m, &d);
+    EXTEND(SP, 3);
+    mPUSHi(y);
+    mPUSHi(m);
+    mPUSHi(d);
+    XSRETURN(3);
+
+void
+delta_ymdhms(self, other)
+    const moment_t *self
+    const moment_t *other
+  PREINIT:
+    int y, m, d, h, mi, s, ns;
+  PPCODE:
+    moment_delta_ymdhms(self, other, &y, &m, &d, &h, &mi, &s, &ns);
+    EXTEND(SP, 7);
+    mPUSHi(y);
+    mPUSHi(m);
+    mPUSHi(d);
+    mPUSHi(h);
+    mPUSHi(mi);
+    mPUSHi(s);
+    mPUSHi(ns);
+    XSRETURN(7);
+
+moment_t
+plus_duration(self, duration)
+    const moment_t *self
+    const moment_duration_t *duration
+  PREINIT:
+    dSTASH_INVOCANT;
+  ALIAS:
+    Time::Moment::plus_duration  = 0
+    Time::Moment::minus_duration = 1
+  CODE:
+    if (moment_duration_sign(duration) == 0)
+        XSRETURN(1);
+    if (ix == 0)
+        RETVAL = moment_plus_duration(self, duration);
+    else
+        RETVAL = moment_minus_duration(self, duration);
+    if (sv_reusable(ST(0))) {
+        sv_set_moment(ST(0), &RETVAL);
+        XSRETURN(1);
+    }
+  OUTPUT:
+    RETVAL
+
+moment_t
+plus_iso_duration(self, string)
+    const moment_t *self
+    SV *string
+  PREINIT:
+    dSTASH_INVOCANT;
+    moment_period_t period;
+    const char *str;
+    STRLEN len;
+  ALIAS:
+    Time::Moment::plus_iso_duration  = 0
+    Time::Moment::minus_iso_duration = 1
+  CODE:
+    str = SvPV_const(string, len);
+    period = moment_period_from_string(str, len);
+    if (ix == 0)
+        RETVAL = moment_plus_period(self, &period);
+    else
+        RETVAL = moment_minus_period(self, &period);
+    if (sv_reusable(ST(0))) {
+        sv_set_moment(ST(0), &RETVAL);
+        XSRETURN(1);
+    }
+  OUTPUT:
+    RETVAL
+
+moment_duration_t
+duration_until(self, other)
+    const moment_t *self
+    const moment_t *other
+  PREINIT:
+    dSTASH_DURATION;
+  CODE:
+    RETVAL = moment_subtract_moment(self, other);
+  OUTPUT:
+    RETVAL
+
+moment_range_t
+range(klass, start, end, unit, step=1)
+    SV *klass
+    const moment_t *start
+    const moment_t *end
+    SV *unit
+    I64V step
+  PREINIT:
+    dSTASH_RANGE;
+  CODE:
+    PERL_UNUSED_VAR(klass);
+    RETVAL = moment_range_new(start, end, sv_moment_unit(unit), step);
+  OUTPUT:
+    RETVAL
+
 void
 with(self, adjuster)
     const moment_t *self
@@ -917,6 +1857,42 @@ utc_rd_values(self)
     mPUSHi(nos);
     XSRETURN(3);
 
+void
+components(self)
+    const moment_t *self
+  ALIAS:
+    Time::Moment::components = 0
+    Time::Moment::to_hash    = 1
+  PREINIT:
+    int year, month, day, sod;
+  PPCODE:
+    dt_to_ymd(moment_local_dt(self), &year, &month, &day);
+    sod = moment_second_of_day(self);
+    if (ix == 0) {
+        EXTEND(SP, 8);
+        mPUSHi(year);
+        mPUSHi(month);
+        mPUSHi(day);
+        mPUSHi(sod / 3600);
+        mPUSHi(sod / 60 % 60);
+        mPUSHi(sod % 60);
+        mPUSHi(self->nsec);
+        mPUSHi(self->offset);
+        XSRETURN(8);
+    }
+    else {
+        HV *hv = newHV();
+        (void)hv_stores(hv, "year", newSViv(year));
+        (void)hv_stores(hv, "month", newSViv(month));
+        (void)hv_stores(hv, "day", newSViv(day));
+        (void)hv_stores(hv, "hour", newSViv(sod / 3600));
+        (void)hv_stores(hv, "minute", newSViv(sod / 60 % 60));
+        (void)hv_stores(hv, "second", newSViv(sod % 60));
+        (void)hv_stores(hv, "nanosecond", newSViv(self->nsec));
+        (void)hv_stores(hv, "offset", newSViv(self->offset));
+        XSRETURN_SV(sv_2mortal(newRV_noinc((SV *)hv)));
+    }
+
 void
 compare(self, other, ...)
     const moment_t *self
@@ -1005,6 +1981,1298 @@ to_string(self, ...)
     }
     XSRETURN_SV(moment_to_string(self, reduced));
 
+void
+to_interval_string(self, other)
+    const moment_t *self
+    SV *other
+  PREINIT:
+    SV *sv;
+  PPCODE:
+    if (sv_isa_duration(other)) {
+        sv = moment_to_string(self, FALSE);
+        sv_catpvs(sv, "/");
+        sv_catsv(sv, moment_duration_to_string(sv_2duration_ptr(other, "other")));
+    }
+    else
+        sv = moment_interval_to_string(self, sv_2moment_ptr(other, "other"));
+    XSRETURN_SV(sv);
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::Duration
+
+PROTOTYPES: DISABLE
+
+moment_duration_t
+from_seconds(klass, seconds, nanoseconds=0)
+    SV *klass
+    I64V seconds
+    I64V nanoseconds
+  PREINIT:
+    dSTASH_CONSTRUCTOR_DURATION(klass);
+  CODE:
+    RETVAL = moment_duration_new(seconds, nanoseconds);
+  OUTPUT:
+    RETVAL
+
+moment_duration_t
+from_string(klass, string)
+    SV *klass
+    SV *string
+  PREINIT:
+    dSTASH_CONSTRUCTOR_DURATION(klass);
+    const char *str;
+    STRLEN len;
+  CODE:
+    str = SvPV_const(string, len);
+    RETVAL = moment_duration_from_string(str, len);
+  OUTPUT:
+    RETVAL
+
+moment_duration_t
+from_weeks(klass, value)
+    SV *klass
+    I64V value
+  PREINIT:
+    dSTASH_CONSTRUCTOR_DURATION(klass);
+  ALIAS:
+    Time::Moment::Duration::from_weeks        = MOMENT_UNIT_WEEKS
+    Time::Moment::Duration::from_days         = MOMENT_UNIT_DAYS
+    Time::Moment::Duration::from_hours        = MOMENT_UNIT_HOURS
+    Time::Moment::Duration::from_minutes      = MOMENT_UNIT_MINUTES
+    Time::Moment::Duration::from_milliseconds = MOMENT_UNIT_MILLIS
+    Time::Moment::Duration::from_microseconds = MOMENT_UNIT_MICROS
+    Time::Moment::Duration::from_nanoseconds  = MOMENT_UNIT_NANOS
+  CODE:
+    RETVAL = moment_duration_from_unit((moment_unit_t)ix, value);
+  OUTPUT:
+    RETVAL
+
+void
+to_weeks(self)
+    const moment_duration_t *self
+  ALIAS:
+    Time::Moment::Duration::to_weeks        = MOMENT_UNIT_WEEKS
+    Time::Moment::Duration::to_days         = MOMENT_UNIT_DAYS
+    Time::Moment::Duration::to_hours        = MOMENT_UNIT_HOURS
+    Time::Moment::Duration::to_minutes      = MOMENT_UNIT_MINUTES
+    Time::Moment::Duration::to_seconds      = MOMENT_UNIT_SECONDS
+    Time::Moment::Duration::to_milliseconds = MOMENT_UNIT_MILLIS
+    Time::Moment::Duration::to_microseconds = MOMENT_UNIT_MICROS
+    Time::Moment::Duration::to_nanoseconds  = MOMENT_UNIT_NANOS
+  PREINIT:
+    int64_t v;
+  PPCODE:
+    v = moment_duration_to_unit(self, (moment_unit_t)ix);
+    XSRETURN_I64V(v);
+
+void
+nanosecond(self)
+    const moment_duration_t *self
+  PPCODE:
+    XSRETURN_IV(self->nsec);
+
+void
+to_string(self)
+    const moment_duration_t *self
+  PPCODE:
+    XSRETURN_SV(moment_duration_to_string(self));
+
+moment_duration_t
+plus(self, other)
+    const moment_duration_t *self
+    const moment_duration_t *other
+  PREINIT:
+    dSTASH_INVOCANT;
+  ALIAS:
+    Time::Moment::Duration::plus  = 0
+    Time::Moment::Duration::minus = 1
+  CODE:
+    if (ix == 0)
+        RETVAL = moment_duration_add(self, other);
+    else
+        RETVAL = moment_duration_subtract(self, other);
+    if (sv_reusable(ST(0))) {
+        sv_set_duration(ST(0), &RETVAL);
+        XSRETURN(1);
+    }
+  OUTPUT:
+    RETVAL
+
+moment_duration_t
+multiplied_by(self, factor)
+    const moment_duration_t *self
+    I64V factor
+  PREINIT:
+    dSTASH_INVOCANT;
+  CODE:
+    if (factor == 1)
+        XSRETURN(1);
+    RETVAL = moment_duration_multiply(self, factor);
+    if (sv_reusable(ST(0))) {
+        sv_set_duration(ST(0), &RETVAL);
+        XSRETURN(1);
+    }
+  OUTPUT:
+    RETVAL
+
+moment_duration_t
+negated(self)
+    const moment_duration_t *self
+  PREINIT:
+    dSTASH_INVOCANT;
+  ALIAS:
+    Time::Moment::Duration::negated = 0
+    Time::Moment::Duration::abs     = 1
+  CODE:
+    if (ix == 1 && self->sec >= 0)
+        XSRETURN(1);
+    RETVAL = moment_duration_negate(self);
+  OUTPUT:
+    RETVAL
+
+void
+compare(self, other)
+    const moment_duration_t *self
+    const moment_duration_t *other
+  PPCODE:
+    XSRETURN_IV(moment_duration_compare(self, other));
+
+void
+is_equal(self, other)
+    const moment_duration_t *self
+    const moment_duration_t *other
+  PPCODE:
+    XSRETURN_BOOL(moment_duration_compare(self, other) == 0);
+
+void
+is_zero(self)
+    const moment_duration_t *self
+  ALIAS:
+    Time::Moment::Duration::is_zero     = 0
+    Time::Moment::Duration::is_negative = 1
+    Time::Moment::Duration::is_positive = 2
+  PREINIT:
+    bool v = FALSE;
+  PPCODE:
+    switch (ix) {
+        case 0: v = moment_duration_sign(self) == 0; break;
+        case 1: v = moment_duration_sign(self) < 0;  break;
+        case 2: v = moment_duration_sign(self) > 0;  break;
+    }
+    XSRETURN_BOOL(v);
+
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::Interval
+
+PROTOTYPES: DISABLE
+
+moment_interval_t
+new(klass, start, end)
+    SV *klass
+    const moment_t *start
+    const moment_t *end
+  PREINIT:
+    dSTASH_CONSTRUCTOR_INTERVAL(klass);
+  CODE:
+    RETVAL = moment_interval_new(start, end);
+  OUTPUT:
+    RETVAL
+
+moment_interval_t
+from_string(klass, string, reference=NULL)
+    SV *klass
+    SV *string
+    SV *reference
+  PREINIT:
+    dSTASH_CONSTRUCTOR_INTERVAL(klass);
+    moment_iso_interval_t interval;
+    const char *str;
+    STRLEN len;
+  CODE:
+    str = SvPV_const(string, len);
+    interval = moment_interval_from_string(str, len);
+    if (interval.form == MOMENT_INTERVAL_DURATION)
+        interval_anchor(&interval, reference);
+    RETVAL = moment_interval_new(&interval.start, &interval.end);
+  OUTPUT:
+    RETVAL
+
+void
+start(self)
+    const moment_interval_t *self
+  ALIAS:
+    Time::Moment::Interval::start = 0
+    Time::Moment::Interval::end   = 1
+  PREINIT:
+    dMY_CXT;
+  PPCODE:
+    XSRETURN_SV(sv_2mortal(newSVmoment(ix == 0 ? &self->start : &self->end, MY_CXT.stash)));
+
+moment_duration_t
+duration(self)
+    const moment_interval_t *self
+  PREINIT:
+    dSTASH_DURATION;
+  CODE:
+    RETVAL = moment_subtract_moment(&self->start, &self->end);
+  OUTPUT:
+    RETVAL
+
+void
+is_empty(self)
+    const moment_interval_t *self
+  PPCODE:
+    XSRETURN_BOOL(moment_interval_is_empty(self));
+
+void
+contains(self, moment)
+    const moment_interval_t *self
+    const moment_t *moment
+  PPCODE:
+    XSRETURN_BOOL(moment_interval_contains(self, moment));
+
+void
+overlaps(self, other)
+    const moment_interval_t *self
+    const moment_interval_t *other
+  ALIAS:
+    Time::Moment::Interval::overlaps = 0
+    Time::Moment::Interval::is_equal = 1
+  PREINIT:
+    bool v = FALSE;
+  PPCODE:
+    switch (ix) {
+        case 0: v = moment_interval_overlaps(self, other); break;
+        case 1: v = moment_interval_equals(self, other);   break;
+    }
+    XSRETURN_BOOL(v);
+
+void
+intersection(self, other)
+    const moment_interval_t *self
+    const moment_interval_t *other
+  PREINIT:
+    dSTASH_INVOCANT;
+    moment_interval_t r;
+  PPCODE:
+    if (!moment_interval_intersection(self, other, &r))
+        XSRETURN_UNDEF;
+    XSRETURN_SV(sv_2mortal(newSVinterval(&r, stash)));
+
+void
+to_string(self)
+    const moment_interval_t *self
+  PPCODE:
+    XSRETURN_SV(moment_interval_to_string(&self->start, &self->end));
+
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::IntervalSet
+
+PROTOTYPES: DISABLE
+
+void
+new(klass, ...)
+    SV *klass
+  PREINIT:
+    dSTASH_CONSTRUCTOR_INTERVAL_SET(klass);
+    moment_interval_t *iv;
+    size_t n;
+    I32 i;
+    SV *pv;
+  PPCODE:
+    pv = sv_2mortal(newSVinterval_buffer(items - 1));
+    iv = (moment_interval_t *)SvPVX(pv);
+    for (i = 1; i < items; i++)
+        iv[i - 1] = *sv_2interval_ptr(ST(i), "interval");
+    n = moment_interval_set_normalize(iv, items - 1);
+    XSRETURN_SV(sv_2mortal(newSVinterval_set(SvREFCNT_inc_simple_NN(pv), n, stash)));
+
+void
+intervals(self)
+    SV *self
+  PREINIT:
+    dMY_CXT;
+    const moment_interval_t *iv;
+    size_t i, n;
+  PPCODE:
+    iv = sv_2interval_set_ptr(self, "self", &n);
+    if (GIMME_V != G_ARRAY)
+        XSRETURN_IV((IV)n);
+    EXTEND(SP, n);
+    for (i = 0; i < n; i++)
+        mPUSHs(newSVinterval(&iv[i], MY_CXT.interval_stash));
+    XSRETURN(n);
+
+void
+count(self)
+    SV *self
+  ALIAS:
+    Time::Moment::IntervalSet::count    = 0
+    Time::Moment::IntervalSet::is_empty = 1
+  PREINIT:
+    size_t n;
+  PPCODE:
+    (void)sv_2interval_set_ptr(self, "self", &n);
+    if (ix == 0)
+        XSRETURN_IV((IV)n);
+    XSRETURN_BOOL(n == 0);
+
+void
+contains(self, moment)
+    SV *self
+    const moment_t *moment
+  PREINIT:
+    const moment_interval_t *iv;
+    size_t n;
+  PPCODE:
+    iv = sv_2interval_set_ptr(self, "self", &n);
+    XSRETURN_BOOL(moment_interval_set_contains(iv, n, moment));
+
+void
+find(self, moment)
+    SV *self
+    const moment_t *moment
+  PREINIT:
+    dMY_CXT;
+    const moment_interval_t *iv;
+    size_t i, n;
+  PPCODE:
+    iv = sv_2interval_set_ptr(self, "self", &n);
+    i = moment_interval_set_search(iv, n, moment);
+    if (i == n || !moment_interval_contains(&iv[i], moment))
+        XSRETURN_UNDEF;
+    XSRETURN_SV(sv_2mortal(newSVinterval(&iv[i], MY_CXT.interval_stash)));
+
+void
+overlaps(self, interval)
+    SV *self
+    const moment_interval_t *interval
+  PREINIT:
+    const moment_interval_t *iv;
+    size_t n;
+  PPCODE:
+    iv = sv_2interval_set_ptr(self, "self", &n);
+    XSRETURN_BOOL(moment_interval_set_overlaps(iv, n, interval));
+
+void
+union(self, other)
+    SV *self
+    SV *other
+  ALIAS:
+    Time::Moment::IntervalSet::union        = 0
+    Time::Moment::IntervalSet::intersection = 1
+    Time::Moment::IntervalSet::difference   = 2
+  PREINIT:
+    const moment_interval_t *a, *b;
+    moment_interval_t *r;
+    size_t na, nb, n = 0;
+    HV *stash;
+    SV *pv;
+  PPCODE:
+    a = sv_2interval_set_ptr(self, "self", &na);
+    b = sv_2interval_set(other, "other", &nb);
+    stash = SvSTASH(SvRV(self));
+    pv = sv_2mortal(newSVinterval_buffer(na + nb));
+    r = (moment_interval_t *)SvPVX(pv);
+    switch (ix) {
+        case 0: n = moment_interval_set_union(a, na, b, nb, r);        break;
+        case 1: n = moment_interval_set_intersection(a, na, b, nb, r); break;
+        case 2: n = moment_interval_set_difference(a, na, b, nb, r);   break;
+    }
+    XSRETURN_SV(sv_2mortal(newSVinterval_set(SvREFCNT_inc_simple_NN(pv), n, stash)));
+
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::Range
+
+PROTOTYPES: DISABLE
+
+void
+next(self, target=NULL)
+    moment_range_t *self
+    SV *target
+  PREINIT:
+    dMY_CXT;
+    moment_t mt;
+  PPCODE:
+    if (!moment_range_next(self, &mt)) {
+        if (target)
+            XSRETURN_NO;
+        XSRETURN_EMPTY;
+    }
+    if (!target)
+        XSRETURN_SV(sv_2mortal(newSVmoment(&mt, MY_CXT.stash)));
+    sv_set_target_moment(target, &mt);
+    XSRETURN_YES;
+
+void
+reset(self)
+    moment_range_t *self
+  PPCODE:
+    moment_range_reset(self);
+    XSRETURN(1);
+
+void
+to_packed(self)
+    const moment_range_t *self
+  PREINIT:
+    moment_range_t range;
+    moment_t mt;
+    SV *sv;
+  PPCODE:
+    range = *self;
+    moment_range_reset(&range);
+    sv = sv_2mortal(newSV(64 * sizeof(moment_t)));
+    SvPOK_only(sv);
+    SvCUR_set(sv, 0);
+    while (moment_range_next(&range, &mt))
+        sv_cat_moment(sv, &mt);
+    *SvEND(sv) = '\0';
+    XSRETURN_SV(sv);
+
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::Builder
+
+PROTOTYPES: DISABLE
+
+moment_builder_t
+new(klass, moment)
+    SV *klass
+    const moment_t *moment
+  PREINIT:
+    dSTASH_CONSTRUCTOR_BUILDER(klass);
+  CODE:
+    RETVAL = *moment;
+  OUTPUT:
+    RETVAL
+
+void
+freeze(self)
+    const moment_builder_t *self
+  PREINIT:
+    dMY_CXT;
+  PPCODE:
+    XSRETURN_SV(sv_2mortal(newSVmoment(self, MY_CXT.stash)));
+
+void
+add_years(self, value)
+    const moment_builder_t *self
+    I64V value
+  PREINIT:
+    moment_t r;
+  ALIAS:
+    Time::Moment::Builder::add_years        = MOMENT_UNIT_YEARS
+    Time::Moment::Builder::add_months       = MOMENT_UNIT_MONTHS
+    Time::Moment::Builder::add_weeks        = MOMENT_UNIT_WEEKS
+    Time::Moment::Builder::add_days         = MOMENT_UNIT_DAYS
+    Time::Moment::Builder::add_hours        = MOMENT_UNIT_HOURS
+    Time::Moment::Builder::add_minutes      = MOMENT_UNIT_MINUTES
+    Time::Moment::Builder::add_seconds      = MOMENT_UNIT_SECONDS
+    Time::Moment::Builder::add_milliseconds = MOMENT_UNIT_MILLIS
+    Time::Moment::Builder::add_microseconds = MOMENT_UNIT_MICROS
+    Time::Moment::Builder::add_nanoseconds  = MOMENT_UNIT_NANOS
+  PPCODE:
+    if (value != 0) {
+        r = moment_plus_unit(self, (moment_unit_t)ix, value);
+        sv_set_moment(ST(0), &r);
+    }
+    XSRETURN(1);
+
+void
+set_year(self, value)
+    const moment_builder_t *self
+    I64V value
+  PREINIT:
+    moment_t r;
+  ALIAS:
+    Time::Moment::Builder::set_year               = MOMENT_FIELD_YEAR
+    Time::Moment::Builder::set_quarter            = MOMENT_FIELD_QUARTER_OF_YEAR
+    Time::Moment::Builder::set_month              = MOMENT_FIELD_MONTH_OF_YEAR
+    Time::Moment::Builder::set_week               = MOMENT_FIELD_WEEK_OF_YEAR
+    Time::Moment::Builder::set_day_of_year        = MOMENT_FIELD_DAY_OF_YEAR
+    Time::Moment::Builder::set_day_of_quarter     = MOMENT_FIELD_DAY_OF_QUARTER
+    Time::Moment::Builder::set_day_of_month       = MOMENT_FIELD_DAY_OF_MONTH
+    Time::Moment::Builder::set_day_of_week        = MOMENT_FIELD_DAY_OF_WEEK
+    Time::Moment::Builder::set_hour               = MOMENT_FIELD_HOUR_OF_DAY
+    Time::Moment::Builder::set_minute             = MOMENT_FIELD_MINUTE_OF_HOUR
+    Time::Moment::Builder::set_minute_of_day      = MOMENT_FIELD_MINUTE_OF_DAY
+    Time::Moment::Builder::set_second             = MOMENT_FIELD_SECOND_OF_MINUTE
+    Time::Moment::Builder::set_second_of_day      = MOMENT_FIELD_SECOND_OF_DAY
+    Time::Moment::Builder::set_millisecond        = MOMENT_FIELD_MILLI_OF_SECOND
+    Time::Moment::Builder::set_millisecond_of_day = MOMENT_FIELD_MILLI_OF_DAY
+    Time::Moment::Builder::set_microsecond        = MOMENT_FIELD_MICRO_OF_SECOND
+    Time::Moment::Builder::set_microsecond_of_day = MOMENT_FIELD_MICRO_OF_DAY
+    Time::Moment::Builder::set_nanosecond         = MOMENT_FIELD_NANO_OF_SECOND
+    Time::Moment::Builder::set_nanosecond_of_day  = MOMENT_FIELD_NANO_OF_DAY
+    Time::Moment::Builder::set_precision          = MOMENT_FIELD_PRECISION
+    Time::Moment::Builder::set_rdn                = MOMENT_FIELD_RATA_DIE_DAY
+  PPCODE:
+    r = moment_with_field(self, (moment_component_t)ix, value);
+    sv_set_moment(ST(0), &r);
+    XSRETURN(1);
+
+void
+set_offset_same_instant(self, offset)
+    const moment_builder_t *self
+    IV offset
+  PREINIT:
+    moment_t r;
+  ALIAS:
+    Time::Moment::Builder::set_offset_same_instant = 0
+    Time::Moment::Builder::set_offset_same_local   = 1
+  PPCODE:
+    if (ix == 0)
+        r = moment_with_offset_same_instant(self, offset);
+    else
+        r = moment_with_offset_same_local(self, offset);
+    sv_set_moment(ST(0), &r);
+    XSRETURN(1);
+
+void
+at_utc(self)
+    const moment_builder_t *self
+  PREINIT:
+    moment_t r;
+  ALIAS:
+    Time::Moment::Builder::at_utc                 = 0
+    Time::Moment::Builder::at_midnight            = 1
+    Time::Moment::Builder::at_noon                = 2
+    Time::Moment::Builder::at_last_day_of_year    = 3
+    Time::Moment::Builder::at_last_day_of_quarter = 4
+    Time::Moment::Builder::at_last_day_of_month   = 5
+  PPCODE:
+    switch (ix) {
+        case 0: r = moment_at_utc(self);                   break;
+        case 1: r = moment_at_midnight(self);              break;
+        case 2: r = moment_at_noon(self);                  break;
+        case 3: r = moment_at_last_day_of_year(self);      break;
+        case 4: r = moment_at_last_day_of_quarter(self);   break;
+        default:
+        case 5: r = moment_at_last_day_of_month(self);     break;
+    }
+    sv_set_moment(ST(0), &r);
+    XSRETURN(1);
+
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::BusinessCalendar
+
+PROTOTYPES: DISABLE
+
+void
+new(klass, ...)
+    SV *klass
+  PREINIT:
+    dSTASH_CONSTRUCTOR_BUSINESS(klass);
+    IV from = 1, to = 9999;
+    int weekend = (1 << DT_SATURDAY) | (1 << DT_SUNDAY);
+    moment_holiday_t *holidays;
+    int *dates;
+    size_t nholidays = 0, ndates = 0;
+    AV *av = NULL;
+    size_t size;
+    SV *pv;
+    I32 i;
+  PPCODE:
+    if (((items - 1) % 2) != 0)
+        croak("Odd number of elements in named parameters");
+
+    for (i = 1; i < items; i += 2) {
+        switch (sv_moment_param(ST(i))) {
+            case MOMENT_PARAM_FROM:
+                from = SvIV(ST(i+1));
+                break;
+            case MOMENT_PARAM_TO:
+                to = SvIV(ST(i+1));
+                break;
+            case MOMENT_PARAM_WEEKEND:
+            {
+                SV * const sv = ST(i+1);
+                AV *days;
+                I32 j;
+
+                SvGETMAGIC(sv);
+                if (!SvROK(sv) || SvTYPE(SvRV(sv)) != SVt_PVAV)
+                    croak("Parameter 'weekend' is not an ARRAY reference");
+                days = (AV *)SvRV(sv);
+                weekend = 0;
+                for (j = 0; j <= av_len(days); j++) {
+                    SV ** const svp = av_fetch(days, j, 0);
+                    const IV dow = svp ? SvIV(*svp) : 0;
+                    if (dow < 1 || dow > 7)
+                        croak("Parameter 'day_of_week' is out of the range [1, 7]");
+                    weekend |= 1 << dow;
+                }
+                break;
+            }
+            case MOMENT_PARAM_HOLIDAYS:
+            {
+                SV * const sv = ST(i+1);
+
+                SvGETMAGIC(sv);
+                if (!SvROK(sv) || SvTYPE(SvRV(sv)) != SVt_PVAV)
+                    croak("Parameter 'holidays' is not an ARRAY reference");
+                av = (AV *)SvRV(sv);
+                break;
+            }
+            default:
+                croak("Unrecognised parameter: '%"SVf"'", ST(i));
+        }
+    }
+    if (from < 1 || from > 9999 || to < 1 || to > 9999)
+        croak("Parameter 'year' is out of the range [1, 9999]");
+
+    size = moment_business_size((int)from, (int)to);
+    pv = sv_2mortal(newSV(size + 1));
+    SvPOK_only(pv);
+    SvCUR_set(pv, size);
+
+    if (av) {
+        const size_t n = av_len(av) + 1;
+        size_t j;
+
+        Newx(holidays, n, moment_holiday_t);
+        SAVEFREEPV(holidays);
+        Newx(dates, n, int);
+        SAVEFREEPV(dates);
+        for (j = 0; j < n; j++) {
+            SV ** const svp = av_fetch(av, j, 0);
+            SV * const sv = svp ? *svp : &PL_sv_undef;
+
+            if (sv_isa_moment(sv))
+                dates[ndates++] = (int)moment_rata_die_day(sv_2moment_ptr(sv, "holiday"));
+            else
+                sv_2holiday(sv, &holidays[nholidays++]);
+        }
+    }
+    else {
+        holidays = NULL;
+        dates = NULL;
+    }
+    moment_business_init((moment_business_t *)SvPVX(pv), (int)from, (int)to,
+      weekend, holidays, nholidays, dates, ndates);
+    XSRETURN_SV(sv_2mortal(sv_bless(newRV_inc(pv), stash)));
+
+void
+is_business_day(self, moment)
+    SV *self
+    const moment_t *moment
+  PREINIT:
+    const moment_business_t *bc;
+  PPCODE:
+    bc = sv_2business_ptr(self, "self");
+    XSRETURN_BOOL(moment_business_is_business_day(bc, (int)moment_rata_die_day(moment)));
+
+void
+plus_business_days(self, moment, n)
+    SV *self
+    const moment_t *moment
+    I64V n
+  ALIAS:
+    Time::Moment::BusinessCalendar::plus_business_days  = 0
+    Time::Moment::BusinessCalendar::minus_business_days = 1
+  PREINIT:
+    dMY_CXT;
+    const moment_business_t *bc;
+    moment_t r;
+    int rdn;
+  PPCODE:
+    bc = sv_2business_ptr(self, "self");
+    if (ix == 0)
+        rdn = moment_business_plus_days(bc, (int)moment_rata_die_day(moment), n);
+    else
+        rdn = moment_business_minus_days(bc, (int)moment_rata_die_day(moment), n);
+    r = moment_with_field(moment, MOMENT_FIELD_RATA_DIE_DAY, rdn);
+    XSRETURN_SV(sv_2mortal(newSVmoment(&r, MY_CXT.stash)));
+
+void
+delta_business_days(self, moment1, moment2)
+    SV *self
+    const moment_t *moment1
+    const moment_t *moment2
+  PREINIT:
+    const moment_business_t *bc;
+  PPCODE:
+    bc = sv_2business_ptr(self, "self");
+    XSRETURN_IV(moment_business_delta_days(bc,
+      (int)moment_rata_die_day(moment1), (int)moment_rata_die_day(moment2)));
+
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::Cron
+
+PROTOTYPES: DISABLE
+
+moment_cron_t
+new(klass, expression)
+    SV *klass
+    SV *expression
+  PREINIT:
+    dSTASH_CONSTRUCTOR_CRON(klass);
+    const char *str;
+    STRLEN len;
+  CODE:
+    str = SvPV_const(expression, len);
+    RETVAL = moment_cron_parse(str, len);
+  OUTPUT:
+    RETVAL
+
+void
+next_after(self, moment)
+    const moment_cron_t *self
+    const moment_t *moment
+  ALIAS:
+    Time::Moment::Cron::next_after  = 0
+    Time::Moment::Cron::prev_before = 1
+  PREINIT:
+    dMY_CXT;
+    moment_t r;
+    bool found;
+  PPCODE:
+    if (ix == 0)
+        found = moment_cron_next(self, moment, &r);
+    else
+        found = moment_cron_prev(self, moment, &r);
+    if (!found)
+        XSRETURN_UNDEF;
+    XSRETURN_SV(sv_2mortal(newSVmoment(&r, MY_CXT.stash)));
+
+void
+matches(self, moment)
+    const moment_cron_t *self
+    const moment_t *moment
+  PPCODE:
+    XSRETURN_BOOL(moment_cron_matches(self, moment));
+
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::Recurrence
+
+PROTOTYPES: DISABLE
+
+void
+new(klass, dtstart, rule)
+    SV *klass
+    const moment_t *dtstart
+    SV *rule
+  PREINIT:
+    dSTASH_CONSTRUCTOR_RRULE(klass);
+    const char *str;
+    STRLEN len;
+    SV *pv;
+  PPCODE:
+    str = SvPV_const(rule, len);
+    pv = sv_2mortal(newSV(sizeof(moment_rrule_t) + 1));
+    SvPOK_only(pv);
+    SvCUR_set(pv, sizeof(moment_rrule_t));
+    moment_rrule_parse(dtstart, str, len, (moment_rrule_t *)SvPVX(pv));
+    XSRETURN_SV(sv_2mortal(sv_bless(newRV_inc(pv), stash)));
+
+void
+next(self, target=NULL)
+    moment_rrule_t *self
+    SV *target
+  PREINIT:
+    dMY_CXT;
+    moment_t mt;
+  PPCODE:
+    if (!moment_rrule_next(self, &mt)) {
+        if (target)
+            XSRETURN_NO;
+        XSRETURN_EMPTY;
+    }
+    if (!target)
+        XSRETURN_SV(sv_2mortal(newSVmoment(&mt, MY_CXT.stash)));
+    sv_set_target_moment(target, &mt);
+    XSRETURN_YES;
+
+void
+reset(self)
+    moment_rrule_t *self
+  PPCODE:
+    moment_rrule_reset(self);
+    XSRETURN(1);
+
+void
+to_packed(self, limit=NULL)
+    const moment_rrule_t *self
+    SV *limit
+  PREINIT:
+    moment_rrule_t *rr;
+    moment_t mt;
+    IV n = -1;
+    SV *sv;
+  PPCODE:
+    if (limit && SvOK(limit)) {
+        n = SvIV(limit);
+        if (n < 0)
+            croak("Parameter 'limit' is out of range");
+    }
+    else if (!moment_rrule_is_bounded(self))
+        croak("Recurrence rule has neither COUNT nor UNTIL, a limit is required");
+    Newx(rr, 1, moment_rrule_t);
+    SAVEFREEPV(rr);
+    Copy(self, rr, 1, moment_rrule_t);
+    moment_rrule_reset(rr);
+    sv = sv_2mortal(newSV(64 * sizeof(moment_t)));
+    SvPOK_only(sv);
+    SvCUR_set(sv, 0);
+    while (n-- != 0 && moment_rrule_next(rr, &mt))
+        sv_cat_moment(sv, &mt);
+    *SvEND(sv) = '\0';
+    XSRETURN_SV(sv);
+
+
+MODULE = Time::Moment  PACKAGE = Time::Moment::Packed
+
+PROTOTYPES: DISABLE
+
+void
+lower_bound(buffer, format, moment)
+    SV *buffer
+    SV *format
+    const moment_t *moment
+  ALIAS:
+    Time::Moment::Packed::lower_bound = 0
+    Time::Moment::Packed::upper_bound = 1
+  PREINIT:
+    moment_packed_t f;
+    const char *buf;
+    size_t n, i;
+  PPCODE:
+    f = sv_packed_format(format);
+    buf = sv_2packed(buffer, f, "buffer", &n);
+    if (ix == 0)
+        i = moment_packed_lower_bound(buf, n, f, moment);
+    else
+        i = moment_packed_upper_bound(buf, n, f, moment);
+    XSRETURN_IV((IV)i);
+
+void
+bounds(buffer, format, from, to)
+    SV *buffer
+    SV *format
+    const moment_t *from
+    const moment_t *to
+  PREINIT:
+    moment_packed_t f;
+    const char *buf;
+    size_t n, lo, hi;
+  PPCODE:
+    f = sv_packed_format(format);
+    buf = sv_2packed(buffer, f, "buffer", &n);
+    lo = moment_packed_lower_bound(buf, n, f, from);
+    hi = moment_packed_lower_bound(buf + lo * moment_packed_width(f), n - lo, f, to) + lo;
+    EXTEND(SP, 2);
+    mPUSHi((IV)lo);
+    mPUSHi((IV)hi);
+    XSRETURN(2);
+
+void
+fields(buffer, format, offset, ...)
+    SV *buffer
+    SV *format
+    IV offset
+  PREINIT:
+    moment_packed_t f;
+    moment_component_t *fields;
+    int32_t **cols;
+    const char *buf;
+    size_t n, nfields, k;
+  PPCODE:
+    f = sv_packed_format(format);
+    buf = sv_2packed(buffer, f, "buffer", &n);
+    nfields = items - 3;
+    Newx(fields, nfields + 1, moment_component_t);
+    SAVEFREEPV(fields);
+    Newx(cols, nfields + 1, int32_t *);
+    SAVEFREEPV(cols);
+    for (k = 0; k < nfields; k++)
+        fields[k] = sv_moment_field(ST(k + 3));
+    EXTEND(SP, nfields);
+    for (k = 0; k < nfields; k++) {
+        SV *sv = sv_2mortal(newSVpacked(n * sizeof(int32_t)));
+        cols[k] = (int32_t *)SvPVX(sv);
+        PUSHs(sv);
+    }
+    moment_packed_fields(buf, n, f, offset, fields, nfields, cols);
+    XSRETURN(nfields);
+
+void
+delta(start, end, format, unit)
+    SV *start
+    SV *end
+    SV *format
+    SV *unit
+  PREINIT:
+    moment_packed_t f;
+    moment_unit_t u;
+    const char *a, *b;
+    size_t n, m;
+    SV *r, *overflow;
+  PPCODE:
+    f = sv_packed_format(format);
+    u = sv_moment_unit(unit);
+    a = sv_2packed(start, f, "start", &n);
+    b = sv_2packed(end, f, "end", &m);
+    if (n != m)
+        croak("start and end do not have the same number of elements");
+    r = sv_2mortal(newSVpacked(n * sizeof(int64_t)));
+    overflow = sv_2mortal(newSVpacked((n + 7) / 8));
+    moment_packed_delta(a, b, n, f, u, (int64_t *)SvPVX(r), (unsigned char *)SvPVX(overflow));
+    if (GIMME_V != G_ARRAY)
+        XSRETURN_SV(r);
+    EXTEND(SP, 2);
+    PUSHs(r);
+    PUSHs(overflow);
+    XSRETURN(2);
+
+void
+filter(buffer, format, ...)
+    SV *buffer
+    SV *format
+  ALIAS:
+    Time::Moment::Packed::filter         = 0
+    Time::Moment::Packed::filter_indices = 1
+  PREINIT:
+    moment_packed_filter_t flt;
+    moment_field_set_t *fields;
+    moment_packed_t f;
+    const char *buf;
+    size_t n, count;
+    SV *bitmap;
+    I32 i;
+  PPCODE:
+    f = sv_packed_format(format);
+    buf = sv_2packed(buffer, f, "buffer", &n);
+    if ((items % 2) != 0)
+        croak("Odd number of elements in named parameters");
+
+    Zero(&flt, 1, moment_packed_filter_t);
+    Newx(fields, items / 2, moment_field_set_t);
+    SAVEFREEPV(fields);
+    flt.fields = fields;
+    for (i = 2; i < items; i += 2) {
+        switch (sv_moment_param(ST(i))) {
+            case MOMENT_PARAM_FROM:
+                flt.from = sv_2moment_ptr(ST(i+1), "from");
+                break;
+            case MOMENT_PARAM_TO:
+                flt.to = sv_2moment_ptr(ST(i+1), "to");
+                break;
+            case MOMENT_PARAM_OFFSET:
+                flt.offset = SvIV(ST(i+1));
+                break;
+            default:
+            {
+                const char *str;
+                STRLEN len;
+                int c;
+
+                str = SvPV_const(ST(i), len);
+                c = moment_field(str, len);
+                if (c < 0)
+                    croak("Unrecognised parameter: '%"SVf"'", ST(i));
+                sv_2field_set(ST(i), ST(i+1), (moment_component_t)c, &fields[flt.nfields++]);
+            }
+        }
+    }
+    bitmap = sv_2mortal(newSVpacked((n + 7) / 8));
+    count = moment_packed_filter(buf, n, f, &flt, (unsigned char *)SvPVX(bitmap));
+    if (ix == 1) {
+        SV *r = sv_2mortal(newSVpacked(count * sizeof(int64_t)));
+        moment_packed_bitmap_indices((const unsigned char *)SvPVX(bitmap), n, (int64_t *)SvPVX(r));
+        XSRETURN_SV(r);
+    }
+    if (GIMME_V != G_ARRAY)
+        XSRETURN_SV(bitmap);
+    EXTEND(SP, 2);
+    PUSHs(bitmap);
+    mPUSHi((IV)count);
+    XSRETURN(2);
+
+void
+union(a, b, format)
+    SV *a
+    SV *b
+    SV *format
+  ALIAS:
+    Time::Moment::Packed::union        = MOMENT_PACKED_UNION
+    Time::Moment::Packed::intersection = MOMENT_PACKED_INTERSECTION
+    Time::Moment::Packed::difference   = MOMENT_PACKED_DIFFERENCE
+  PREINIT:
+    moment_packed_t f;
+    const char *x, *y;
+    size_t na, nb, n, width;
+    SV *r;
+  PPCODE:
+    f = sv_packed_format(format);
+    x = sv_2packed(a, f, "a", &na);
+    y = sv_2packed(b, f, "b", &nb);
+    width = moment_packed_width(f);
+    r = sv_2mortal(newSVpacked((na + nb) * width));
+    n = moment_packed_setop(x, na, y, nb, f, (moment_packed_setop_t)ix, SvPVX(r));
+    SvCUR_set(r, n * width);
+    XSRETURN_SV(r);
+
+void
+dedupe(buffer, format, precision=9)
+    SV *buffer
+    SV *format
+    IV precision
+  PREINIT:
+    moment_packed_t f;
+    const char *buf;
+    size_t n, width;
+    SV *r;
+  PPCODE:
+    f = sv_packed_format(format);
+    buf = sv_2packed(buffer, f, "buffer", &n);
+    width = moment_packed_width(f);
+    r = sv_2mortal(newSVpacked(n * width));
+    n = moment_packed_dedupe(buf, n, f, precision, SvPVX(r));
+    SvCUR_set(r, n * width);
+    XSRETURN_SV(r);
+
+void
+asof(left, right, format, direction = NULL, tolerance = NULL, unit = NULL)
+    SV *left
+    SV *right
+    SV *format
+    SV *direction
+    SV *tolerance
+    SV *unit
+  PREINIT:
+    moment_packed_asof_t join;
+    moment_packed_t f;
+    const char *l, *r;
+    size_t nl, nr, count;
+    SV *indices;
+  PPCODE:
+    f = sv_packed_format(format);
+    l = sv_2packed(left, f, "left", &nl);
+    r = sv_2packed(right, f, "right", &nr);
+    Zero(&join, 1, moment_packed_asof_t);
+    join.direction = MOMENT_ASOF_BACKWARD;
+    if (direction && SvOK(direction)) {
+        const char *str;
+        STRLEN len;
+
+        str = SvPV_const(direction, len);
+        if (len == 8 && memEQ(str, "backward", 8))
+            join.direction = MOMENT_ASOF_BACKWARD;
+        else if (len == 7 && memEQ(str, "forward", 7))
+            join.direction = MOMENT_ASOF_FORWARD;
+        else if (len == 7 && memEQ(str, "nearest", 7))
+            join.direction = MOMENT_ASOF_NEAREST;
+        else
+            croak("Unrecognised direction: '%"SVf"'", direction);
+    }
+    if (tolerance && SvOK(tolerance)) {
+        if (!unit)
+            croak("Parameter 'unit' is required with a tolerance");
+        join.tolerant = TRUE;
+        join.tolerance = SvI64V(tolerance);
+        join.unit = sv_moment_unit(unit);
+    }
+    indices = sv_2mortal(newSVpacked(nl * sizeof(int64_t)));
+    count = moment_packed_asof(l, nl, r, nr, f, &join, (int64_t *)SvPVX(indices));
+    if (GIMME_V != G_ARRAY)
+        XSRETURN_SV(indices);
+    EXTEND(SP, 2);
+    PUSHs(indices);
+    mPUSHi((IV)count);
+    XSRETURN(2);
+
+void
+window_counts(buffer, format, window, unit)
+    SV *buffer
+    SV *format
+    I64V window
+    SV *unit
+  PREINIT:
+    moment_packed_t f;
+    moment_unit_t u;
+    const char *buf;
+    size_t n;
+    SV *counts, *first = NULL, *last = NULL;
+  PPCODE:
+    f = sv_packed_format(format);
+    u = sv_moment_unit(unit);
+    buf = sv_2packed(buffer, f, "buffer", &n);
+    counts = sv_2mortal(newSVpacked(n * sizeof(int64_t)));
+    if (GIMME_V == G_ARRAY) {
+        first = sv_2mortal(newSVpacked(n * sizeof(int64_t)));
+        last  = sv_2mortal(newSVpacked(n * sizeof(int64_t)));
+    }
+    moment_packed_window(buf, n, f, u, window, (int64_t *)SvPVX(counts),
+      first ? (int64_t *)SvPVX(first) : NULL, last ? (int64_t *)SvPVX(last) : NULL);
+    if (!first)
+        XSRETURN_SV(counts);
+    EXTEND(SP, 3);
+    PUSHs(counts);
+    PUSHs(first);
+    PUSHs(last);
+    XSRETURN(3);
+
+void
+merge(format, ...)
+    SV *format
+  PREINIT:
+    moment_packed_t f;
+    const char **bufs;
+    size_t *ns;
+    moment_merge_node_t *heap;
+    size_t k, s, total;
+    SV *sources, *indices;
+  PPCODE:
+    f = sv_packed_format(format);
+    k = items - 1;
+    Newx(bufs, k + 1, const char *);
+    SAVEFREEPV(bufs);
+    Newx(ns, k + 1, size_t);
+    SAVEFREEPV(ns);
+    Newx(heap, k + 1, moment_merge_node_t);
+    SAVEFREEPV(heap);
+    for (s = 0, total = 0; s < k; s++) {
+        bufs[s] = sv_2packed(ST(s + 1), f, "buffer", &ns[s]);
+        total += ns[s];
+    }
+    sources = sv_2mortal(newSVpacked(total * sizeof(int32_t)));
+    indices = sv_2mortal(newSVpacked(total * sizeof(int64_t)));
+    moment_packed_merge((const void * const *)bufs, ns, k, f, heap,
+      (int32_t *)SvPVX(sources), (int64_t *)SvPVX(indices));
+    EXTEND(SP, 2);
+    PUSHs(sources);
+    PUSHs(indices);
+    XSRETURN(2);
+
+void
+zone_map(buffer, format, block_size)
+    SV *buffer
+    SV *format
+    I64V block_size
+  PREINIT:
+    moment_packed_t f;
+    const char *buf;
+    size_t n;
+    SV *r;
+  PPCODE:
+    f = sv_packed_format(format);
+    buf = sv_2packed(buffer, f, "buffer", &n);
+    r = sv_2mortal(newSVpacked(moment_zonemap_size(n, block_size)));
+    moment_zonemap_build(buf, n, f, block_size, (moment_zonemap_t *)SvPVX(r));
+    XSRETURN_SV(r);
+
+void
+zone_map_extend(zone_map, buffer)
+    SV *zone_map
+    SV *buffer
+  PREINIT:
+    const moment_zonemap_t *zm;
+    const char *buf;
+    size_t n;
+    SV *r;
+  PPCODE:
+    zm = sv_2zonemap(zone_map);
+    buf = sv_2packed(buffer, (moment_packed_t)zm->format, "buffer", &n);
+    r = sv_2mortal(newSVpacked(moment_zonemap_size(n, zm->block)));
+    moment_zonemap_extend(zm, buf, n, (moment_zonemap_t *)SvPVX(r));
+    XSRETURN_SV(r);
+
+void
+zone_map_info(zone_map)
+    SV *zone_map
+  PREINIT:
+    static const char *const formats[] = {
+        "seconds", "milliseconds", "microseconds", "nanoseconds", "moment"
+    };
+    const moment_zonemap_t *zm;
+  PPCODE:
+    zm = sv_2zonemap(zone_map);
+    EXTEND(SP, 3);
+    mPUSHs(newSVpv(formats[zm->format], 0));
+    mPUSHi((IV)zm->block);
+    mPUSHi((IV)zm->elements);
+    XSRETURN(3);
+
+void
+candidate_blocks(zone_map, from, to)
+    SV *zone_map
+    const moment_t *from
+    const moment_t *to
+  PREINIT:
+    const moment_zonemap_t *zm;
+    size_t count;
+    SV *r;
+  PPCODE:
+    zm = sv_2zonemap(zone_map);
+    r = sv_2mortal(newSVpacked(moment_zonemap_blocks(zm) * sizeof(int64_t)));
+    count = moment_zonemap_candidates(zm, from, to, (int64_t *)SvPVX(r));
+    SvCUR_set(r, count * sizeof(int64_t));
+    XSRETURN_SV(r);
+
+void
+plus_unit(buffer, unit, value)
+    SV *buffer
+    SV *unit
+    I64V value
+  PREINIT:
+    SV *failed;
+    size_t count;
+  PPCODE:
+    count = packed_transform(buffer, MOMENT_PACKED_PLUS_UNIT, sv_moment_unit(unit), value, &failed);
+    if (GIMME_V != G_ARRAY)
+        XSRETURN_IV((IV)count);
+    EXTEND(SP, 2);
+    mPUSHi((IV)count);
+    PUSHs(failed);
+    XSRETURN(2);
+
+void
+with_offset_same_instant(buffer, value)
+    SV *buffer
+    I64V value
+  ALIAS:
+    Time::Moment::Packed::with_offset_same_instant = MOMENT_PACKED_WITH_OFFSET_SAME_INSTANT
+    Time::Moment::Packed::with_precision           = MOMENT_PACKED_WITH_PRECISION
+  PREINIT:
+    SV *failed;
+    size_t count;
+  PPCODE:
+    count = packed_transform(buffer, (moment_packed_op_t)ix, MOMENT_UNIT_NANOS, value, &failed);
+    if (GIMME_V != G_ARRAY)
+        XSRETURN_IV((IV)count);
+    EXTEND(SP, 2);
+    mPUSHi((IV)count);
+    PUSHs(failed);
+    XSRETURN(2);
+
+void
+truncate_to(buffer, unit)
+    SV *buffer
+    SV *unit
+  PREINIT:
+    SV *failed;
+    size_t count;
+  PPCODE:
+    count = packed_transform(buffer, MOMENT_PACKED_TRUNCATE, sv_moment_unit(unit), 0, &failed);
+    if (GIMME_V != G_ARRAY)
+        XSRETURN_IV((IV)count);
+    EXTEND(SP, 2);
+    mPUSHi((IV)count);
+    PUSHs(failed);
+    XSRETURN(2);
+
+void
+at_midnight(buffer)
+    SV *buffer
+  PREINIT:
+    SV *failed;
+    size_t count;
+  PPCODE:
+    count = packed_transform(buffer, MOMENT_PACKED_AT_MIDNIGHT, MOMENT_UNIT_NANOS, 0, &failed);
+    if (GIMME_V != G_ARRAY)
+        XSRETURN_IV((IV)count);
+    EXTEND(SP, 2);
+    mPUSHi((IV)count);
+    PUSHs(failed);
+    XSRETURN(2);
 
 MODULE = Time::Moment  PACKAGE = Time::Moment::Internal
 
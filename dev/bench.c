@@ -0,0 +1,540 @@
+/*
+ * Micro-benchmark of the dt_* and moment_core kernels, without Perl.
+ *
+ *   make bench                              run all benchmarks
+ *   make bench BENCH_ARGS='-s base.txt'     save results as a baseline
+ *   make bench BENCH_ARGS='-b base.txt'     compare against a baseline
+ *   make bench BENCH_ARGS='parse'           run benchmarks matching 'parse'
+ *   make bench BENCH_ARGS='-m 100000000 packed'
+ *                                           run the packed buffer kernels
+ *                                           over 100M elements
+ *
+ * Each benchmark cycles through a fixed, pseudo-randomly generated set of
+ * inputs (mostly dates between 1970 and 2038, with some spread over the
+ * full 0001-9999 range) and reports the best of several runs in ns/op and,
+ * where a cycle counter is available, cycles/op. The packed_* benchmarks
+ * run over buffers of -m elements (default 1M) built from the same inputs,
+ * and report the time per element.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "moment_core.h"
+#include "moment_packed.h"
+#include "dt_core.h"
+#include "dt_arithmetic.h"
+#include "dt_parse_iso.h"
+#include "dt_util.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <x86intrin.h>
+#  define HAVE_CYCLES 1
+#  define read_cycles() __rdtsc()
+#else
+#  define HAVE_CYCLES 0
+#  define read_cycles() 0
+#endif
+
+#define NINPUTS   4096
+#define NRUNS     7
+#define MAXBENCH  32
+
+typedef struct {
+    int     y, m, d;
+    int     wy, ww, wd;
+    dt_t    dt;
+    moment_t mt;
+    char    ext[MOMENT_STRING_MAX];
+    size_t  ext_len;
+    char    bas[MOMENT_STRING_MAX];
+    size_t  bas_len;
+} input_t;
+
+typedef struct {
+    const char *name;
+    double      ns;
+    double      cycles;
+} result_t;
+
+static input_t  inputs[NINPUTS];
+static volatile int64_t sink;
+
+static size_t         packed_n = 1000000;
+static int64_t       *packed_millis;
+static moment_t      *packed_moments;
+static unsigned char *packed_bitmap;
+static moment_t       packed_from, packed_to;
+
+static uint64_t rng_state = UINT64_C(0x9E3779B97F4A7C15);
+
+static uint64_t
+rng_next(void) {
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+static int
+rng_range(int lo, int hi) {
+    return lo + (int)(rng_next() % (uint64_t)(hi - lo + 1));
+}
+
+static void
+init_inputs(void) {
+    static const int offsets[] = { 0, 0, 0, 60, 120, -300, -480, 330, 545, -210 };
+    int i, rdn, sod, nsec, offset, y, m, d, h, mi, s;
+    moment_t mt;
+
+    for (i = 0; i < NINPUTS; i++) {
+        if (rng_range(0, 9) < 8)
+            rdn = rng_range(719163, 744018); /* 1970-01-01 .. 2038-01-19 */
+        else
+            rdn = rng_range(1, 3652059);     /* 0001-01-01 .. 9999-12-31 */
+
+        sod = rng_range(0, 86399);
+        switch (rng_range(0, 3)) {
+            case 0:  nsec = 0;                                 break;
+            case 1:  nsec = rng_range(0, 999) * 1000000;       break;
+            case 2:  nsec = rng_range(0, 999999) * 1000;       break;
+            default: nsec = rng_range(0, 999999999);           break;
+        }
+        offset = offsets[rng_range(0, 9)];
+
+        mt.sec    = (int64_t)rdn * 86400 + sod;
+        mt.nsec   = nsec;
+        mt.offset = offset;
+        if (mt.sec < MIN_RANGE + 86400 || mt.sec > MAX_RANGE - 86400)
+            mt.offset = 0;
+
+        dt_to_ymd(dt_from_rdn(rdn), &y, &m, &d);
+        h  = sod / 3600;
+        mi = sod / 60 % 60;
+        s  = sod % 60;
+
+        inputs[i].y  = y;
+        inputs[i].m  = m;
+        inputs[i].d  = d;
+        inputs[i].dt = dt_from_rdn(rdn);
+        dt_to_ywd(inputs[i].dt, &inputs[i].wy, &inputs[i].ww, &inputs[i].wd);
+        inputs[i].mt = mt;
+        inputs[i].ext_len = moment_to_string_buffer(&mt, false,
+            inputs[i].ext, sizeof(inputs[i].ext));
+        inputs[i].bas_len = (size_t)sprintf(inputs[i].bas,
+            "%04d%02d%02dT%02d%02d%02dZ", y, m, d, h, mi, s);
+    }
+}
+
+static void
+init_packed(void) {
+    size_t i;
+
+    packed_millis  = malloc(packed_n * sizeof(int64_t));
+    packed_moments = malloc(packed_n * sizeof(moment_t));
+    packed_bitmap  = malloc((packed_n + 7) / 8);
+    if (!packed_millis || !packed_moments || !packed_bitmap) {
+        fprintf(stderr, "bench: could not allocate packed buffers of %lu elements\n",
+          (unsigned long)packed_n);
+        exit(2);
+    }
+    for (i = 0; i < packed_n; i++) {
+        const moment_t *mt = &inputs[i % NINPUTS].mt;
+        packed_moments[i] = *mt;
+        packed_millis[i]  = (moment_instant_rd_seconds(mt) - UNIX_EPOCH) * 1000 + mt->nsec / 1000000;
+    }
+    /* 2000-01-01T00:00:00Z and 2020-01-01T00:00:00Z */
+    moment_core_from_epoch(INT64_C(946684800), 0, 0, &packed_from);
+    moment_core_from_epoch(INT64_C(1577836800), 0, 0, &packed_to);
+}
+
+static double
+now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1E9 + (double)ts.tv_nsec;
+}
+
+/* Kernels; each processes the whole input set once and returns a checksum */
+
+static int64_t
+bench_dt_from_ymd(void) {
+    int64_t r = 0;
+    int i;
+    for (i = 0; i < NINPUTS; i++)
+        r += dt_from_ymd(inputs[i].y, inputs[i].m, inputs[i].d);
+    return r;
+}
+
+static int64_t
+bench_dt_to_ymd(void) {
+    int64_t r = 0;
+    int i, y, m, d;
+    for (i = 0; i < NINPUTS; i++) {
+        dt_to_ymd(inputs[i].dt, &y, &m, &d);
+        r += y + m + d;
+    }
+    return r;
+}
+
+static int64_t
+bench_dt_to_yd(void) {
+    int64_t r = 0;
+    int i, y, d;
+    for (i = 0; i < NINPUTS; i++) {
+        dt_to_yd(inputs[i].dt, &y, &d);
+        r += y + d;
+    }
+    return r;
+}
+
+static int64_t
+bench_dt_to_ywd(void) {
+    int64_t r = 0;
+    int i, y, w, d;
+    for (i = 0; i < NINPUTS; i++) {
+        dt_to_ywd(inputs[i].dt, &y, &w, &d);
+        r += y + w + d;
+    }
+    return r;
+}
+
+static int64_t
+bench_dt_from_ywd(void) {
+    int64_t r = 0;
+    int i;
+    for (i = 0; i < NINPUTS; i++)
+        r += dt_from_ywd(inputs[i].wy, inputs[i].ww, inputs[i].wd);
+    return r;
+}
+
+static int64_t
+bench_dt_weeks_in_year(void) {
+    int64_t r = 0;
+    int i;
+    for (i = 0; i < NINPUTS; i++)
+        r += dt_weeks_in_year(inputs[i].y);
+    return r;
+}
+
+static int64_t
+bench_dt_days_in_month(void) {
+    int64_t r = 0;
+    int i;
+    for (i = 0; i < NINPUTS; i++)
+        r += dt_days_in_month(inputs[i].y, inputs[i].m);
+    return r;
+}
+
+static int64_t
+bench_dt_add_months(void) {
+    int64_t r = 0;
+    int i;
+    for (i = 0; i < NINPUTS; i++)
+        r += dt_add_months(inputs[i].dt, (i & 31) - 16, DT_LIMIT);
+    return r;
+}
+
+static int64_t
+bench_dt_parse_iso_date(void) {
+    int64_t r = 0;
+    dt_t dt;
+    int i;
+    for (i = 0; i < NINPUTS; i++) {
+        if (dt_parse_iso_date(inputs[i].ext, inputs[i].ext_len, &dt))
+            r += dt;
+    }
+    return r;
+}
+
+static int64_t
+bench_parse_extended(void) {
+    int64_t r = 0;
+    moment_t mt;
+    int i;
+    for (i = 0; i < NINPUTS; i++) {
+        if (moment_core_from_string(inputs[i].ext, inputs[i].ext_len, false, &mt) == MOMENT_OK)
+            r += mt.sec;
+    }
+    return r;
+}
+
+static int64_t
+bench_parse_basic(void) {
+    int64_t r = 0;
+    moment_t mt;
+    int i;
+    for (i = 0; i < NINPUTS; i++) {
+        if (moment_core_from_string(inputs[i].bas, inputs[i].bas_len, false, &mt) == MOMENT_OK)
+            r += mt.sec;
+    }
+    return r;
+}
+
+static int64_t
+bench_parse_lenient(void) {
+    int64_t r = 0;
+    moment_t mt;
+    int i;
+    for (i = 0; i < NINPUTS; i++) {
+        if (moment_core_from_string(inputs[i].ext, inputs[i].ext_len, true, &mt) == MOMENT_OK)
+            r += mt.sec;
+    }
+    return r;
+}
+
+static int64_t
+bench_to_string(void) {
+    char buf[MOMENT_STRING_MAX];
+    int64_t r = 0;
+    int i;
+    for (i = 0; i < NINPUTS; i++)
+        r += moment_to_string_buffer(&inputs[i].mt, false, buf, sizeof(buf)) + buf[3];
+    return r;
+}
+
+static int64_t
+bench_plus_months(void) {
+    int64_t r = 0;
+    moment_t mt;
+    int i;
+    for (i = 0; i < NINPUTS; i++) {
+        if (moment_core_plus_unit(&inputs[i].mt, MOMENT_UNIT_MONTHS, (i & 31) - 16, &mt) == MOMENT_OK)
+            r += mt.sec;
+    }
+    return r;
+}
+
+static int64_t
+bench_accessors(void) {
+    int64_t r = 0;
+    int i;
+    for (i = 0; i < NINPUTS; i++) {
+        const moment_t *mt = &inputs[i].mt;
+        r += moment_year(mt) + moment_month(mt) + moment_day_of_month(mt)
+           + moment_hour(mt) + moment_minute(mt) + moment_second(mt);
+    }
+    return r;
+}
+
+static int64_t
+bench_packed_filter(moment_packed_t f, const void *buf, const moment_field_set_t *fields, size_t nfields) {
+    moment_packed_filter_t flt;
+    size_t count = 0;
+
+    flt.from    = &packed_from;
+    flt.to      = &packed_to;
+    flt.offset  = 0;
+    flt.fields  = fields;
+    flt.nfields = nfields;
+    moment_core_packed_filter(buf, packed_n, f, &flt, packed_bitmap, &count);
+    return (int64_t)count;
+}
+
+static int64_t
+bench_packed_filter_range(void) {
+    return bench_packed_filter(MOMENT_PACKED_MILLIS, packed_millis, NULL, 0);
+}
+
+static int64_t
+bench_packed_filter_moment(void) {
+    return bench_packed_filter(MOMENT_PACKED_MOMENT, packed_moments, NULL, 0);
+}
+
+static int64_t
+bench_packed_filter_fields(void) {
+    static const uint64_t weekdays = 0x1F;      /* 1 .. 5 */
+    static const uint64_t hours    = 0x1FF;     /* 9 .. 17 */
+    moment_field_set_t fields[2];
+
+    fields[0].field = MOMENT_FIELD_DAY_OF_WEEK;
+    fields[0].min   = 1;
+    fields[0].max   = 5;
+    fields[0].set   = &weekdays;
+    fields[1].field = MOMENT_FIELD_HOUR_OF_DAY;
+    fields[1].min   = 9;
+    fields[1].max   = 17;
+    fields[1].set   = &hours;
+    return bench_packed_filter(MOMENT_PACKED_MILLIS, packed_millis, fields, 2);
+}
+
+static const struct {
+    const char *name;
+    int64_t   (*fn)(void);
+    bool        packed;
+} benchmarks[] = {
+    { "dt_from_ymd",           bench_dt_from_ymd,          false },
+    { "dt_to_ymd",             bench_dt_to_ymd,            false },
+    { "dt_to_yd",              bench_dt_to_yd,             false },
+    { "dt_to_ywd",             bench_dt_to_ywd,            false },
+    { "dt_from_ywd",           bench_dt_from_ywd,          false },
+    { "dt_weeks_in_year",      bench_dt_weeks_in_year,     false },
+    { "dt_days_in_month",      bench_dt_days_in_month,     false },
+    { "dt_add_months",         bench_dt_add_months,        false },
+    { "dt_parse_iso_date",     bench_dt_parse_iso_date,    false },
+    { "parse_string_extended", bench_parse_extended,       false },
+    { "parse_string_basic",    bench_parse_basic,          false },
+    { "parse_string_lenient",  bench_parse_lenient,        false },
+    { "to_string",             bench_to_string,            false },
+    { "plus_months",           bench_plus_months,          false },
+    { "accessors",             bench_accessors,            false },
+    { "packed_filter_range",   bench_packed_filter_range,  true },
+    { "packed_filter_moment",  bench_packed_filter_moment, true },
+    { "packed_filter_fields",  bench_packed_filter_fields, true },
+};
+
+#define NBENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+static result_t
+run_benchmark(size_t b, long iterations) {
+    result_t res;
+    double t0, t1, best_ns, ops;
+    uint64_t c0, c1, best_cycles;
+    long i;
+    int run;
+
+    /* Packed benchmarks process the same number of elements as the others, or one buffer */
+    ops = NINPUTS;
+    if (benchmarks[b].packed) {
+        if (!packed_millis)
+            init_packed();
+        ops = (double)packed_n;
+        iterations = (long)((double)iterations * NINPUTS / ops);
+        if (iterations < 1)
+            iterations = 1;
+    }
+    best_ns = -1;
+    best_cycles = 0;
+    for (run = 0; run < NRUNS; run++) {
+        t0 = now_ns();
+        c0 = read_cycles();
+        for (i = 0; i < iterations; i++)
+            sink += benchmarks[b].fn();
+        c1 = read_cycles();
+        t1 = now_ns();
+        if (best_ns < 0 || t1 - t0 < best_ns) {
+            best_ns = t1 - t0;
+            best_cycles = c1 - c0;
+        }
+    }
+    res.name   = benchmarks[b].name;
+    res.ns     = best_ns / ((double)iterations * ops);
+    res.cycles = (double)best_cycles / ((double)iterations * ops);
+    return res;
+}
+
+static int
+load_baseline(const char *path, result_t *base, char names[][64], int max) {
+    char line[256];
+    FILE *fp;
+    int n = 0;
+
+    if ((fp = fopen(path, "r")) == NULL) {
+        fprintf(stderr, "bench: could not open baseline '%s'\n", path);
+        exit(2);
+    }
+    while (n < max && fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%63s %lf %lf", names[n], &base[n].ns, &base[n].cycles) == 3) {
+            base[n].name = names[n];
+            n++;
+        }
+    }
+    fclose(fp);
+    return n;
+}
+
+static const result_t *
+find_result(const result_t *res, int n, const char *name) {
+    int i;
+    for (i = 0; i < n; i++) {
+        if (strcmp(res[i].name, name) == 0)
+            return &res[i];
+    }
+    return NULL;
+}
+
+static void
+usage(void) {
+    fprintf(stderr, "usage: bench [-n iterations] [-m elements] [-s save] [-b baseline] [filter ...]\n");
+    exit(2);
+}
+
+int
+main(int argc, char **argv) {
+    static char base_names[MAXBENCH][64];
+    result_t results[MAXBENCH], base[MAXBENCH];
+    const char *save_path = NULL, *base_path = NULL;
+    long iterations = 200;
+    int i, j, nresults = 0, nbase = 0, selected;
+    size_t b;
+    FILE *fp;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (i + 1 >= argc)
+            usage();
+        switch (argv[i][1]) {
+            case 'n': iterations = atol(argv[++i]); break;
+            case 'm': packed_n   = (size_t)atol(argv[++i]); break;
+            case 's': save_path  = argv[++i];       break;
+            case 'b': base_path  = argv[++i];       break;
+            default:  usage();
+        }
+    }
+    if (iterations < 1 || packed_n < 1)
+        usage();
+
+    if (base_path)
+        nbase = load_baseline(base_path, base, base_names, MAXBENCH);
+
+    init_inputs();
+
+    printf("%-24s %10s %10s", "benchmark", "ns/op", HAVE_CYCLES ? "cycles/op" : "");
+    if (base_path)
+        printf(" %10s %8s", "base ns", "change");
+    printf("\n");
+
+    for (b = 0; b < NBENCHMARKS; b++) {
+        const result_t *prev;
+        result_t res;
+
+        selected = (i == argc);
+        for (j = i; j < argc; j++) {
+            if (strstr(benchmarks[b].name, argv[j]))
+                selected = 1;
+        }
+        if (!selected)
+            continue;
+
+        res = run_benchmark(b, iterations);
+        results[nresults++] = res;
+
+        printf("%-24s %10.2f", res.name, res.ns);
+        if (HAVE_CYCLES)
+            printf(" %10.2f", res.cycles);
+        else
+            printf(" %10s", "");
+        if (base_path) {
+            prev = find_result(base, nbase, res.name);
+            if (prev)
+                printf(" %10.2f %+7.1f%%", prev->ns, (res.ns / prev->ns - 1.0) * 100.0);
+            else
+                printf(" %10s %8s", "-", "-");
+        }
+        printf("\n");
+    }
+
+    if (save_path) {
+        if ((fp = fopen(save_path, "w")) == NULL) {
+            fprintf(stderr, "bench: could not write baseline '%s'\n", save_path);
+            return 2;
+        }
+        fprintf(fp, "# name ns/op cycles/op\n");
+        for (j = 0; j < nresults; j++)
+            fprintf(fp, "%s %.3f %.3f\n", results[j].name, results[j].ns, results[j].cycles);
+        fclose(fp);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#!/usr/bin/perl
+use strict;
+use warnings;
+
+# Generates src/dt_year_table.h, the per-year facts of one 400-year
+# Gregorian cycle. The cycle is exactly 146097 days, a multiple of seven,
+# so the leap flag, the weekday of January 1 and the number of ISO weeks
+# repeat with it. Usage: perl dev/gen_year_table.pl > src/dt_year_table.h
+
+sub leap_year {
+    my ($y) = @_;
+    return ($y % 4 == 0 && ($y % 100 != 0 || $y % 400 == 0)) ? 1 : 0;
+}
+
+my @entries;
+my $days = 0;
+for my $r (0..399) {
+    my $y     = $r + 1;
+    my $leap  = leap_year($y);
+    my $dow   = ($days + 1) % 7 || 7; # rdn 1 (0001-01-01) is a Monday
+    my $weeks = ($dow == 4 || ($dow == 3 && $leap)) ? 1 : 0;
+    push @entries, $days | ($leap << 18) | ($dow << 19) | ($weeks << 22);
+    $days += 365 + $leap;
+}
+die "cycle is not 146097 days" unless $days == 146097;
+
+print <<'EOT';
+/* Generated by dev/gen_year_table.pl, do not edit */
+#ifndef __DT_YEAR_TABLE_H__
+#define __DT_YEAR_TABLE_H__
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Facts of the years 1-400 of the 400-year Gregorian cycle, indexed by
+ * (year - 1) mod 400:
+ *
+ *   bits  0-17  days from the start of the cycle to January 1
+ *   bit     18  leap year
+ *   bits 19-21  day of the week of January 1 (1=Monday, 7=Sunday)
+ *   bit     22  the ISO 8601 week-numbering year has 53 weeks
+ */
+#define DT_YEAR_DAYS(e)     ((int)((e) & 0x3FFFF))
+#define DT_YEAR_LEAP(e)     ((int)(((e) >> 18) & 1))
+#define DT_YEAR_JAN1_DOW(e) ((int)(((e) >> 19) & 7))
+#define DT_YEAR_WEEKS(e)    (52 + (int)(((e) >> 22) & 1))
+
+static const uint32_t dt_year_table[400] = {
+EOT
+
+for (my $i = 0; $i < @entries; $i += 6) {
+    my $last = $i + 5 < $#entries ? $i + 5 : $#entries;
+    print '    ', join(', ', map { sprintf '0x%08X', $_ } @entries[$i..$last]),
+      ($last == $#entries ? '' : ','), "\n";
+}
+
+print <<'EOT';
+};
+
+/* Returns the table entry of the year y and stores the number of whole
+   400-year cycles preceding the year in *cp */
+static uint32_t
+dt_year_entry(int y, int *cp) {
+    unsigned int n, c;
+
+    if (y < 1) {
+        const int n400 = 1 - y/400;
+        uint32_t e = dt_year_entry(y + n400 * 400, cp);
+        if (cp) *cp -= n400;
+        return e;
+    }
+    n = (unsigned int)y - 1;
+    c = n / 400;
+    if (cp) *cp = (int)c;
+    return dt_year_table[n - c * 400];
+}
+
+#endif
+EOT
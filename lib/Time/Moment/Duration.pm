@@ -0,0 +1,12 @@
+package Time::Moment::Duration;
+use strict;
+use warnings;
+
+use Time::Moment qw[];
+
+BEGIN {
+    our $VERSION = '0.46';
+}
+
+1;
+
@@ -134,15 +134,17 @@ dt_delta_yqd(dt_t dt1, dt_t dt2, int *yp, int *qp, int *dp) {
         nq--;
         nd = dt2 - dt_add_quarters(dt1, nq, DT_LIMIT);
     }
-    else if (nq < 0 && nd > 0) {
-        nq++;
-        nd -= dt_days_in_quarter(y2, q2);
+    else if (nq < 0) {
+        /* dt1 plus nq quarters may be clamped to the end of the quarter */
+        if (nd > 0)
+            nq++;
+        nd = dt2 - dt_add_quarters(dt1, nq, DT_LIMIT);
     }
     
     ny = nq / 4;
     nq = nq - ny * 4;
     
-    if (qp) *yp = ny;
+    if (yp) *yp = ny;
     if (qp) *qp = nq;
     if (dp) *dp = nd;
 }
@@ -161,9 +163,11 @@ dt_delta_ymd(dt_t dt1, dt_t dt2, int *yp, int *mp, int *dp) {
         nm--;
         nd = dt2 - dt_add_months(dt1, nm, DT_LIMIT);
     }
-    else if (nm < 0 && nd > 0) {
-        nm++;
-        nd -= dt_days_in_month(y2, m2);
+    else if (nm < 0) {
+        /* dt1 plus nm months may be clamped to the end of the month */
+        if (nd > 0)
+            nm++;
+        nd = dt2 - dt_add_months(dt1, nm, DT_LIMIT);
     }
 
     ny = nm / 12;
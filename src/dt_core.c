@@ -24,7 +24,9 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <assert.h>
+#include <stdint.h>
 #include "dt_core.h"
+#include "dt_year_table.h"
 
 #define LEAP_YEAR(y) \
     (((y) & 3) == 0 && ((y) % 100 != 0 || (y) % 400 == 0))
@@ -49,17 +51,18 @@ dt_from_rdn(int n) {
 
 dt_t
 dt_from_yd(int y, int d) {
-    y--;
-    if (y < 0) {
-        const int n400 = 1 - y/400;
-        y += n400 * 400;
-        d -= n400 * 146097;
-    }
-    return 365 * y + y/4 - y/100 + y/400 + d + DT_EPOCH_OFFSET;
+    uint32_t e;
+    int c;
+
+    e = dt_year_entry(y, &c);
+    return c * 146097 + DT_YEAR_DAYS(e) + d + DT_EPOCH_OFFSET;
 }
 
 dt_t
 dt_from_ymd(int y, int m, int d) {
+    uint32_t e;
+    int c;
+
     if (m < 1 || m > 12) {
         y += m / 12;
         m %= 12;
@@ -68,11 +71,16 @@ dt_from_ymd(int y, int m, int d) {
     }
     assert(m >=  1);
     assert(m <= 12);
-    return dt_from_yd(y, days_preceding_month[LEAP_YEAR(y)][m] + d);
+    e = dt_year_entry(y, &c);
+    return c * 146097 + DT_YEAR_DAYS(e)
+         + days_preceding_month[DT_YEAR_LEAP(e)][m] + d + DT_EPOCH_OFFSET;
 }
 
 dt_t
 dt_from_yqd(int y, int q, int d) {
+    uint32_t e;
+    int c;
+
     if (q < 1 || q > 4) {
         y += q / 4;
         q %= 4;
@@ -81,85 +89,73 @@ dt_from_yqd(int y, int q, int d) {
     }
     assert(q >= 1);
     assert(q <= 4);
-    return dt_from_yd(y, days_preceding_quarter[LEAP_YEAR(y)][q] + d);
+    e = dt_year_entry(y, &c);
+    return c * 146097 + DT_YEAR_DAYS(e)
+         + days_preceding_quarter[DT_YEAR_LEAP(e)][q] + d + DT_EPOCH_OFFSET;
 }
 
 dt_t
 dt_from_ywd(int y, int w, int d) {
-    dt_t dt;
-
-    dt  = dt_from_yd(y, 4);
-    dt -= dt_dow(dt);
-    dt += w * 7 + d - 7;
-    return dt;
+    uint32_t e;
+    int c, dow;
+
+    e   = dt_year_entry(y, &c);
+    dow = DT_YEAR_JAN1_DOW(e);
+    /* Week 1 begins on the Monday of the week containing January 4 */
+    return c * 146097 + DT_YEAR_DAYS(e) + DT_EPOCH_OFFSET
+         + (dow <= 4 ? 2 - dow : 9 - dow) + (w - 1) * 7 + (d - 1);
 }
 
 
-#ifndef DT_NO_SHORTCUTS
-static const dt_t DT1901 = 693961 + DT_EPOCH_OFFSET; /* 1901-01-01 */
-static const dt_t DT2099 = 766644 + DT_EPOCH_OFFSET; /* 2099-12-31 */
-#endif
+/*
+ * Days to calendar date conversion after C. Neri and L. Schneider,
+ * "Euclidean affine functions and their application to calendar
+ * algorithms" (2022). The date is computed in a calendar whose years begin
+ * on March 1, so the leap day is the last day of the year, and the day
+ * count is shifted by DT_NS_CYCLES 400-year cycles to keep the arithmetic
+ * unsigned. Valid from -32800-03-01 through 2907005-06-05.
+ */
+#define DT_NS_CYCLES 82
+#define DT_NS_DAYS   (DT_NS_CYCLES * 146097 + 305 - DT_EPOCH_OFFSET)
+#define DT_NS_YEARS  (DT_NS_CYCLES * 400)
+
+static void
+dt_to_computational(dt_t d, uint32_t *yp, uint32_t *np, int *lp) {
+    uint32_t n, c, z, nc;
+    uint64_t p;
+
+    n  = (uint32_t)(d + DT_NS_DAYS) * 4 + 3;
+    c  = n / 146097;
+    nc = n % 146097 | 3;
+    p  = (uint64_t)2939745 * nc;
+    z  = (uint32_t)(p >> 32);
+    *np = (uint32_t)p / 2939745 / 4;
+    *yp = 100 * c + z;
+    *lp = z != 0 ? (z & 3) == 0 : (c & 3) == 0;
+}
 
 void
 dt_to_yd(dt_t d, int *yp, int *dp) {
-    int y, n100, n1;
-
-    y = 0;
-#ifndef DT_NO_SHORTCUTS
-    /* Shortcut dates between the years 1901-2099 inclusive */
-    if (d >= DT1901 && d <= DT2099) {
-        d -= DT1901 - 1;
-        y += (4 * d - 1) / 1461;
-        d -= (1461 * y) / 4;
-        y += 1901;
-    }
-    else
-#endif
-    {
-        d -= DT_EPOCH_OFFSET;
-        if (d < 1) {
-            const int n400 = 1 - d/146097;
-            y -= n400 * 400;
-            d += n400 * 146097;
-        }
-        d--;
-        y += 400 * (d / 146097);
-        d %= 146097;
-
-        n100 = d / 36524;
-        y += 100 * n100;
-        d %= 36524;
-
-        y += 4 * (d / 1461);
-        d %= 1461;
-
-        n1 = d / 365;
-        y += n1;
-        d %= 365;
-
-        if (n100 == 4 || n1 == 4)
-            d = 366;
-        else
-            y++, d++;
-    }
-    if (yp) *yp = y;
-    if (dp) *dp = (int)d;
+    uint32_t y, n;
+    int j, l;
+
+    dt_to_computational(d, &y, &n, &l);
+    j = n >= 306;
+    if (yp) *yp = (int)y - DT_NS_YEARS + j;
+    if (dp) *dp = j ? (int)n - 305 : (int)n + 60 + l;
 }
 
 void
 dt_to_ymd(dt_t dt, int *yp, int *mp, int *dp) {
-    int y, doy, m, l;
-
-    dt_to_yd(dt, &y, &doy);
-    l = LEAP_YEAR(y);
-    m = doy < 32 ? 1 : 1 + (5 * (doy - 59 - l) + 303) / 153;
-
-    assert(m >=  1);
-    assert(m <= 12);
-
-    if (yp) *yp = y;
-    if (mp) *mp = m;
-    if (dp) *dp = doy - days_preceding_month[l][m];
+    uint32_t y, n, md;
+    int j, l;
+
+    dt_to_computational(dt, &y, &n, &l);
+    j  = n >= 306;
+    md = 2141 * n + 197913;
+    if (yp) *yp = (int)y - DT_NS_YEARS + j;
+    if (mp) *mp = j ? (int)(md >> 16) - 12 : (int)(md >> 16);
+    if (dp) *dp = (int)((md & 0xFFFF) / 2141) + 1;
 }
 
 void
@@ -180,24 +176,21 @@ dt_to_yqd(dt_t dt, int *yp, int *qp, int *dp) {
 
 void
 dt_to_ywd(dt_t dt, int *yp, int *wp, int *dp) {
-    int y, doy, dow;
+    int y, doy, dow, w;
 
     dt_to_yd(dt, &y, &doy);
     dow = dt_dow(dt);
-    doy = doy + 4 - dow;
-    if (doy < 1) {
+    w = (doy - dow + 10) / 7;
+    if (w < 1) {
         y--;
-        doy += DAYS_IN_YEAR(y);
+        w = DT_YEAR_WEEKS(dt_year_entry(y, NULL));
     }
-    else if (doy > 365) {
-        const int diy = DAYS_IN_YEAR(y);
-        if (doy > diy) {
-            doy -= diy;
-            y++;
-        }
+    else if (w > 52 && w > DT_YEAR_WEEKS(dt_year_entry(y, NULL))) {
+        y++;
+        w = 1;
     }
     if (yp) *yp = y;
-    if (wp) *wp = (doy + 6) / 7;
+    if (wp) *wp = w;
     if (dp) *dp = dow;
 }
 
@@ -24,10 +24,11 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include "dt_core.h"
+#include "dt_year_table.h"
 
 bool
 dt_leap_year(int y) {
-    return ((y & 3) == 0 && (y % 100 != 0 || y % 400 == 0));
+    return DT_YEAR_LEAP(dt_year_entry(y, NULL));
 }
 
 int
@@ -58,12 +59,7 @@ dt_days_in_month(int y, int m) {
 }
 
 int
-dt_weeks_in_year(int year) {
-    unsigned int y, d;
-    if (year < 1)
-        year += 400 * (1 - year/400);
-    y = year - 1;
-    d = (y + y/4 - y/100 + y/400) % 7; /* Mon = 0, ... Sun = 6 */
-    return (d == 3 || (d == 2 && dt_leap_year(year))) ? 53 : 52;
+dt_weeks_in_year(int y) {
+    return DT_YEAR_WEEKS(dt_year_entry(y, NULL));
 }
 
@@ -0,0 +1,109 @@
+/* Generated by dev/gen_year_table.pl, do not edit */
+#ifndef __DT_YEAR_TABLE_H__
+#define __DT_YEAR_TABLE_H__
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Facts of the years 1-400 of the 400-year Gregorian cycle, indexed by
+ * (year - 1) mod 400:
+ *
+ *   bits  0-17  days from the start of the cycle to January 1
+ *   bit     18  leap year
+ *   bits 19-21  day of the week of January 1 (1=Monday, 7=Sunday)
+ *   bit     22  the ISO 8601 week-numbering year has 53 weeks
+ */
+#define DT_YEAR_DAYS(e)     ((int)((e) & 0x3FFFF))
+#define DT_YEAR_LEAP(e)     ((int)(((e) >> 18) & 1))
+#define DT_YEAR_JAN1_DOW(e) ((int)(((e) >> 19) & 7))
+#define DT_YEAR_WEEKS(e)    (52 + (int)(((e) >> 22) & 1))
+
+static const uint32_t dt_year_table[400] = {
+    0x00080000, 0x0010016D, 0x001802DA, 0x00640447, 0x003005B5, 0x00380722,
+    0x0008088F, 0x001409FC, 0x00600B6A, 0x00280CD7, 0x00300E44, 0x003C0FB1,
+    0x0010111F, 0x0018128C, 0x006013F9, 0x002C1566, 0x003816D4, 0x00081841,
+    0x001019AE, 0x005C1B1B, 0x00281C89, 0x00301DF6, 0x00381F63, 0x000C20D0,
+    0x0018223E, 0x006023AB, 0x00282518, 0x00342685, 0x000827F3, 0x00102960,
+    0x00182ACD, 0x00642C3A, 0x00302DA8, 0x00382F15, 0x00083082, 0x001431EF,
+    0x0060335D, 0x002834CA, 0x00303637, 0x003C37A4, 0x00103912, 0x00183A7F,
+    0x00603BEC, 0x002C3D59, 0x00383EC7, 0x00084034, 0x001041A1, 0x005C430E,
+    0x0028447C, 0x003045E9, 0x00384756, 0x000C48C3, 0x00184A31, 0x00604B9E,
+    0x00284D0B, 0x00344E78, 0x00084FE6, 0x00105153, 0x001852C0, 0x0064542D,
+    0x0030559B, 0x00385708, 0x00085875, 0x001459E2, 0x00605B50, 0x00285CBD,
+    0x00305E2A, 0x003C5F97, 0x00106105, 0x00186272, 0x006063DF, 0x002C654C,
+    0x003866BA, 0x00086827, 0x00106994, 0x005C6B01, 0x00286C6F, 0x00306DDC,
+    0x00386F49, 0x000C70B6, 0x00187224, 0x00607391, 0x002874FE, 0x0034766B,
+    0x000877D9, 0x00107946, 0x00187AB3, 0x00647C20, 0x00307D8E, 0x00387EFB,
+    0x00088068, 0x001481D5, 0x00608343, 0x002884B0, 0x0030861D, 0x003C878A,
+    0x001088F8, 0x00188A65, 0x00608BD2, 0x00288D3F, 0x00308EAC, 0x00389019,
+    0x00089186, 0x001492F3, 0x00609461, 0x002895CE, 0x0030973B, 0x003C98A8,
+    0x00109A16, 0x00189B83, 0x00609CF0, 0x002C9E5D, 0x00389FCB, 0x0008A138,
+    0x0010A2A5, 0x005CA412, 0x0028A580, 0x0030A6ED, 0x0038A85A, 0x000CA9C7,
+    0x0018AB35, 0x0060ACA2, 0x0028AE0F, 0x0034AF7C, 0x0008B0EA, 0x0010B257,
+    0x0018B3C4, 0x0064B531, 0x0030B69F, 0x0038B80C, 0x0008B979, 0x0014BAE6,
+    0x0060BC54, 0x0028BDC1, 0x0030BF2E, 0x003CC09B, 0x0010C209, 0x0018C376,
+    0x0060C4E3, 0x002CC650, 0x0038C7BE, 0x0008C92B, 0x0010CA98, 0x005CCC05,
+    0x0028CD73, 0x0030CEE0, 0x0038D04D, 0x000CD1BA, 0x0018D328, 0x0060D495,
+    0x0028D602, 0x0034D76F, 0x0008D8DD, 0x0010DA4A, 0x0018DBB7, 0x0064DD24,
+    0x0030DE92, 0x0038DFFF, 0x0008E16C, 0x0014E2D9, 0x0060E447, 0x0028E5B4,
+    0x0030E721, 0x003CE88E, 0x0010E9FC, 0x0018EB69, 0x0060ECD6, 0x002CEE43,
+    0x0038EFB1, 0x0008F11E, 0x0010F28B, 0x005CF3F8, 0x0028F566, 0x0030F6D3,
+    0x0038F840, 0x000CF9AD, 0x0018FB1B, 0x0060FC88, 0x0028FDF5, 0x0034FF62,
+    0x000900D0, 0x0011023D, 0x001903AA, 0x00650517, 0x00310685, 0x003907F2,
+    0x0009095F, 0x00150ACC, 0x00610C3A, 0x00290DA7, 0x00310F14, 0x003D1081,
+    0x001111EF, 0x0019135C, 0x006114C9, 0x002D1636, 0x003917A4, 0x00091911,
+    0x00111A7E, 0x00191BEB, 0x00611D58, 0x00291EC5, 0x00312032, 0x003D219F,
+    0x0011230D, 0x0019247A, 0x006125E7, 0x002D2754, 0x003928C2, 0x00092A2F,
+    0x00112B9C, 0x005D2D09, 0x00292E77, 0x00312FE4, 0x00393151, 0x000D32BE,
+    0x0019342C, 0x00613599, 0x00293706, 0x00353873, 0x000939E1, 0x00113B4E,
+    0x00193CBB, 0x00653E28, 0x00313F96, 0x00394103, 0x00094270, 0x001543DD,
+    0x0061454B, 0x002946B8, 0x00314825, 0x003D4992, 0x00114B00, 0x00194C6D,
+    0x00614DDA, 0x002D4F47, 0x003950B5, 0x00095222, 0x0011538F, 0x005D54FC,
+    0x0029566A, 0x003157D7, 0x00395944, 0x000D5AB1, 0x00195C1F, 0x00615D8C,
+    0x00295EF9, 0x00356066, 0x000961D4, 0x00116341, 0x001964AE, 0x0065661B,
+    0x00316789, 0x003968F6, 0x00096A63, 0x00156BD0, 0x00616D3E, 0x00296EAB,
+    0x00317018, 0x003D7185, 0x001172F3, 0x00197460, 0x006175CD, 0x002D773A,
+    0x003978A8, 0x00097A15, 0x00117B82, 0x005D7CEF, 0x00297E5D, 0x00317FCA,
+    0x00398137, 0x000D82A4, 0x00198412, 0x0061857F, 0x002986EC, 0x00358859,
+    0x000989C7, 0x00118B34, 0x00198CA1, 0x00658E0E, 0x00318F7C, 0x003990E9,
+    0x00099256, 0x001593C3, 0x00619531, 0x0029969E, 0x0031980B, 0x003D9978,
+    0x00119AE6, 0x00199C53, 0x00619DC0, 0x002D9F2D, 0x0039A09B, 0x0009A208,
+    0x0011A375, 0x005DA4E2, 0x0029A650, 0x0031A7BD, 0x0039A92A, 0x0009AA97,
+    0x0011AC04, 0x0019AD71, 0x0061AEDE, 0x002DB04B, 0x0039B1B9, 0x0009B326,
+    0x0011B493, 0x005DB600, 0x0029B76E, 0x0031B8DB, 0x0039BA48, 0x000DBBB5,
+    0x0019BD23, 0x0061BE90, 0x0029BFFD, 0x0035C16A, 0x0009C2D8, 0x0011C445,
+    0x0019C5B2, 0x0065C71F, 0x0031C88D, 0x0039C9FA, 0x0009CB67, 0x0015CCD4,
+    0x0061CE42, 0x0029CFAF, 0x0031D11C, 0x003DD289, 0x0011D3F7, 0x0019D564,
+    0x0061D6D1, 0x002DD83E, 0x0039D9AC, 0x0009DB19, 0x0011DC86, 0x005DDDF3,
+    0x0029DF61, 0x0031E0CE, 0x0039E23B, 0x000DE3A8, 0x0019E516, 0x0061E683,
+    0x0029E7F0, 0x0035E95D, 0x0009EACB, 0x0011EC38, 0x0019EDA5, 0x0065EF12,
+    0x0031F080, 0x0039F1ED, 0x0009F35A, 0x0015F4C7, 0x0061F635, 0x0029F7A2,
+    0x0031F90F, 0x003DFA7C, 0x0011FBEA, 0x0019FD57, 0x0061FEC4, 0x002E0031,
+    0x003A019F, 0x000A030C, 0x00120479, 0x005E05E6, 0x002A0754, 0x003208C1,
+    0x003A0A2E, 0x000E0B9B, 0x001A0D09, 0x00620E76, 0x002A0FE3, 0x00361150,
+    0x000A12BE, 0x0012142B, 0x001A1598, 0x00661705, 0x00321873, 0x003A19E0,
+    0x000A1B4D, 0x00161CBA, 0x00621E28, 0x002A1F95, 0x00322102, 0x003E226F,
+    0x001223DD, 0x001A254A, 0x006226B7, 0x002E2824, 0x003A2992, 0x000A2AFF,
+    0x00122C6C, 0x005E2DD9, 0x002A2F47, 0x003230B4, 0x003A3221, 0x000E338E,
+    0x001A34FC, 0x00623669, 0x002A37D6, 0x00363943
+};
+
+/* Returns the table entry of the year y and stores the number of whole
+   400-year cycles preceding the year in *cp */
+static uint32_t
+dt_year_entry(int y, int *cp) {
+    unsigned int n, c;
+
+    if (y < 1) {
+        const int n400 = 1 - y/400;
+        uint32_t e = dt_year_entry(y + n400 * 400, cp);
+        if (cp) *cp -= n400;
+        return e;
+    }
+    n = (unsigned int)y - 1;
+    c = n / 400;
+    if (cp) *cp = (int)c;
+    return dt_year_table[n - c * 400];
+}
+
+#endif
@@ -3,105 +3,15 @@
 #define PERL_NO_GET_CONTEXT
 #include "EXTERN.h"
 #include "perl.h"
-#include "dt_core.h"
-
-#ifndef _MSC_VER
-#  include <stdint.h>
-#else
-#  if _MSC_VER >= 1600
-#   include <stdint.h>
-#  else
-    typedef __int32             int32_t;
-    typedef __int64             int64_t;
-    typedef unsigned __int32    uint32_t;
-    typedef unsigned __int64    uint64_t;
-#  endif
-#  ifndef INT64_C
-#   define INT64_C(x) x##i64
-#  endif
-#endif
-
-#define SECS_PER_DAY      86400
-#define NANOS_PER_SEC     1000000000
-
-#define MIN_UNIT_YEARS      INT64_C(-10000)
-#define MAX_UNIT_YEARS      INT64_C(10000)
-#define MIN_UNIT_MONTHS     INT64_C(-120000)
-#define MAX_UNIT_MONTHS     INT64_C(120000)
-#define MIN_UNIT_WEEKS      INT64_C(-521775)
-#define MAX_UNIT_WEEKS      INT64_C(521775)
-#define MIN_UNIT_DAYS       INT64_C(-3652425)
-#define MAX_UNIT_DAYS       INT64_C(3652425)
-#define MIN_UNIT_HOURS      INT64_C(-87658200)
-#define MAX_UNIT_HOURS      INT64_C(87658200)
-#define MIN_UNIT_MINUTES    INT64_C(-5259492000)
-#define MAX_UNIT_MINUTES    INT64_C(5259492000)
-#define MIN_UNIT_SECONDS    INT64_C(-315569520000)
-#define MAX_UNIT_SECONDS    INT64_C(315569520000)
-#define MIN_UNIT_MILLIS     INT64_C(-315569520000000)
-#define MAX_UNIT_MILLIS     INT64_C(315569520000000)
-#define MIN_UNIT_MICROS     INT64_C(-315569520000000000)
-#define MAX_UNIT_MICROS     INT64_C(315569520000000000)
-
-#define MIN_RATA_DIE_DAY    INT64_C(1)            /* 0001-01-01           */
-#define MAX_RATA_DIE_DAY    INT64_C(3652059)      /* 9999-12-31           */
-
-#define MIN_RANGE           INT64_C(86400)        /* 0001-01-01T00:00:00Z */
-#define MAX_RANGE           INT64_C(315537983999) /* 9999-12-31T23:59:59Z */
-#define UNIX_EPOCH          INT64_C(62135683200)  /* 1970-01-01T00:00:00Z */
-#define MIN_EPOCH_SEC       INT64_C(-62135596800) /* 0001-01-01T00:00:00Z */
-#define MAX_EPOCH_SEC       INT64_C(253402300799) /* 9999-12-31T23:59:59Z */
-
-#define VALID_EPOCH_SEC(s) \
-    (s >= MIN_EPOCH_SEC && s <= MAX_EPOCH_SEC)
-
-typedef struct {
-    int64_t sec;
-    int32_t nsec;
-    int32_t offset;
-} moment_t;
-
-typedef struct {
-    int64_t sec;
-    int32_t nsec;
-} moment_duration_t;
-
-typedef enum {
-    MOMENT_UNIT_YEARS=0,
-    MOMENT_UNIT_MONTHS,
-    MOMENT_UNIT_WEEKS,
-    MOMENT_UNIT_DAYS,
-    MOMENT_UNIT_HOURS,
-    MOMENT_UNIT_MINUTES,
-    MOMENT_UNIT_SECONDS,
-    MOMENT_UNIT_MILLIS,
-    MOMENT_UNIT_MICROS,
-    MOMENT_UNIT_NANOS,
-} moment_unit_t;
-
-typedef enum {
-    MOMENT_FIELD_YEAR=0,
-    MOMENT_FIELD_QUARTER_OF_YEAR,
-    MOMENT_FIELD_MONTH_OF_YEAR,
-    MOMENT_FIELD_WEEK_OF_YEAR,
-    MOMENT_FIELD_DAY_OF_YEAR,
-    MOMENT_FIELD_DAY_OF_QUARTER,
-    MOMENT_FIELD_DAY_OF_MONTH,
-    MOMENT_FIELD_DAY_OF_WEEK,
-    MOMENT_FIELD_HOUR_OF_DAY,
-    MOMENT_FIELD_MINUTE_OF_HOUR,
-    MOMENT_FIELD_MINUTE_OF_DAY,
-    MOMENT_FIELD_SECOND_OF_MINUTE,
-    MOMENT_FIELD_SECOND_OF_DAY,
-    MOMENT_FIELD_MILLI_OF_SECOND,
-    MOMENT_FIELD_MILLI_OF_DAY,
-    MOMENT_FIELD_MICRO_OF_SECOND,
-    MOMENT_FIELD_MICRO_OF_DAY,
-    MOMENT_FIELD_NANO_OF_SECOND,
-    MOMENT_FIELD_NANO_OF_DAY,
-    MOMENT_FIELD_PRECISION,
-    MOMENT_FIELD_RATA_DIE_DAY,
-} moment_component_t;
+#include "moment_core.h"
+#include "moment_duration.h"
+#include "moment_interval.h"
+#include "moment_range.h"
+#include "moment_business.h"
+#include "moment_cron.h"
+#include "moment_rrule.h"
+#include "moment_packed.h"
+#include "moment_zonemap.h"
 
 moment_t    THX_moment_new(pTHX_ IV Y, IV M, IV D, IV h, IV m, IV s, IV ns, IV offset);
 moment_t    THX_moment_from_epoch(pTHX_ int64_t sec, IV usec, IV offset);
@@ -121,53 +31,47 @@ moment_t    THX_moment_minus_unit(pTHX_ const moment_t *mt, moment_unit_t u, int
 
 int64_t     THX_moment_delta_unit(pTHX_ const moment_t *mt1, const moment_t *mt2, moment_unit_t u);
 
-int64_t     moment_instant_rd_seconds(const moment_t *mt);
-int64_t     moment_local_rd_seconds(const moment_t *mt);
-
-dt_t        moment_local_dt(const moment_t *mt);
+moment_t    THX_moment_plus_duration(pTHX_ const moment_t *mt, const moment_duration_t *d);
+moment_t    THX_moment_minus_duration(pTHX_ const moment_t *mt, const moment_duration_t *d);
+moment_t    THX_moment_plus_period(pTHX_ const moment_t *mt, const moment_period_t *p);
+moment_t    THX_moment_minus_period(pTHX_ const moment_t *mt, const moment_period_t *p);
+
+moment_duration_t THX_moment_duration_new(pTHX_ int64_t sec, int64_t nsec);
+moment_duration_t THX_moment_duration_from_unit(pTHX_ moment_unit_t u, int64_t v);
+int64_t           THX_moment_duration_to_unit(pTHX_ const moment_duration_t *d, moment_unit_t u);
+moment_duration_t THX_moment_duration_add(pTHX_ const moment_duration_t *d1, const moment_duration_t *d2);
+moment_duration_t THX_moment_duration_subtract(pTHX_ const moment_duration_t *d1, const moment_duration_t *d2);
+moment_duration_t THX_moment_duration_multiply(pTHX_ const moment_duration_t *d, int64_t n);
+
+moment_interval_t THX_moment_interval_new(pTHX_ const moment_t *start, const moment_t *end);
+moment_range_t    THX_moment_range_new(pTHX_ const moment_t *start, const moment_t *end, moment_unit_t u, int64_t step);
+
+size_t      THX_moment_business_size(pTHX_ int from, int to);
+void        THX_moment_business_init(pTHX_ moment_business_t *bc, int from, int to, int weekend, const moment_holiday_t *holidays, size_t nholidays, const int *dates, size_t ndates);
+bool        THX_moment_business_is_business_day(pTHX_ const moment_business_t *bc, int rdn);
+int         THX_moment_business_plus_days(pTHX_ const moment_business_t *bc, int rdn, int64_t n);
+int         THX_moment_business_minus_days(pTHX_ const moment_business_t *bc, int rdn, int64_t n);
+int         THX_moment_business_delta_days(pTHX_ const moment_business_t *bc, int rdn1, int rdn2);
+
+moment_cron_t THX_moment_cron_parse(pTHX_ const char *str, STRLEN len);
+void        THX_moment_rrule_parse(pTHX_ const moment_t *dtstart, const char *str, STRLEN len, moment_rrule_t *r);
+
+size_t      THX_moment_packed_transform(pTHX_ void *buf, size_t n, moment_packed_op_t op, moment_unit_t u, int64_t v, unsigned char *failed);
+size_t      THX_moment_packed_filter(pTHX_ const void *buf, size_t n, moment_packed_t f, const moment_packed_filter_t *flt, unsigned char *bitmap);
+void        THX_moment_packed_fields(pTHX_ const void *buf, size_t n, moment_packed_t f, IV offset, const moment_component_t *fields, size_t nfields, int32_t * const *cols);
+size_t      THX_moment_packed_dedupe(pTHX_ const void *buf, size_t n, moment_packed_t f, IV precision, void *r);
+size_t      THX_moment_packed_asof(pTHX_ const void *left, size_t nl, const void *right, size_t nr, moment_packed_t f, const moment_packed_asof_t *join, int64_t *r);
+void        THX_moment_packed_window(pTHX_ const void *buf, size_t n, moment_packed_t f, moment_unit_t u, int64_t window, int64_t *counts, int64_t *first, int64_t *last);
+
+size_t      THX_moment_zonemap_size(pTHX_ uint64_t elements, int64_t block);
+void        THX_moment_zonemap_check(pTHX_ const void *blob, size_t len);
+void        THX_moment_zonemap_build(pTHX_ const void *buf, size_t n, moment_packed_t f, int64_t block, moment_zonemap_t *zm);
+void        THX_moment_zonemap_extend(pTHX_ const moment_zonemap_t *zm, const void *buf, size_t n, moment_zonemap_t *r);
 
 void        moment_to_instant_rd_values(const moment_t *mt, IV *rdn, IV *sod, IV *nos);
 void        moment_to_local_rd_values(const moment_t *mt, IV *rdn, IV *sod, IV *nos);
 
 int         THX_moment_compare_precision(pTHX_ const moment_t *mt1, const moment_t *mt2, IV precision);
-int         moment_compare_instant(const moment_t *m1, const moment_t *m2);
-int         moment_compare_local(const moment_t *m1, const moment_t *m2);
-bool        moment_equals(const moment_t *m1, const moment_t *m2);
-
-int         moment_year(const moment_t *mt);
-int         moment_quarter(const moment_t *mt);
-int         moment_month(const moment_t *mt);
-int         moment_week(const moment_t *mt);
-int         moment_day_of_year(const moment_t *mt);
-int         moment_day_of_quarter(const moment_t *mt);
-int         moment_day_of_month(const moment_t *mt);
-int         moment_day_of_week(const moment_t *mt);
-int         moment_hour(const moment_t *mt);
-int         moment_minute(const moment_t *mt);
-int         moment_minute_of_day(const moment_t *mt);
-int         moment_second(const moment_t *mt);
-int         moment_second_of_day(const moment_t *mt);
-int         moment_millisecond(const moment_t *mt);
-int         moment_millisecond_of_day(const moment_t *mt);
-int         moment_microsecond(const moment_t *mt);
-int64_t     moment_microsecond_of_day(const moment_t *mt);
-int         moment_nanosecond(const moment_t *mt);
-int64_t     moment_nanosecond_of_day(const moment_t *mt);
-int         moment_offset(const moment_t *mt);
-int64_t     moment_epoch(const moment_t *mt);
-int         moment_precision(const moment_t *mt);
-int         moment_rata_die_day(const moment_t *mt);
-
-bool        moment_is_leap_year(const moment_t *mt);
-
-NV          moment_jd(const moment_t *mt);
-NV          moment_mjd(const moment_t *mt);
-NV          moment_rd(const moment_t *mt);
-
-int         moment_length_of_year(const moment_t *mt);
-int         moment_length_of_quarter(const moment_t *mt);
-int         moment_length_of_month(const moment_t *mt);
-int         moment_length_of_week_year(const moment_t *mt);
 
 moment_t    THX_moment_at_utc(pTHX_ const moment_t *mt);
 moment_t    THX_moment_at_midnight(pTHX_ const moment_t *mt);
@@ -219,6 +123,96 @@ int         THX_moment_internal_orthodox_easter(pTHX_ int64_t y);
 #define moment_delta_unit(self, other, unit) \
     THX_moment_delta_unit(aTHX_ self, other, unit)
 
+#define moment_plus_duration(self, d) \
+    THX_moment_plus_duration(aTHX_ self, d)
+
+#define moment_minus_duration(self, d) \
+    THX_moment_minus_duration(aTHX_ self, d)
+
+#define moment_plus_period(self, p) \
+    THX_moment_plus_period(aTHX_ self, p)
+
+#define moment_minus_period(self, p) \
+    THX_moment_minus_period(aTHX_ self, p)
+
+#define moment_duration_new(sec, nsec) \
+    THX_moment_duration_new(aTHX_ sec, nsec)
+
+#define moment_duration_from_unit(unit, v) \
+    THX_moment_duration_from_unit(aTHX_ unit, v)
+
+#define moment_duration_to_unit(d, unit) \
+    THX_moment_duration_to_unit(aTHX_ d, unit)
+
+#define moment_duration_add(d1, d2) \
+    THX_moment_duration_add(aTHX_ d1, d2)
+
+#define moment_duration_subtract(d1, d2) \
+    THX_moment_duration_subtract(aTHX_ d1, d2)
+
+#define moment_duration_multiply(d, n) \
+    THX_moment_duration_multiply(aTHX_ d, n)
+
+#define moment_interval_new(start, end) \
+    THX_moment_interval_new(aTHX_ start, end)
+
+#define moment_range_new(start, end, unit, step) \
+    THX_moment_range_new(aTHX_ start, end, unit, step)
+
+#define moment_business_size(from, to) \
+    THX_moment_business_size(aTHX_ from, to)
+
+#define moment_business_init(bc, from, to, weekend, holidays, nholidays, dates, ndates) \
+    THX_moment_business_init(aTHX_ bc, from, to, weekend, holidays, nholidays, dates, ndates)
+
+#define moment_business_is_business_day(bc, rdn) \
+    THX_moment_business_is_business_day(aTHX_ bc, rdn)
+
+#define moment_business_plus_days(bc, rdn, n) \
+    THX_moment_business_plus_days(aTHX_ bc, rdn, n)
+
+#define moment_business_minus_days(bc, rdn, n) \
+    THX_moment_business_minus_days(aTHX_ bc, rdn, n)
+
+#define moment_business_delta_days(bc, rdn1, rdn2) \
+    THX_moment_business_delta_days(aTHX_ bc, rdn1, rdn2)
+
+#define moment_cron_parse(str, len) \
+    THX_moment_cron_parse(aTHX_ str, len)
+
+#define moment_rrule_parse(dtstart, str, len, r) \
+    THX_moment_rrule_parse(aTHX_ dtstart, str, len, r)
+
+#define moment_packed_transform(buf, n, op, u, v, failed) \
+    THX_moment_packed_transform(aTHX_ buf, n, op, u, v, failed)
+
+#define moment_packed_filter(buf, n, f, flt, bitmap) \
+    THX_moment_packed_filter(aTHX_ buf, n, f, flt, bitmap)
+
+#define moment_packed_fields(buf, n, f, offset, fields, nfields, cols) \
+    THX_moment_packed_fields(aTHX_ buf, n, f, offset, fields, nfields, cols)
+
+#define moment_packed_dedupe(buf, n, f, precision, r) \
+    THX_moment_packed_dedupe(aTHX_ buf, n, f, precision, r)
+
+#define moment_packed_asof(left, nl, right, nr, f, join, r) \
+    THX_moment_packed_asof(aTHX_ left, nl, right, nr, f, join, r)
+
+#define moment_packed_window(buf, n, f, u, window, counts, first, last) \
+    THX_moment_packed_window(aTHX_ buf, n, f, u, window, counts, first, last)
+
+#define moment_zonemap_size(elements, block) \
+    THX_moment_zonemap_size(aTHX_ elements, block)
+
+#define moment_zonemap_check(blob, len) \
+    THX_moment_zonemap_check(aTHX_ blob, len)
+
+#define moment_zonemap_build(buf, n, f, block, zm) \
+    THX_moment_zonemap_build(aTHX_ buf, n, f, block, zm)
+
+#define moment_zonemap_extend(zm, buf, n, r) \
+    THX_moment_zonemap_extend(aTHX_ zm, buf, n, r)
+
 #define moment_with_field(self, component, v) \
     THX_moment_with_field(aTHX_ self, component, v)
 
@@ -0,0 +1,41 @@
+#ifndef __MOMENT_BITS_H__
+#define __MOMENT_BITS_H__
+#include "moment_core.h"
+
+/*
+ * Bit counting on 64-bit words: the number of set bits, and the index of
+ * the lowest and of the highest set bit. ctz64() and clz64() are
+ * undefined for zero.
+ */
+
+#if defined(__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
+#  define popcount64(x) __builtin_popcountll(x)
+#  define ctz64(x)      __builtin_ctzll(x)
+#  define clz64(x)      __builtin_clzll(x)
+#else
+static int
+popcount64(uint64_t x) {
+    x = x - ((x >> 1) & UINT64_C(0x5555555555555555));
+    x = (x & UINT64_C(0x3333333333333333)) + ((x >> 2) & UINT64_C(0x3333333333333333));
+    x = (x + (x >> 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+    return (int)((x * UINT64_C(0x0101010101010101)) >> 56);
+}
+
+static int
+ctz64(uint64_t x) {
+    int n = 0;
+    while (!(x & 1))
+        x >>= 1, n++;
+    return n;
+}
+
+static int
+clz64(uint64_t x) {
+    int n = 0;
+    while (!(x & (UINT64_C(1) << 63)))
+        x <<= 1, n++;
+    return n;
+}
+#endif
+
+#endif
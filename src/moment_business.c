@@ -0,0 +1,297 @@
+#include <string.h>
+#include "moment_business.h"
+#include "moment_bits.h"
+#include "dt_core.h"
+#include "dt_valid.h"
+
+#define CHECK(expr) do {                    \
+    const moment_status_t status_ = (expr); \
+    if (status_ != MOMENT_OK)               \
+        return status_;                     \
+} while (0)
+
+static uint64_t *
+business_bits(const moment_business_t *bc) {
+    return (uint64_t *)(bc + 1);
+}
+
+/* rank[i] is the number of business days preceding word i */
+static uint32_t *
+business_rank(const moment_business_t *bc) {
+    return (uint32_t *)(business_bits(bc) + bc->words);
+}
+
+static int
+business_words(int days) {
+    return (days + 63) / 64;
+}
+
+static moment_status_t
+check_years(int from, int to) {
+    if (from < 1 || from > 9999 || to < 1 || to > 9999)
+        return MOMENT_ERR_PARAM_YEAR;
+    if (from > to)
+        return MOMENT_ERR_BUSINESS_YEARS;
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_business_size(int from, int to, size_t *r) {
+    int days, words;
+
+    CHECK(check_years(from, to));
+    days  = dt_from_ymd(to + 1, 1, 1) - dt_from_ymd(from, 1, 1);
+    words = business_words(days);
+    *r = sizeof(moment_business_t)
+       + words * sizeof(uint64_t)
+       + (words + 1) * sizeof(uint32_t);
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_holiday_check(const moment_holiday_t *h) {
+    if (h->month == 0) {
+        if (h->day != 0 || h->day_of_week != 0)
+            return MOMENT_ERR_HOLIDAY_RULE;
+        if (h->easter < -365 || h->easter > 365)
+            return MOMENT_ERR_PARAM_EASTER;
+    }
+    else {
+        if (h->month < 1 || h->month > 12)
+            return MOMENT_ERR_PARAM_MONTH;
+        if (h->easter != 0)
+            return MOMENT_ERR_HOLIDAY_RULE;
+        if (h->day == 0 && h->day_of_week == 0)
+            return MOMENT_ERR_HOLIDAY_RULE;
+        if (h->day < 0 || h->day > 31)
+            return MOMENT_ERR_PARAM_DAY_OF_MONTH;
+        if (h->day_of_week < 0 || h->day_of_week > 7)
+            return MOMENT_ERR_PARAM_DAY_OF_WEEK;
+        if (h->day_of_week != 0 && (h->ordinal < -4 || h->ordinal > 4 || h->ordinal == 0))
+            return MOMENT_ERR_PARAM_ORDINAL;
+    }
+    if (h->from > h->to)
+        return MOMENT_ERR_BUSINESS_YEARS;
+    return MOMENT_OK;
+}
+
+/* Returns the date of the holiday in the year y, or 0 if it has none */
+static dt_t
+holiday_date(const moment_holiday_t *h, int y) {
+    dt_t dt;
+
+    if (h->month == 0)
+        return dt_from_easter(y, (dt_computus_t)h->computus) + h->easter;
+
+    if (h->day_of_week == 0) {
+        /* February 29 is only kept in leap years */
+        if (!dt_valid_ymd(y, h->month, h->day))
+            return 0;
+        return dt_from_ymd(y, h->month, h->day);
+    }
+
+    if (h->day != 0) {
+        if (!dt_valid_ymd(y, h->month, h->day))
+            return 0;
+        dt = dt_from_ymd(y, h->month, h->day);
+    }
+    else if (h->ordinal > 0)
+        dt = dt_from_ymd(y, h->month, 1);
+    else
+        dt = dt_from_ymd(y, h->month + 1, 0);
+
+    if (h->ordinal > 0)
+        return dt + (h->day_of_week - dt_dow(dt) + 7) % 7 + 7 * (h->ordinal - 1);
+    else
+        return dt - (dt_dow(dt) - h->day_of_week + 7) % 7 + 7 * (h->ordinal + 1);
+}
+
+static bool
+is_weekend(int weekend, dt_t dt) {
+    return (weekend >> dt_dow(dt)) & 1;
+}
+
+static dt_t
+observed_date(int observed, int weekend, dt_t dt) {
+    int i;
+
+    if (observed == MOMENT_OBSERVED_NONE || !is_weekend(weekend, dt))
+        return dt;
+    for (i = 1; i < 7; i++) {
+        switch (observed) {
+            case MOMENT_OBSERVED_NEAREST:
+                if (!is_weekend(weekend, dt - i))
+                    return dt - i;
+                /* FALLTHROUGH */
+            case MOMENT_OBSERVED_NEXT:
+                if (!is_weekend(weekend, dt + i))
+                    return dt + i;
+                break;
+            case MOMENT_OBSERVED_PREVIOUS:
+                if (!is_weekend(weekend, dt - i))
+                    return dt - i;
+                break;
+        }
+    }
+    return dt;
+}
+
+static void
+business_clear(moment_business_t *bc, int rdn) {
+    const int i = rdn - bc->first;
+
+    if (i >= 0 && i < bc->days)
+        business_bits(bc)[i >> 6] &= ~(UINT64_C(1) << (i & 63));
+}
+
+moment_status_t
+moment_core_business_init(moment_business_t *bc, int from, int to, int weekend,
+                          const moment_holiday_t *holidays, size_t nholidays,
+                          const int *dates, size_t ndates) {
+    uint64_t *bits;
+    uint32_t *rank;
+    uint64_t pattern[7];
+    size_t i;
+    int d, y, words;
+
+    CHECK(check_years(from, to));
+    for (i = 0; i < nholidays; i++)
+        CHECK(moment_core_holiday_check(&holidays[i]));
+
+    bc->first   = dt_rdn(dt_from_ymd(from, 1, 1));
+    bc->days    = dt_rdn(dt_from_ymd(to + 1, 1, 1)) - bc->first;
+    bc->words   = words = business_words(bc->days);
+    bc->weekend = weekend & 0xFE;
+
+    bits = business_bits(bc);
+    rank = business_rank(bc);
+
+    /* The weekdays repeat every seven words, as 64 days is 1 mod 7 */
+    for (i = 0; i < 7; i++) {
+        const dt_t dt = dt_from_rdn(bc->first + (int)i * 64);
+        pattern[i] = 0;
+        for (d = 0; d < 64; d++) {
+            if (!is_weekend(bc->weekend, dt + d))
+                pattern[i] |= UINT64_C(1) << d;
+        }
+    }
+    for (d = 0; d < words; d++)
+        bits[d] = pattern[d % 7];
+    if (bc->days & 63)
+        bits[words - 1] &= (UINT64_C(1) << (bc->days & 63)) - 1;
+
+    for (i = 0; i < nholidays; i++) {
+        const moment_holiday_t *h = &holidays[i];
+        const int y1 = h->from > from ? h->from : from;
+        const int y2 = h->to < to ? h->to : to;
+
+        /* A holiday observed on another day may cross into the adjacent year */
+        for (y = y1 - (y1 > 1); y <= y2 + (y2 < 9999); y++) {
+            dt_t dt;
+
+            if (y < h->from || y > h->to)
+                continue;
+            dt = holiday_date(h, y);
+            if (dt > 0)
+                business_clear(bc, dt_rdn(observed_date(h->observed, bc->weekend, dt)));
+        }
+    }
+    for (i = 0; i < ndates; i++)
+        business_clear(bc, dates[i]);
+
+    rank[0] = 0;
+    for (d = 0; d < words; d++)
+        rank[d + 1] = rank[d] + popcount64(bits[d]);
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_day(const moment_business_t *bc, int rdn) {
+    if (rdn < bc->first || rdn - bc->first >= bc->days)
+        return MOMENT_ERR_BUSINESS_RANGE;
+    return MOMENT_OK;
+}
+
+/* Returns the number of business days preceding the i-th day of the calendar */
+static int
+business_count(const moment_business_t *bc, int i) {
+    const int w = i >> 6;
+    const int b = i & 63;
+    int n = (int)business_rank(bc)[w];
+
+    if (b)
+        n += popcount64(business_bits(bc)[w] & ((UINT64_C(1) << b) - 1));
+    return n;
+}
+
+/* Returns the day of the calendar that is the k-th business day, counted from zero */
+static int
+business_select(const moment_business_t *bc, int k) {
+    const uint32_t *rank = business_rank(bc);
+    uint64_t word;
+    int lo = 0, hi = bc->words;
+
+    /* The last word whose preceding count is k or less */
+    while (hi - lo > 1) {
+        const int mid = lo + (hi - lo) / 2;
+        if ((int)rank[mid] <= k)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    word = business_bits(bc)[lo];
+    for (k -= (int)rank[lo]; k > 0; k--)
+        word &= word - 1;
+    return lo * 64 + ctz64(word);
+}
+
+moment_status_t
+moment_core_business_is_business_day(const moment_business_t *bc, int rdn, bool *r) {
+    int i;
+
+    CHECK(check_day(bc, rdn));
+    i = rdn - bc->first;
+    *r = (business_bits(bc)[i >> 6] >> (i & 63)) & 1;
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_business_plus_days(const moment_business_t *bc, int rdn, int64_t n, int *r) {
+    const int total = (int)business_rank(bc)[bc->words];
+    int64_t k;
+    int i;
+
+    CHECK(check_day(bc, rdn));
+    if (n == 0) {
+        *r = rdn;
+        return MOMENT_OK;
+    }
+    /* No step can cross more business days than the calendar has */
+    if (n > total || n < -total)
+        return MOMENT_ERR_BUSINESS_RANGE;
+    i = rdn - bc->first;
+    if (n > 0)
+        k = business_count(bc, i + 1) + n - 1;
+    else
+        k = business_count(bc, i) + n;
+    if (k < 0 || k >= total)
+        return MOMENT_ERR_BUSINESS_RANGE;
+    *r = bc->first + business_select(bc, (int)k);
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_business_minus_days(const moment_business_t *bc, int rdn, int64_t n, int *r) {
+    if (n == INT64_MIN)
+        return MOMENT_ERR_BUSINESS_RANGE;
+    return moment_core_business_plus_days(bc, rdn, -n, r);
+}
+
+/* Stores the number of business days in [rdn1, rdn2), negated if rdn2 precedes rdn1 */
+moment_status_t
+moment_core_business_delta_days(const moment_business_t *bc, int rdn1, int rdn2, int *r) {
+    CHECK(check_day(bc, rdn1));
+    CHECK(check_day(bc, rdn2));
+    *r = business_count(bc, rdn2 - bc->first) - business_count(bc, rdn1 - bc->first);
+    return MOMENT_OK;
+}
@@ -0,0 +1,74 @@
+#ifndef __MOMENT_BUSINESS_H__
+#define __MOMENT_BUSINESS_H__
+#include "moment_core.h"
+#include "dt_easter.h"
+
+/*
+ * Business day calendars over the rata die days of a range of years.
+ *
+ * A calendar is a single block of memory: the header below, followed by a
+ * bitset with one bit per day, set for business days, and the number of
+ * business days preceding each 64-bit word of the bitset. The block has
+ * no pointers, so it can be copied and stored as is; its size is given by
+ * moment_core_business_size().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MOMENT_OBSERVED_NONE=0,
+    MOMENT_OBSERVED_NEAREST,
+    MOMENT_OBSERVED_NEXT,
+    MOMENT_OBSERVED_PREVIOUS,
+} moment_observed_t;
+
+/*
+ * A yearly holiday, one of:
+ *
+ *   month and day                  a fixed date
+ *   month, day_of_week, ordinal    the ordinal-th day of the week of the
+ *                                  month, counted from its last day if the
+ *                                  ordinal is negative
+ *   month, day, day_of_week,       the ordinal-th day of the week on or
+ *   ordinal                        after the date, or on or before it if
+ *                                  the ordinal is negative
+ *   month = 0, easter              days relative to Easter Sunday
+ *
+ * A holiday that falls on a weekend day may be observed on a weekday.
+ */
+typedef struct {
+    int month;
+    int day;
+    int day_of_week;
+    int ordinal;
+    int easter;
+    int computus;       /* dt_computus_t */
+    int observed;       /* moment_observed_t */
+    int from;           /* the years in which the holiday is kept */
+    int to;
+} moment_holiday_t;
+
+typedef struct {
+    int32_t first;      /* rata die day of the first day */
+    int32_t days;
+    int32_t words;
+    int32_t weekend;    /* bit n is set if day of the week n is a weekend day */
+} moment_business_t;
+
+moment_status_t moment_core_business_size(int from, int to, size_t *r);
+moment_status_t moment_core_holiday_check(const moment_holiday_t *h);
+moment_status_t moment_core_business_init(moment_business_t *bc, int from, int to, int weekend,
+                                          const moment_holiday_t *holidays, size_t nholidays,
+                                          const int *dates, size_t ndates);
+
+moment_status_t moment_core_business_is_business_day(const moment_business_t *bc, int rdn, bool *r);
+moment_status_t moment_core_business_plus_days(const moment_business_t *bc, int rdn, int64_t n, int *r);
+moment_status_t moment_core_business_minus_days(const moment_business_t *bc, int rdn, int64_t n, int *r);
+moment_status_t moment_core_business_delta_days(const moment_business_t *bc, int rdn1, int rdn2, int *r);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,1527 @@
+#include <math.h>
+#include <string.h>
+#include "moment_core.h"
+#include "moment_duration.h"
+#include "dt_core.h"
+#include "dt_accessor.h"
+#include "dt_arithmetic.h"
+#include "dt_util.h"
+#include "dt_length.h"
+#include "dt_easter.h"
+
+#define CHECK(expr) do {                    \
+    const moment_status_t status_ = (expr); \
+    if (status_ != MOMENT_OK)               \
+        return status_;                     \
+} while (0)
+
+static const int32_t kPow10[10] = {
+    1,
+    10,
+    100,
+    1000,
+    10000,
+    100000,
+    1000000,
+    10000000,
+    100000000,
+    1000000000,
+};
+
+const char *
+moment_status_message(moment_status_t status) {
+    switch (status) {
+        case MOMENT_OK:
+            return "No error";
+        case MOMENT_ERR_RANGE:
+            return "Time::Moment is out of range";
+        case MOMENT_ERR_PARSE:
+            return "Could not parse the given string";
+        case MOMENT_ERR_PARAM_YEAR:
+            return "Parameter 'year' is out of the range [1, 9999]";
+        case MOMENT_ERR_PARAM_QUARTER:
+            return "Parameter 'quarter' is out of the range [1, 4]";
+        case MOMENT_ERR_PARAM_MONTH:
+            return "Parameter 'month' is out of the range [1, 12]";
+        case MOMENT_ERR_PARAM_WEEK:
+            return "Parameter 'week' is out of the range [1, 53]";
+        case MOMENT_ERR_PARAM_DAY_OF_YEAR:
+            return "Parameter 'day' is out of the range [1, 366]";
+        case MOMENT_ERR_PARAM_DAY_OF_QUARTER:
+            return "Parameter 'day' is out of the range [1, 92]";
+        case MOMENT_ERR_PARAM_DAY_OF_MONTH:
+            return "Parameter 'day' is out of the range [1, 31]";
+        case MOMENT_ERR_PARAM_DAY_OF_WEEK:
+            return "Parameter 'day' is out of the range [1, 7]";
+        case MOMENT_ERR_PARAM_HOUR:
+            return "Parameter 'hour' is out of the range [1, 23]";
+        case MOMENT_ERR_PARAM_MINUTE:
+            return "Parameter 'minute' is out of the range [1, 59]";
+        case MOMENT_ERR_PARAM_MINUTE_OF_DAY:
+            return "Parameter 'minute' is out of the range [1, 1439]";
+        case MOMENT_ERR_PARAM_SECOND:
+            return "Parameter 'second' is out of the range [1, 59]";
+        case MOMENT_ERR_PARAM_SECOND_OF_DAY:
+            return "Parameter 'second' is out of the range [0, 86_399]";
+        case MOMENT_ERR_PARAM_MILLISECOND:
+            return "Parameter 'millisecond' is out of the range [0, 999]";
+        case MOMENT_ERR_PARAM_MILLISECOND_OF_DAY:
+            return "Parameter 'millisecond' is out of the range [0, 86_400_000]";
+        case MOMENT_ERR_PARAM_MICROSECOND:
+            return "Parameter 'microsecond' is out of the range [0, 999_999]";
+        case MOMENT_ERR_PARAM_MICROSECOND_OF_DAY:
+            return "Parameter 'microsecond' is out of the range [0, 86_400_000_000]";
+        case MOMENT_ERR_PARAM_NANOSECOND:
+            return "Parameter 'nanosecond' is out of the range [0, 999_999_999]";
+        case MOMENT_ERR_PARAM_NANOSECOND_OF_DAY:
+            return "Parameter 'nanosecond' is out of the range [0, 86_400_000_000_000]";
+        case MOMENT_ERR_PARAM_OFFSET:
+            return "Parameter 'offset' is out of the range [-1080, 1080]";
+        case MOMENT_ERR_PARAM_PRECISION:
+            return "Parameter 'precision' is out of the range [-3, 9]";
+        case MOMENT_ERR_PARAM_FRACTION_PRECISION:
+            return "Parameter 'precision' is out of the range [0, 9]";
+        case MOMENT_ERR_PARAM_RATA_DIE_DAY:
+            return "Parameter 'rdn' is out of range";
+        case MOMENT_ERR_PARAM_EPOCH:
+            return "Parameter 'epoch' is out of range";
+        case MOMENT_ERR_PARAM_RD:
+            return "Parameter 'rd' is out of range";
+        case MOMENT_ERR_PARAM_JD:
+            return "Parameter 'jd' is out of range";
+        case MOMENT_ERR_PARAM_MJD:
+            return "Parameter 'mjd' is out of range";
+        case MOMENT_ERR_PARAM_YEARS:
+            return "Parameter 'years' is out of range";
+        case MOMENT_ERR_PARAM_MONTHS:
+            return "Parameter 'months' is out of range";
+        case MOMENT_ERR_PARAM_WEEKS:
+            return "Parameter 'weeks' is out of range";
+        case MOMENT_ERR_PARAM_DAYS:
+            return "Parameter 'days' is out of range";
+        case MOMENT_ERR_PARAM_HOURS:
+            return "Parameter 'hours' is out of range";
+        case MOMENT_ERR_PARAM_MINUTES:
+            return "Parameter 'minutes' is out of range";
+        case MOMENT_ERR_PARAM_SECONDS:
+            return "Parameter 'seconds' is out of range";
+        case MOMENT_ERR_PARAM_MILLISECONDS:
+            return "Parameter 'milliseconds' is out of range";
+        case MOMENT_ERR_PARAM_MICROSECONDS:
+            return "Parameter 'microseconds' is out of range";
+        case MOMENT_ERR_WEEK_OF_YEAR:
+            return "Parameter 'week' is out of range for the week year";
+        case MOMENT_ERR_DAY_OF_YEAR:
+            return "Parameter 'day' is out of range for the year";
+        case MOMENT_ERR_DAY_OF_QUARTER:
+            return "Parameter 'day' is out of range for the quarter";
+        case MOMENT_ERR_DAY_OF_MONTH:
+            return "Parameter 'day' is out of range for the month";
+        case MOMENT_ERR_RD_RANGE:
+            return "Rata Die is out of range";
+        case MOMENT_ERR_JD_RANGE:
+            return "Julian date is out of range";
+        case MOMENT_ERR_MJD_RANGE:
+            return "Modified Julian date is out of range";
+        case MOMENT_ERR_NANOS_OVERFLOW:
+            return "Nanosecond duration is too large to be represented in a 64-bit integer";
+        case MOMENT_ERR_UNIT:
+            return "Unknown unit";
+        case MOMENT_ERR_COMPONENT:
+            return "Unknown component";
+        case MOMENT_ERR_DURATION_RANGE:
+            return "Time::Moment::Duration is out of range";
+        case MOMENT_ERR_DURATION_NOMINAL:
+            return "Duration with years or months cannot be represented as an exact duration";
+        case MOMENT_ERR_INTERVAL_ANCHOR:
+            return "Interval consists of only a duration and has no start or end";
+        case MOMENT_ERR_INTERVAL_ORDER:
+            return "Interval end precedes its start";
+        case MOMENT_ERR_PARAM_STEP:
+            return "Parameter 'step' is out of range";
+        case MOMENT_ERR_PARAM_ORDINAL:
+            return "Parameter 'ordinal' is out of the range [-4, -1] or [1, 4]";
+        case MOMENT_ERR_PARAM_EASTER:
+            return "Parameter 'easter' is out of the range [-365, 365]";
+        case MOMENT_ERR_HOLIDAY_RULE:
+            return "Holiday must have a month and a day or day of the week, or only an offset from Easter";
+        case MOMENT_ERR_BUSINESS_YEARS:
+            return "Parameter 'to' precedes parameter 'from'";
+        case MOMENT_ERR_BUSINESS_RANGE:
+            return "Date is outside the range of the business calendar";
+        case MOMENT_ERR_CRON_SYNTAX:
+            return "Could not parse the given cron expression";
+        case MOMENT_ERR_CRON_NEVER:
+            return "Cron expression does not match any date";
+        case MOMENT_ERR_RRULE_SYNTAX:
+            return "Could not parse the given recurrence rule";
+        case MOMENT_ERR_RRULE_UNSUPPORTED:
+            return "Recurrence rule part is not supported";
+        case MOMENT_ERR_PACKED_FIELD:
+            return "Field does not fit in a 32-bit column";
+        case MOMENT_ERR_ZONEMAP_BLOCK:
+            return "Parameter 'block_size' is out of the range [1, 2147483647]";
+        case MOMENT_ERR_ZONEMAP_INVALID:
+            return "Zone map is invalid or was built on a different platform";
+        case MOMENT_ERR_ZONEMAP_SHRUNK:
+            return "Buffer has fewer elements than the zone map";
+        case MOMENT_ERR_PARAM_TOLERANCE:
+            return "Parameter 'tolerance' is out of range";
+        case MOMENT_ERR_PARAM_WINDOW:
+            return "Parameter 'window' is out of range";
+    }
+    return "Unknown error";
+}
+
+static moment_status_t
+moment_from_local(int64_t sec, int64_t nsec, int64_t offset, moment_t *r) {
+    if (sec < MIN_RANGE || sec > MAX_RANGE)
+        return MOMENT_ERR_RANGE;
+    r->sec    = sec;
+    r->nsec   = (int32_t)nsec;
+    r->offset = (int32_t)offset;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+moment_from_instant(int64_t sec, int64_t nsec, int64_t offset, moment_t *r) {
+    return moment_from_local(sec + offset * 60, nsec, offset, r);
+}
+
+int64_t
+moment_instant_rd_seconds(const moment_t *mt) {
+    return mt->sec - mt->offset * 60;
+}
+
+int
+moment_instant_rd(const moment_t *mt) {
+    return (int)(moment_instant_rd_seconds(mt) / SECS_PER_DAY);
+}
+
+int64_t
+moment_local_rd_seconds(const moment_t *mt) {
+    return mt->sec;
+}
+
+int
+moment_local_rd(const moment_t *mt) {
+    return (int)(moment_local_rd_seconds(mt) / SECS_PER_DAY);
+}
+
+dt_t
+moment_local_dt(const moment_t *mt) {
+    return dt_from_rdn(moment_local_rd(mt));
+}
+
+static moment_status_t
+check_year(int64_t v) {
+    if (v < 1 || v > 9999)
+        return MOMENT_ERR_PARAM_YEAR;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_quarter(int64_t v) {
+    if (v < 1 || v > 4)
+        return MOMENT_ERR_PARAM_QUARTER;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_month(int64_t v) {
+    if (v < 1 || v > 12)
+        return MOMENT_ERR_PARAM_MONTH;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_week(int64_t v) {
+    if (v < 1 || v > 53)
+        return MOMENT_ERR_PARAM_WEEK;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_day_of_year(int64_t v) {
+    if (v < 1 || v > 366)
+        return MOMENT_ERR_PARAM_DAY_OF_YEAR;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_day_of_quarter(int64_t v) {
+    if (v < 1 || v > 92)
+        return MOMENT_ERR_PARAM_DAY_OF_QUARTER;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_day_of_month(int64_t v) {
+    if (v < 1 || v > 31)
+        return MOMENT_ERR_PARAM_DAY_OF_MONTH;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_day_of_week(int64_t v) {
+    if (v < 1 || v > 7)
+        return MOMENT_ERR_PARAM_DAY_OF_WEEK;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_hour(int64_t v) {
+    if (v < 0 || v > 23)
+        return MOMENT_ERR_PARAM_HOUR;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_minute(int64_t v) {
+    if (v < 0 || v > 59)
+        return MOMENT_ERR_PARAM_MINUTE;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_minute_of_day(int64_t v) {
+    if (v < 0 || v > 1439)
+        return MOMENT_ERR_PARAM_MINUTE_OF_DAY;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_second(int64_t v) {
+    if (v < 0 || v > 59)
+        return MOMENT_ERR_PARAM_SECOND;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_second_of_day(int64_t v) {
+    if (v < 0 || v > 86399)
+        return MOMENT_ERR_PARAM_SECOND_OF_DAY;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_millisecond(int64_t v) {
+    if (v < 0 || v > 999)
+        return MOMENT_ERR_PARAM_MILLISECOND;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_microsecond(int64_t v) {
+    if (v < 0 || v > 999999)
+        return MOMENT_ERR_PARAM_MICROSECOND;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_nanosecond(int64_t v) {
+    if (v < 0 || v > 999999999)
+        return MOMENT_ERR_PARAM_NANOSECOND;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_offset(int64_t v) {
+    if (v < -1080 || v > 1080)
+        return MOMENT_ERR_PARAM_OFFSET;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_epoch_seconds(int64_t v) {
+    if (!VALID_EPOCH_SEC(v))
+        return MOMENT_ERR_PARAM_SECONDS;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_rata_die_day(int64_t v) {
+    if (v < MIN_RATA_DIE_DAY || v > MAX_RATA_DIE_DAY)
+        return MOMENT_ERR_PARAM_RATA_DIE_DAY;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_years(int64_t v) {
+    if (v < MIN_UNIT_YEARS || v > MAX_UNIT_YEARS)
+        return MOMENT_ERR_PARAM_YEARS;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_months(int64_t v) {
+    if (v < MIN_UNIT_MONTHS || v > MAX_UNIT_MONTHS)
+        return MOMENT_ERR_PARAM_MONTHS;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_weeks(int64_t v) {
+    if (v < MIN_UNIT_WEEKS || v > MAX_UNIT_WEEKS)
+        return MOMENT_ERR_PARAM_WEEKS;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_days(int64_t v) {
+    if (v < MIN_UNIT_DAYS || v > MAX_UNIT_DAYS)
+        return MOMENT_ERR_PARAM_DAYS;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_hours(int64_t v) {
+    if (v < MIN_UNIT_HOURS || v > MAX_UNIT_HOURS)
+        return MOMENT_ERR_PARAM_HOURS;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_minutes(int64_t v) {
+    if (v < MIN_UNIT_MINUTES || v > MAX_UNIT_MINUTES)
+        return MOMENT_ERR_PARAM_MINUTES;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_seconds(int64_t v) {
+    if (v < MIN_UNIT_SECONDS || v > MAX_UNIT_SECONDS)
+        return MOMENT_ERR_PARAM_SECONDS;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_milliseconds(int64_t v) {
+    if (v < MIN_UNIT_MILLIS || v > MAX_UNIT_MILLIS)
+        return MOMENT_ERR_PARAM_MILLISECONDS;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit_microseconds(int64_t v) {
+    if (v < MIN_UNIT_MICROS || v > MAX_UNIT_MICROS)
+        return MOMENT_ERR_PARAM_MICROSECONDS;
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_from_epoch(int64_t sec, int64_t nsec, int64_t offset, moment_t *r) {
+
+    CHECK(check_epoch_seconds(sec));
+    CHECK(check_nanosecond(nsec));
+    CHECK(check_offset(offset));
+
+    sec += UNIX_EPOCH;
+    return moment_from_instant(sec, nsec, offset, r);
+}
+
+moment_status_t
+moment_core_from_epoch_nv(double sec, int64_t precision, moment_t *r) {
+    static const double SEC_MIN = -62135596801.0; /*  0000-12-31T23:59:59Z */
+    static const double SEC_MAX = 253402300800.0; /* 10000-01-01T00:00:00Z */
+    double s, f, n, denom;
+    int64_t isec, nsec;
+
+    if (precision < 0 || precision > 9)
+        return MOMENT_ERR_PARAM_FRACTION_PRECISION;
+
+    if (!(sec > SEC_MIN && sec < SEC_MAX))
+        return MOMENT_ERR_PARAM_SECONDS;
+
+    f = n = fmod(sec, 1.0);
+    s = floor(sec - f);
+    if (n < 0)
+        n += 1.0;
+    s = s + floor(f - n);
+    denom = pow(10.0, (double)precision);
+    n = (floor(n * denom + 0.5) / denom) * 1E9;
+
+    isec = (int64_t)s;
+    nsec = (int64_t)(n + 0.5);
+
+    if (nsec >= NANOS_PER_SEC) {
+        nsec -= NANOS_PER_SEC;
+        isec += 1;
+    }
+    return moment_core_from_epoch(isec, nsec, 0, r);
+}
+
+static int
+moment_from_sd(double sd, double epoch, int64_t precision, int64_t *sec, int32_t *nsec) {
+    static const double SD_MIN = -146097 * 50;
+    static const double SD_MAX =  146097 * 50;
+    double d1, d2, f1, f2, f, d, s, denom;
+
+    if (precision < 0 || precision > 9)
+        return -3;
+
+    if (!(sd > SD_MIN && sd < SD_MAX))
+        return -1;
+
+    if (!(epoch > SD_MIN && epoch < SD_MAX))
+        return -4;
+
+    if (sd >= epoch) {
+        d1 = sd;
+        d2 = epoch;
+    }
+    else {
+        d1 = epoch;
+        d2 = sd;
+    }
+
+    f1 = fmod(d1, 1.0);
+    f2 = fmod(d2, 1.0);
+    d1 = floor(d1 - f1);
+    d2 = floor(d2 - f2);
+
+    f = fmod(f1 + f2, 1.0);
+    if (f < 0.0)
+        f += 1.0;
+
+    d = d1 + d2 + floor(f1 + f2 - f);
+    f *= 86400;
+    s = floor(f);
+
+    if (d < 1 || d > 3652059)
+        return -2;
+
+    denom = pow(10.0, (double)precision);
+    f = (floor((f - s) * denom + 0.5) / denom) * 1E9;
+
+    *sec = (int64_t)d * 86400 + (int32_t)s;
+    *nsec = (int32_t)(f + 0.5);
+
+    if (*nsec >= NANOS_PER_SEC) {
+        *nsec -= NANOS_PER_SEC;
+        *sec += 1;
+    }
+    return 0;
+}
+
+static moment_status_t
+moment_sd_status(int r, moment_status_t param, moment_status_t range) {
+    switch (r) {
+        case -1: return param;
+        case -2: return range;
+        case -3: return MOMENT_ERR_PARAM_FRACTION_PRECISION;
+        case -4: return MOMENT_ERR_PARAM_EPOCH;
+    }
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_from_rd(double rd, double epoch, int64_t precision, int64_t offset, moment_t *r) {
+    int64_t sec;
+    int32_t nsec;
+
+    CHECK(check_offset(offset));
+    CHECK(moment_sd_status(moment_from_sd(rd, epoch, precision, &sec, &nsec),
+                           MOMENT_ERR_PARAM_RD, MOMENT_ERR_RD_RANGE));
+    return moment_from_local(sec, nsec, offset, r);
+}
+
+moment_status_t
+moment_core_from_jd(double jd, double epoch, int64_t precision, moment_t *r) {
+    int64_t sec;
+    int32_t nsec;
+
+    CHECK(moment_sd_status(moment_from_sd(jd, epoch, precision, &sec, &nsec),
+                           MOMENT_ERR_PARAM_JD, MOMENT_ERR_JD_RANGE));
+    return moment_from_instant(sec, nsec, 0, r);
+}
+
+moment_status_t
+moment_core_from_mjd(double mjd, double epoch, int64_t precision, moment_t *r) {
+    int64_t sec;
+    int32_t nsec;
+
+    CHECK(moment_sd_status(moment_from_sd(mjd, epoch, precision, &sec, &nsec),
+                           MOMENT_ERR_PARAM_MJD, MOMENT_ERR_MJD_RANGE));
+    return moment_from_instant(sec, nsec, 0, r);
+}
+
+moment_status_t
+moment_core_new(int64_t Y, int64_t M, int64_t D, int64_t h, int64_t m, int64_t s, int64_t nsec, int64_t offset, moment_t *r) {
+    int64_t rdn, sec;
+
+    CHECK(check_year(Y));
+    CHECK(check_month(M));
+    CHECK(check_day_of_month(D));
+    if (D > 28 && D > dt_days_in_month((int)Y, (int)M))
+        return MOMENT_ERR_DAY_OF_MONTH;
+    CHECK(check_hour(h));
+    CHECK(check_minute(m));
+    CHECK(check_second(s));
+    CHECK(check_nanosecond(nsec));
+    CHECK(check_offset(offset));
+
+    rdn = dt_rdn(dt_from_ymd((int)Y, (int)M, (int)D));
+    sec = ((rdn * 24 + h) * 60 + m) * 60 + s;
+    return moment_from_local(sec, nsec, offset, r);
+}
+
+static moment_status_t
+moment_with_local_dt(const moment_t *mt, const dt_t dt, moment_t *r) {
+    int64_t sec;
+
+    sec = (int64_t)dt_rdn(dt) * 86400 + moment_second_of_day(mt);
+    return moment_from_local(sec, mt->nsec, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_ymd(const moment_t *mt, int y, int m, int d, moment_t *r) {
+
+    if (d > 28) {
+        int dim = dt_days_in_month(y, m);
+        if (d > dim)
+            d = dim;
+    }
+    return moment_with_local_dt(mt, dt_from_ymd(y, m, d), r);
+}
+
+static moment_status_t
+moment_with_year(const moment_t *mt, int64_t v, moment_t *r) {
+    int m, d;
+
+    CHECK(check_year(v));
+    dt_to_ymd(moment_local_dt(mt), NULL, &m, &d);
+    return moment_with_ymd(mt, (int)v, m, d, r);
+}
+
+static moment_status_t
+moment_with_quarter(const moment_t *mt, int64_t v, moment_t *r) {
+    int y, m, d;
+
+    CHECK(check_quarter(v));
+    dt_to_ymd(moment_local_dt(mt), &y, &m, &d);
+    m = 1 + 3 * ((int)v - 1) + (m - 1) % 3;
+    return moment_with_ymd(mt, y, m, d, r);
+}
+
+static moment_status_t
+moment_with_month(const moment_t *mt, int64_t v, moment_t *r) {
+    int y, d;
+
+    CHECK(check_month(v));
+    dt_to_ymd(moment_local_dt(mt), &y, NULL, &d);
+    return moment_with_ymd(mt, y, (int)v, d, r);
+}
+
+static moment_status_t
+moment_with_week(const moment_t *mt, int64_t v, moment_t *r) {
+    int y, w, d;
+
+    CHECK(check_week(v));
+    dt_to_ywd(moment_local_dt(mt), &y, NULL, &d);
+    w = (int)v;
+    if (w > 52 && w > dt_weeks_in_year(y))
+        return MOMENT_ERR_WEEK_OF_YEAR;
+    return moment_with_local_dt(mt, dt_from_ywd(y, w, d), r);
+}
+
+static moment_status_t
+moment_with_day_of_month(const moment_t *mt, int64_t v, moment_t *r) {
+    int y, m, d;
+
+    CHECK(check_day_of_month(v));
+    dt_to_ymd(moment_local_dt(mt), &y, &m, NULL);
+    d = (int)v;
+    if (d > 28 && d > dt_days_in_month(y, m))
+        return MOMENT_ERR_DAY_OF_MONTH;
+    return moment_with_local_dt(mt, dt_from_ymd(y, m, d), r);
+}
+
+static moment_status_t
+moment_with_day_of_quarter(const moment_t *mt, int64_t v, moment_t *r) {
+    int y, q, d;
+
+    CHECK(check_day_of_quarter(v));
+    dt_to_yqd(moment_local_dt(mt), &y, &q, NULL);
+    d = (int)v;
+    if (d > 90 && d > dt_days_in_quarter(y, q))
+        return MOMENT_ERR_DAY_OF_QUARTER;
+    return moment_with_local_dt(mt, dt_from_yqd(y, q, d), r);
+}
+
+static moment_status_t
+moment_with_day_of_year(const moment_t *mt, int64_t v, moment_t *r) {
+    int y, d;
+
+    CHECK(check_day_of_year(v));
+    dt_to_yd(moment_local_dt(mt), &y, NULL);
+    d = (int)v;
+    if (d > 365 && d > dt_days_in_year(y))
+        return MOMENT_ERR_DAY_OF_YEAR;
+    return moment_with_local_dt(mt, dt_from_yd(y, d), r);
+}
+
+static moment_status_t
+moment_with_day_of_week(const moment_t *mt, int64_t v, moment_t *r) {
+    dt_t dt;
+
+    CHECK(check_day_of_week(v));
+    dt = moment_local_dt(mt);
+    return moment_with_local_dt(mt, dt - (dt_dow(dt) - (int)v), r);
+}
+
+static moment_status_t
+moment_with_rata_die_day(const moment_t *mt, int64_t v, moment_t *r) {
+
+    CHECK(check_rata_die_day(v));
+    return moment_with_local_dt(mt, dt_from_rdn((int)v), r);
+}
+
+static moment_status_t
+moment_with_hour(const moment_t *mt, int64_t v, moment_t *r) {
+    int64_t sec;
+
+    CHECK(check_hour(v));
+    sec = moment_local_rd_seconds(mt) + (v - moment_hour(mt)) * 3600;
+    return moment_from_local(sec, mt->nsec, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_minute(const moment_t *mt, int64_t v, moment_t *r) {
+    int64_t sec;
+
+    CHECK(check_minute(v));
+    sec = moment_local_rd_seconds(mt) + (v - moment_minute(mt)) * 60;
+    return moment_from_local(sec, mt->nsec, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_minute_of_day(const moment_t *mt, int64_t v, moment_t *r) {
+    int64_t sec;
+
+    CHECK(check_minute_of_day(v));
+    sec = moment_local_rd_seconds(mt) + (v - moment_minute_of_day(mt)) * 60;
+    return moment_from_local(sec, mt->nsec, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_second(const moment_t *mt, int64_t v, moment_t *r) {
+    int64_t sec;
+
+    CHECK(check_second(v));
+    sec = moment_local_rd_seconds(mt) + (v - moment_second(mt));
+    return moment_from_local(sec, mt->nsec, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_second_of_day(const moment_t *mt, int64_t v, moment_t *r) {
+    int64_t sec;
+
+    CHECK(check_second_of_day(v));
+    sec = moment_local_rd_seconds(mt) + (v - moment_second_of_day(mt));
+    return moment_from_local(sec, mt->nsec, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_millisecond(const moment_t *mt, int64_t v, moment_t *r) {
+
+    CHECK(check_millisecond(v));
+    return moment_from_local(moment_local_rd_seconds(mt), v * 1000000, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_microsecond(const moment_t *mt, int64_t v, moment_t *r) {
+
+    CHECK(check_microsecond(v));
+    return moment_from_local(moment_local_rd_seconds(mt), v * 1000, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_nanosecond(const moment_t *mt, int64_t v, moment_t *r) {
+
+    CHECK(check_nanosecond(v));
+    return moment_from_local(moment_local_rd_seconds(mt), v, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_nanosecond_of_day(const moment_t *mt, int64_t v, moment_t *r) {
+    int64_t sec;
+
+    if (v < 0 || v > INT64_C(86400000000000))
+        return MOMENT_ERR_PARAM_NANOSECOND_OF_DAY;
+
+    sec = moment_local_rd_seconds(mt) + v / NANOS_PER_SEC - moment_second_of_day(mt);
+    return moment_from_local(sec, v % NANOS_PER_SEC, mt->offset, r);
+}
+
+static moment_status_t
+moment_with_microsecond_of_day(const moment_t *mt, int64_t v, moment_t *r) {
+    if (v < 0 || v > INT64_C(86400000000))
+        return MOMENT_ERR_PARAM_MICROSECOND_OF_DAY;
+    return moment_with_nanosecond_of_day(mt, v * 1000, r);
+}
+
+static moment_status_t
+moment_with_millisecond_of_day(const moment_t *mt, int64_t v, moment_t *r) {
+    if (v < 0 || v > INT64_C(86400000))
+        return MOMENT_ERR_PARAM_MILLISECOND_OF_DAY;
+    return moment_with_nanosecond_of_day(mt, v * 1000000, r);
+}
+
+moment_status_t
+moment_core_with_field(const moment_t *mt, moment_component_t c, int64_t v, moment_t *r) {
+    switch (c) {
+        case MOMENT_FIELD_YEAR:
+            return moment_with_year(mt, v, r);
+        case MOMENT_FIELD_QUARTER_OF_YEAR:
+            return moment_with_quarter(mt, v, r);
+        case MOMENT_FIELD_MONTH_OF_YEAR:
+            return moment_with_month(mt, v, r);
+        case MOMENT_FIELD_WEEK_OF_YEAR:
+            return moment_with_week(mt, v, r);
+        case MOMENT_FIELD_DAY_OF_MONTH:
+            return moment_with_day_of_month(mt, v, r);
+        case MOMENT_FIELD_DAY_OF_QUARTER:
+            return moment_with_day_of_quarter(mt, v, r);
+        case MOMENT_FIELD_DAY_OF_YEAR:
+            return moment_with_day_of_year(mt, v, r);
+        case MOMENT_FIELD_DAY_OF_WEEK:
+            return moment_with_day_of_week(mt, v, r);
+        case MOMENT_FIELD_HOUR_OF_DAY:
+            return moment_with_hour(mt, v, r);
+        case MOMENT_FIELD_MINUTE_OF_HOUR:
+            return moment_with_minute(mt, v, r);
+        case MOMENT_FIELD_MINUTE_OF_DAY:
+            return moment_with_minute_of_day(mt, v, r);
+        case MOMENT_FIELD_SECOND_OF_MINUTE:
+            return moment_with_second(mt, v, r);
+        case MOMENT_FIELD_SECOND_OF_DAY:
+            return moment_with_second_of_day(mt, v, r);
+        case MOMENT_FIELD_MILLI_OF_SECOND:
+            return moment_with_millisecond(mt, v, r);
+        case MOMENT_FIELD_MILLI_OF_DAY:
+            return moment_with_millisecond_of_day(mt, v, r);
+        case MOMENT_FIELD_MICRO_OF_SECOND:
+            return moment_with_microsecond(mt, v, r);
+        case MOMENT_FIELD_MICRO_OF_DAY:
+            return moment_with_microsecond_of_day(mt, v, r);
+        case MOMENT_FIELD_NANO_OF_SECOND:
+            return moment_with_nanosecond(mt, v, r);
+        case MOMENT_FIELD_NANO_OF_DAY:
+            return moment_with_nanosecond_of_day(mt, v, r);
+        case MOMENT_FIELD_PRECISION:
+            return moment_core_with_precision(mt, v, r);
+        case MOMENT_FIELD_RATA_DIE_DAY:
+            return moment_with_rata_die_day(mt, v, r);
+    }
+    return MOMENT_ERR_COMPONENT;
+}
+
+static moment_status_t
+moment_plus_months(const moment_t *mt, int64_t v, moment_t *r) {
+    dt_t dt;
+
+    CHECK(check_unit_months(v));
+    dt = dt_add_months(moment_local_dt(mt), (int)v, DT_LIMIT);
+    return moment_with_local_dt(mt, dt, r);
+}
+
+static moment_status_t
+moment_plus_days(const moment_t *mt, int64_t v, moment_t *r) {
+    int64_t sec;
+
+    CHECK(check_unit_days(v));
+    sec = moment_local_rd_seconds(mt) + v * 86400;
+    return moment_from_local(sec, mt->nsec, mt->offset, r);
+}
+
+static moment_status_t
+moment_plus_seconds(const moment_t *mt, int64_t v, moment_t *r) {
+    int64_t sec;
+
+    CHECK(check_unit_seconds(v));
+    sec = moment_instant_rd_seconds(mt) + v;
+    return moment_from_instant(sec, mt->nsec, mt->offset, r);
+}
+
+static moment_status_t
+moment_plus_time(const moment_t *mt, int64_t sec, int64_t nsec, int sign, moment_t *r) {
+
+    sec  = sec + (nsec / NANOS_PER_SEC);
+    nsec = nsec % NANOS_PER_SEC;
+
+    sec  = moment_instant_rd_seconds(mt) + sec * sign;
+    nsec = mt->nsec + nsec * sign;
+
+    if (nsec < 0) {
+        nsec += NANOS_PER_SEC;
+        sec--;
+    }
+    else if (nsec >= NANOS_PER_SEC) {
+        nsec -= NANOS_PER_SEC;
+        sec++;
+    }
+    return moment_from_instant(sec, nsec, mt->offset, r);
+}
+
+moment_status_t
+moment_core_plus_unit(const moment_t *mt, moment_unit_t u, int64_t v, moment_t *r) {
+    switch (u) {
+        case MOMENT_UNIT_YEARS:
+            CHECK(check_unit_years(v));
+            return moment_plus_months(mt, v * 12, r);
+        case MOMENT_UNIT_MONTHS:
+            CHECK(check_unit_months(v));
+            return moment_plus_months(mt, v, r);
+        case MOMENT_UNIT_WEEKS:
+            CHECK(check_unit_weeks(v));
+            return moment_plus_days(mt, v * 7, r);
+        case MOMENT_UNIT_DAYS:
+            CHECK(check_unit_days(v));
+            return moment_plus_days(mt, v, r);
+        case MOMENT_UNIT_HOURS:
+            CHECK(check_unit_hours(v));
+            return moment_plus_seconds(mt, v * 3600, r);
+        case MOMENT_UNIT_MINUTES:
+            CHECK(check_unit_minutes(v));
+            return moment_plus_seconds(mt, v * 60, r);
+        case MOMENT_UNIT_SECONDS:
+            CHECK(check_unit_seconds(v));
+            return moment_plus_seconds(mt, v, r);
+        case MOMENT_UNIT_MILLIS:
+            CHECK(check_unit_milliseconds(v));
+            return moment_plus_time(mt, v / 1000, (v % 1000) * 1000000, 1, r);
+        case MOMENT_UNIT_MICROS:
+            CHECK(check_unit_microseconds(v));
+            return moment_plus_time(mt, v / 1000000, (v % 1000000) * 1000, 1, r);
+        case MOMENT_UNIT_NANOS:
+            return moment_plus_time(mt, 0, v, 1, r);
+    }
+    return MOMENT_ERR_UNIT;
+}
+
+moment_status_t
+moment_core_minus_unit(const moment_t *mt, moment_unit_t u, int64_t v, moment_t *r) {
+    switch (u) {
+        case MOMENT_UNIT_YEARS:
+            CHECK(check_unit_years(v));
+            return moment_plus_months(mt, -v * 12, r);
+        case MOMENT_UNIT_MONTHS:
+            CHECK(check_unit_months(v));
+            return moment_plus_months(mt, -v, r);
+        case MOMENT_UNIT_WEEKS:
+            CHECK(check_unit_weeks(v));
+            return moment_plus_days(mt, -v * 7, r);
+        case MOMENT_UNIT_DAYS:
+            CHECK(check_unit_days(v));
+            return moment_plus_days(mt, -v, r);
+        case MOMENT_UNIT_HOURS:
+            CHECK(check_unit_hours(v));
+            return moment_plus_seconds(mt, -v * 3600, r);
+        case MOMENT_UNIT_MINUTES:
+            CHECK(check_unit_minutes(v));
+            return moment_plus_seconds(mt, -v * 60, r);
+        case MOMENT_UNIT_SECONDS:
+            CHECK(check_unit_seconds(v));
+            return moment_plus_seconds(mt, -v, r);
+        case MOMENT_UNIT_MILLIS:
+            CHECK(check_unit_milliseconds(v));
+            return moment_plus_time(mt, v / 1000, (v % 1000) * 1000000, -1, r);
+        case MOMENT_UNIT_MICROS:
+            CHECK(check_unit_microseconds(v));
+            return moment_plus_time(mt, v / 1000000, (v % 1000000) * 1000, -1, r);
+        case MOMENT_UNIT_NANOS:
+            return moment_plus_time(mt, 0, v, -1, r);
+    }
+    return MOMENT_ERR_UNIT;
+}
+
+moment_status_t
+moment_core_plus_duration(const moment_t *mt, const moment_duration_t *d, moment_t *r) {
+    return moment_plus_time(mt, d->sec, d->nsec, 1, r);
+}
+
+moment_status_t
+moment_core_minus_duration(const moment_t *mt, const moment_duration_t *d, moment_t *r) {
+    return moment_plus_time(mt, d->sec, d->nsec, -1, r);
+}
+
+/*
+ * Adds the nominal months and days to the local date and the time to the
+ * instant, which gives the same result as plus_months, plus_days and the
+ * time based plus_* in turn, but normalizes only once.
+ */
+static moment_status_t
+moment_plus_period(const moment_t *mt, const moment_period_t *p, int sign, moment_t *r) {
+    int64_t months, days, sec, nsec;
+    dt_t dt;
+
+    CHECK(check_unit_years(p->years));
+    CHECK(check_unit_months(p->months));
+    months = p->years * 12 + p->months;
+    CHECK(check_unit_months(months));
+
+    CHECK(check_unit_weeks(p->weeks));
+    CHECK(check_unit_days(p->days));
+    days = p->weeks * 7 + p->days;
+    CHECK(check_unit_days(days));
+
+    CHECK(check_unit_hours(p->hours));
+    CHECK(check_unit_minutes(p->minutes));
+    CHECK(check_unit_seconds(p->seconds));
+    sec = p->hours * 3600 + p->minutes * 60 + p->seconds;
+    CHECK(check_unit_seconds(sec));
+    nsec = p->nanoseconds;
+
+    if (sign * p->sign < 0) {
+        months = -months;
+        days = -days;
+        sec = -sec;
+        nsec = -nsec;
+    }
+
+    dt = moment_local_dt(mt);
+    if (months)
+        dt = dt_add_months(dt, (int)months, DT_LIMIT);
+    dt += (int)days;
+
+    sec += (int64_t)dt_rdn(dt) * SECS_PER_DAY + moment_second_of_day(mt) - mt->offset * 60;
+    nsec += mt->nsec;
+    if (nsec < 0) {
+        nsec += NANOS_PER_SEC;
+        sec--;
+    }
+    else if (nsec >= NANOS_PER_SEC) {
+        nsec -= NANOS_PER_SEC;
+        sec++;
+    }
+    return moment_from_instant(sec, nsec, mt->offset, r);
+}
+
+moment_status_t
+moment_core_plus_period(const moment_t *mt, const moment_period_t *p, moment_t *r) {
+    return moment_plus_period(mt, p, 1, r);
+}
+
+moment_status_t
+moment_core_minus_period(const moment_t *mt, const moment_period_t *p, moment_t *r) {
+    return moment_plus_period(mt, p, -1, r);
+}
+
+moment_status_t
+moment_core_with_offset_same_instant(const moment_t *mt, int64_t offset, moment_t *r) {
+
+    CHECK(check_offset(offset));
+    return moment_from_instant(moment_instant_rd_seconds(mt), mt->nsec, offset, r);
+}
+
+moment_status_t
+moment_core_with_offset_same_local(const moment_t *mt, int64_t offset, moment_t *r) {
+
+    CHECK(check_offset(offset));
+    return moment_from_local(moment_local_rd_seconds(mt), mt->nsec, offset, r);
+}
+
+moment_status_t
+moment_core_with_precision(const moment_t *mt, int64_t precision, moment_t *r) {
+    int64_t sec;
+    int32_t nsec;
+
+    if (precision < -3 || precision > 9)
+        return MOMENT_ERR_PARAM_PRECISION;
+
+    sec = moment_local_rd_seconds(mt);
+    nsec = mt->nsec;
+    if (precision <= 0) {
+        nsec = 0;
+        switch (precision) {
+            case -1: sec -= sec % 60;       break;
+            case -2: sec -= sec % 3600;     break;
+            case -3: sec -= sec % 86400;    break;
+        }
+    }
+    else {
+        nsec -= nsec % kPow10[9 - precision];
+    }
+    return moment_from_local(sec, nsec, mt->offset, r);
+}
+
+moment_duration_t
+moment_subtract_moment(const moment_t *mt1, const moment_t *mt2) {
+    const int64_t s1 = moment_instant_rd_seconds(mt1);
+    const int64_t s2 = moment_instant_rd_seconds(mt2);
+    moment_duration_t d;
+
+    d.sec = s2 - s1;
+    d.nsec = mt2->nsec - mt1->nsec;
+    if (d.nsec < 0) {
+        d.sec -= 1;
+        d.nsec += NANOS_PER_SEC;
+    }
+    return d;
+}
+
+static int
+moment_delta_days(const moment_t *mt1, const moment_t *mt2) {
+    const dt_t dt1 = moment_local_dt(mt1);
+    const dt_t dt2 = moment_local_dt(mt2);
+    return dt2 - dt1;
+}
+
+static int
+moment_delta_weeks(const moment_t *mt1, const moment_t *mt2) {
+    return moment_delta_days(mt1, mt2) / 7;
+}
+
+static int
+moment_delta_months(const moment_t *mt1, const moment_t *mt2) {
+    const dt_t dt1 = moment_local_dt(mt1);
+    const dt_t dt2 = moment_local_dt(mt2);
+    return dt_delta_months(dt1, dt2, true);
+}
+
+static int
+moment_delta_years(const moment_t *mt1, const moment_t *mt2) {
+    return moment_delta_months(mt1, mt2) / 12;
+}
+
+moment_status_t
+moment_core_delta_unit(const moment_t *mt1, const moment_t *mt2, moment_unit_t u, int64_t *r) {
+    moment_duration_t d;
+
+    switch (u) {
+        case MOMENT_UNIT_YEARS:
+            *r = moment_delta_years(mt1, mt2);
+            return MOMENT_OK;
+        case MOMENT_UNIT_MONTHS:
+            *r = moment_delta_months(mt1, mt2);
+            return MOMENT_OK;
+        case MOMENT_UNIT_WEEKS:
+            *r = moment_delta_weeks(mt1, mt2);
+            return MOMENT_OK;
+        case MOMENT_UNIT_DAYS:
+            *r = moment_delta_days(mt1, mt2);
+            return MOMENT_OK;
+        case MOMENT_UNIT_HOURS:
+        case MOMENT_UNIT_MINUTES:
+        case MOMENT_UNIT_SECONDS:
+        case MOMENT_UNIT_MILLIS:
+        case MOMENT_UNIT_MICROS:
+        case MOMENT_UNIT_NANOS:
+            d = moment_subtract_moment(mt1, mt2);
+            return moment_core_duration_to_unit(&d, u, r);
+    }
+    return MOMENT_ERR_UNIT;
+}
+
+void
+moment_delta_ymd(const moment_t *mt1, const moment_t *mt2, int *yp, int *mp, int *dp) {
+    dt_delta_ymd(moment_local_dt(mt1), moment_local_dt(mt2), yp, mp, dp);
+}
+
+void
+moment_delta_yqd(const moment_t *mt1, const moment_t *mt2, int *yp, int *qp, int *dp) {
+    dt_delta_yqd(moment_local_dt(mt1), moment_local_dt(mt2), yp, qp, dp);
+}
+
+/*
+ * The instant of mt2 is viewed at the offset of mt1, and a day is borrowed
+ * whenever the time of day would otherwise have the opposite sign of the
+ * date part, so that every component has the same sign.
+ */
+void
+moment_delta_ymdhms(const moment_t *mt1, const moment_t *mt2, int *yp, int *mp, int *dp,
+                    int *hp, int *mip, int *sp, int *nsp) {
+    static const int64_t kNanosPerDay = INT64_C(86400000000000);
+    int64_t s1, s2, t1, t2, t;
+    dt_t dt1, dt2;
+
+    s1 = mt1->sec;
+    s2 = mt2->sec + (int64_t)(mt1->offset - mt2->offset) * 60;
+
+    dt1 = dt_from_rdn((int)(s1 / SECS_PER_DAY));
+    dt2 = dt_from_rdn((int)(s2 / SECS_PER_DAY));
+    t1 = (s1 % SECS_PER_DAY) * NANOS_PER_SEC + mt1->nsec;
+    t2 = (s2 % SECS_PER_DAY) * NANOS_PER_SEC + mt2->nsec;
+
+    if (dt2 > dt1 && t2 < t1)
+        dt2--, t2 += kNanosPerDay;
+    else if (dt2 < dt1 && t2 > t1)
+        dt2++, t2 -= kNanosPerDay;
+
+    dt_delta_ymd(dt1, dt2, yp, mp, dp);
+
+    t = t2 - t1;
+    if (nsp) *nsp = (int)(t % NANOS_PER_SEC);
+    t /= NANOS_PER_SEC;
+    if (sp)  *sp  = (int)(t % 60);
+    if (mip) *mip = (int)(t / 60 % 60);
+    if (hp)  *hp  = (int)(t / 3600);
+}
+
+moment_status_t
+moment_core_at_utc(const moment_t *mt, moment_t *r) {
+    return moment_core_with_offset_same_instant(mt, 0, r);
+}
+
+moment_status_t
+moment_core_at_midnight(const moment_t *mt, moment_t *r) {
+    return moment_with_millisecond_of_day(mt, 0, r);
+}
+
+moment_status_t
+moment_core_at_noon(const moment_t *mt, moment_t *r) {
+    return moment_with_millisecond_of_day(mt, 12*60*60*1000, r);
+}
+
+moment_status_t
+moment_core_at_last_day_of_year(const moment_t *mt, moment_t *r) {
+    int y;
+
+    dt_to_yd(moment_local_dt(mt), &y, NULL);
+    return moment_with_local_dt(mt, dt_from_yd(y + 1, 0), r);
+}
+
+moment_status_t
+moment_core_at_last_day_of_quarter(const moment_t *mt, moment_t *r) {
+    int y, q;
+
+    dt_to_yqd(moment_local_dt(mt), &y, &q, NULL);
+    return moment_with_local_dt(mt, dt_from_yqd(y, q + 1, 0), r);
+}
+
+moment_status_t
+moment_core_at_last_day_of_month(const moment_t *mt, moment_t *r) {
+    int y, m;
+
+    dt_to_ymd(moment_local_dt(mt), &y, &m, NULL);
+    return moment_with_local_dt(mt, dt_from_ymd(y, m + 1, 0), r);
+}
+
+int
+moment_compare_instant(const moment_t *m1, const moment_t *m2) {
+    const int64_t s1 = moment_instant_rd_seconds(m1);
+    const int64_t s2 = moment_instant_rd_seconds(m2);
+    int r;
+
+    r = (s1 > s2) - (s1 < s2);
+    if (r == 0)
+        r = (m1->nsec > m2->nsec) - (m1->nsec < m2->nsec);
+    return r;
+}
+
+int
+moment_compare_local(const moment_t *m1, const moment_t *m2) {
+    const int64_t s1 = moment_local_rd_seconds(m1);
+    const int64_t s2 = moment_local_rd_seconds(m2);
+    int r;
+
+    r = (s1 > s2) - (s1 < s2);
+    if (r == 0)
+        r = (m1->nsec > m2->nsec) - (m1->nsec < m2->nsec);
+    return r;
+}
+
+moment_status_t
+moment_core_compare_precision(const moment_t *m1, const moment_t *m2, int64_t precision, int *rp) {
+    int64_t n1, n2;
+    int r;
+
+    if (precision < -3 || precision > 9)
+        return MOMENT_ERR_PARAM_PRECISION;
+
+    if (precision < 0) {
+        int32_t n;
+
+        n = 0;
+        switch (precision) {
+            case -1: n = 60;    break;
+            case -2: n = 3600;  break;
+            case -3: n = 86400; break;
+        }
+        n1 = moment_local_rd_seconds(m1);
+        n2 = moment_local_rd_seconds(m2);
+        n1 -= n1 % n;
+        n2 -= n2 % n;
+        n1 -= m1->offset * 60;
+        n2 -= m2->offset * 60;
+        r = (n1 > n2) - (n1 < n2);
+    }
+    else {
+        n1 = moment_instant_rd_seconds(m1);
+        n2 = moment_instant_rd_seconds(m2);
+        r = (n1 > n2) - (n1 < n2);
+        if (r == 0 && precision != 0) {
+            n1 = m1->nsec - m1->nsec % kPow10[9 - precision];
+            n2 = m2->nsec - m2->nsec % kPow10[9 - precision];
+            r = (n1 > n2) - (n1 < n2);
+        }
+    }
+    *rp = r;
+    return MOMENT_OK;
+}
+
+bool
+moment_equals(const moment_t *m1, const moment_t *m2) {
+    return memcmp(m1, m2, sizeof(moment_t)) == 0;
+}
+
+int64_t
+moment_epoch(const moment_t *mt) {
+    return (moment_instant_rd_seconds(mt) - UNIX_EPOCH);
+}
+
+int
+moment_year(const moment_t *mt) {
+    return dt_year(moment_local_dt(mt));
+}
+
+int
+moment_month(const moment_t *mt) {
+    return dt_month(moment_local_dt(mt));
+}
+
+int
+moment_quarter(const moment_t *mt) {
+    return dt_quarter(moment_local_dt(mt));
+}
+
+int
+moment_week(const moment_t *mt) {
+    return dt_woy(moment_local_dt(mt));
+}
+
+int
+moment_day_of_year(const moment_t *mt) {
+    return dt_doy(moment_local_dt(mt));
+}
+
+int
+moment_day_of_quarter(const moment_t *mt) {
+    return dt_doq(moment_local_dt(mt));
+}
+
+int
+moment_day_of_month(const moment_t *mt) {
+    return dt_dom(moment_local_dt(mt));
+}
+
+int
+moment_day_of_week(const moment_t *mt) {
+    return dt_dow(moment_local_dt(mt));
+}
+
+int
+moment_hour(const moment_t *mt) {
+    return (int)((moment_local_rd_seconds(mt) / 3600) % 24);
+}
+
+int
+moment_minute(const moment_t *mt) {
+    return (int)((moment_local_rd_seconds(mt) / 60) % 60);
+}
+
+int
+moment_minute_of_day(const moment_t *mt) {
+    return (int)((moment_local_rd_seconds(mt) / 60) % 1440);
+}
+
+int
+moment_second(const moment_t *mt) {
+    return (int)(moment_local_rd_seconds(mt) % 60);
+}
+
+int
+moment_second_of_day(const moment_t *mt) {
+    return (int)(moment_local_rd_seconds(mt) % 86400);
+}
+
+int
+moment_millisecond(const moment_t *mt) {
+    return (mt->nsec / 1000000);
+}
+
+int
+moment_millisecond_of_day(const moment_t *mt) {
+    return moment_second_of_day(mt) * 1000 + moment_millisecond(mt);
+}
+
+int
+moment_microsecond(const moment_t *mt) {
+    return (mt->nsec / 1000);
+}
+
+int64_t
+moment_microsecond_of_day(const moment_t *mt) {
+    const int64_t sod = moment_local_rd_seconds(mt) % 86400;
+    return sod * 1000000 + (mt->nsec / 1000);
+}
+
+int
+moment_nanosecond(const moment_t *mt) {
+    return mt->nsec;
+}
+
+int64_t
+moment_nanosecond_of_day(const moment_t *mt) {
+    const int64_t sod = moment_local_rd_seconds(mt) % 86400;
+    return sod * 1000000000 + mt->nsec;
+}
+
+double
+moment_jd(const moment_t *mt) {
+    return moment_mjd(mt) + 2400000.5;
+}
+
+double
+moment_mjd(const moment_t *mt) {
+    const int64_t s = moment_instant_rd_seconds(mt);
+    const int64_t d = (s / SECS_PER_DAY) - 678576;
+    const int64_t n = (s % SECS_PER_DAY) * NANOS_PER_SEC + mt->nsec;
+    return (double)d + (double)n * (1E-9/60/60/24);
+}
+
+double
+moment_rd(const moment_t *mt) {
+    const int64_t s = moment_local_rd_seconds(mt);
+    const int64_t d = (s / SECS_PER_DAY);
+    const int64_t n = (s % SECS_PER_DAY) * NANOS_PER_SEC + mt->nsec;
+    return (double)d + (double)n * (1E-9/60/60/24);
+}
+
+int
+moment_rata_die_day(const moment_t *mt) {
+    return dt_rdn(moment_local_dt(mt));
+}
+
+int
+moment_offset(const moment_t *mt) {
+    return mt->offset;
+}
+
+int
+moment_precision(const moment_t *mt) {
+    int v, i;
+
+    v = mt->nsec;
+    if (v != 0) {
+        for (i = 8; i > 0; i--) {
+            if ((v % kPow10[i]) == 0)
+                break;
+        }
+        return 9 - i;
+    }
+    v = moment_second_of_day(mt);
+    if (v != 0) {
+        if      ((v % 3600) == 0) return -2;
+        else if ((v %   60) == 0) return -1;
+        else                      return 0;
+    }
+    return -3;
+}
+
+int
+moment_length_of_year(const moment_t *mt) {
+    return dt_length_of_year(moment_local_dt(mt));
+}
+
+int
+moment_length_of_quarter(const moment_t *mt) {
+    return dt_length_of_quarter(moment_local_dt(mt));
+}
+
+int
+moment_length_of_month(const moment_t *mt) {
+    return dt_length_of_month(moment_local_dt(mt));
+}
+
+int
+moment_length_of_week_year(const moment_t *mt) {
+    return dt_length_of_week_year(moment_local_dt(mt));
+}
+
+bool
+moment_is_leap_year(const moment_t *mt) {
+    return dt_leap_year(moment_year(mt));
+}
+
+moment_status_t
+moment_core_western_easter(int64_t y, int *rdn) {
+    CHECK(check_year(y));
+    *rdn = dt_rdn(dt_from_easter((int)y, DT_WESTERN));
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_orthodox_easter(int64_t y, int *rdn) {
+    CHECK(check_year(y));
+    *rdn = dt_rdn(dt_from_easter((int)y, DT_ORTHODOX));
+    return MOMENT_OK;
+}
+
+static char *
+format_digits(char *d, unsigned int v, int width) {
+    char *p = d + width;
+    while (p > d) {
+        *--p = '0' + (v % 10);
+        v /= 10;
+    }
+    return d + width;
+}
+
+size_t
+moment_to_string_buffer(const moment_t *mt, bool reduced, char *buf, size_t len) {
+    char str[MOMENT_STRING_MAX], *d;
+    int year, month, day, sec, ns, offset;
+    size_t n;
+
+    dt_to_ymd(moment_local_dt(mt), &year, &month, &day);
+
+    d = str;
+    d = format_digits(d, year, 4);
+    *d++ = '-';
+    d = format_digits(d, month, 2);
+    *d++ = '-';
+    d = format_digits(d, day, 2);
+    *d++ = 'T';
+    d = format_digits(d, moment_hour(mt), 2);
+    *d++ = ':';
+    d = format_digits(d, moment_minute(mt), 2);
+
+    sec = moment_second(mt);
+    ns  = moment_nanosecond(mt);
+    if (!reduced || sec || ns) {
+        *d++ = ':';
+        d = format_digits(d, sec, 2);
+        if (ns) {
+            *d++ = '.';
+            if      ((ns % 1000000) == 0) d = format_digits(d, ns / 1000000, 3);
+            else if ((ns % 1000)    == 0) d = format_digits(d, ns / 1000, 6);
+            else                          d = format_digits(d, ns, 9);
+        }
+    }
+
+    offset = moment_offset(mt);
+    if (offset == 0)
+        *d++ = 'Z';
+    else {
+        if (offset < 0)
+            *d++ = '-', offset = -offset;
+        else
+            *d++ = '+';
+
+        d = format_digits(d, offset / 60, 2);
+        if (!reduced || (offset % 60) != 0) {
+            *d++ = ':';
+            d = format_digits(d, offset % 60, 2);
+        }
+    }
+
+    n = d - str;
+    if (len) {
+        const size_t c = (n < len) ? n : len - 1;
+        memcpy(buf, str, c);
+        buf[c] = '\0';
+    }
+    return n;
+}
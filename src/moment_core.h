@@ -0,0 +1,282 @@
+#ifndef __MOMENT_CORE_H__
+#define __MOMENT_CORE_H__
+#include <stddef.h>
+#include "dt_core.h"
+#include "time_moment.h"
+
+/*
+ * Perl independent core of Time::Moment.
+ *
+ * Functions that can fail return a moment_status_t and store their result
+ * through the last argument, which is left untouched on failure. They do
+ * not require an interpreter context and may be called from any thread.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SECS_PER_DAY      86400
+#define NANOS_PER_SEC     1000000000
+
+#define MIN_UNIT_YEARS      INT64_C(-10000)
+#define MAX_UNIT_YEARS      INT64_C(10000)
+#define MIN_UNIT_MONTHS     INT64_C(-120000)
+#define MAX_UNIT_MONTHS     INT64_C(120000)
+#define MIN_UNIT_WEEKS      INT64_C(-521775)
+#define MAX_UNIT_WEEKS      INT64_C(521775)
+#define MIN_UNIT_DAYS       INT64_C(-3652425)
+#define MAX_UNIT_DAYS       INT64_C(3652425)
+#define MIN_UNIT_HOURS      INT64_C(-87658200)
+#define MAX_UNIT_HOURS      INT64_C(87658200)
+#define MIN_UNIT_MINUTES    INT64_C(-5259492000)
+#define MAX_UNIT_MINUTES    INT64_C(5259492000)
+#define MIN_UNIT_SECONDS    INT64_C(-315569520000)
+#define MAX_UNIT_SECONDS    INT64_C(315569520000)
+#ifndef INT64_MAX
+#  define INT64_MAX         INT64_C(9223372036854775807)
+#endif
+#ifndef INT64_MIN
+#  define INT64_MIN         (-INT64_MAX - 1)
+#endif
+
+#define MIN_UNIT_MILLIS     INT64_C(-315569520000000)
+#define MAX_UNIT_MILLIS     INT64_C(315569520000000)
+#define MIN_UNIT_MICROS     INT64_C(-315569520000000000)
+#define MAX_UNIT_MICROS     INT64_C(315569520000000000)
+
+#define MIN_RATA_DIE_DAY    INT64_C(1)            /* 0001-01-01           */
+#define MAX_RATA_DIE_DAY    INT64_C(3652059)      /* 9999-12-31           */
+
+#define MIN_RANGE           INT64_C(86400)        /* 0001-01-01T00:00:00Z */
+#define MAX_RANGE           INT64_C(315537983999) /* 9999-12-31T23:59:59Z */
+#define UNIX_EPOCH          INT64_C(62135683200)  /* 1970-01-01T00:00:00Z */
+#define MIN_EPOCH_SEC       INT64_C(-62135596800) /* 0001-01-01T00:00:00Z */
+#define MAX_EPOCH_SEC       INT64_C(253402300799) /* 9999-12-31T23:59:59Z */
+
+#define VALID_EPOCH_SEC(s) \
+    (s >= MIN_EPOCH_SEC && s <= MAX_EPOCH_SEC)
+
+typedef struct {
+    int64_t sec;
+    int32_t nsec;
+} moment_duration_t;
+
+/* An ISO 8601 duration, whose years, months, weeks and days are nominal */
+typedef struct {
+    int64_t years;
+    int64_t months;
+    int64_t weeks;
+    int64_t days;
+    int64_t hours;
+    int64_t minutes;
+    int64_t seconds;
+    int32_t nanoseconds;
+    int32_t sign;
+} moment_period_t;
+
+typedef enum {
+    MOMENT_UNIT_YEARS=0,
+    MOMENT_UNIT_MONTHS,
+    MOMENT_UNIT_WEEKS,
+    MOMENT_UNIT_DAYS,
+    MOMENT_UNIT_HOURS,
+    MOMENT_UNIT_MINUTES,
+    MOMENT_UNIT_SECONDS,
+    MOMENT_UNIT_MILLIS,
+    MOMENT_UNIT_MICROS,
+    MOMENT_UNIT_NANOS,
+} moment_unit_t;
+
+typedef enum {
+    MOMENT_FIELD_YEAR=0,
+    MOMENT_FIELD_QUARTER_OF_YEAR,
+    MOMENT_FIELD_MONTH_OF_YEAR,
+    MOMENT_FIELD_WEEK_OF_YEAR,
+    MOMENT_FIELD_DAY_OF_YEAR,
+    MOMENT_FIELD_DAY_OF_QUARTER,
+    MOMENT_FIELD_DAY_OF_MONTH,
+    MOMENT_FIELD_DAY_OF_WEEK,
+    MOMENT_FIELD_HOUR_OF_DAY,
+    MOMENT_FIELD_MINUTE_OF_HOUR,
+    MOMENT_FIELD_MINUTE_OF_DAY,
+    MOMENT_FIELD_SECOND_OF_MINUTE,
+    MOMENT_FIELD_SECOND_OF_DAY,
+    MOMENT_FIELD_MILLI_OF_SECOND,
+    MOMENT_FIELD_MILLI_OF_DAY,
+    MOMENT_FIELD_MICRO_OF_SECOND,
+    MOMENT_FIELD_MICRO_OF_DAY,
+    MOMENT_FIELD_NANO_OF_SECOND,
+    MOMENT_FIELD_NANO_OF_DAY,
+    MOMENT_FIELD_PRECISION,
+    MOMENT_FIELD_RATA_DIE_DAY,
+} moment_component_t;
+
+typedef enum {
+    MOMENT_OK=0,
+    MOMENT_ERR_RANGE,
+    MOMENT_ERR_PARSE,
+    MOMENT_ERR_PARAM_YEAR,
+    MOMENT_ERR_PARAM_QUARTER,
+    MOMENT_ERR_PARAM_MONTH,
+    MOMENT_ERR_PARAM_WEEK,
+    MOMENT_ERR_PARAM_DAY_OF_YEAR,
+    MOMENT_ERR_PARAM_DAY_OF_QUARTER,
+    MOMENT_ERR_PARAM_DAY_OF_MONTH,
+    MOMENT_ERR_PARAM_DAY_OF_WEEK,
+    MOMENT_ERR_PARAM_HOUR,
+    MOMENT_ERR_PARAM_MINUTE,
+    MOMENT_ERR_PARAM_MINUTE_OF_DAY,
+    MOMENT_ERR_PARAM_SECOND,
+    MOMENT_ERR_PARAM_SECOND_OF_DAY,
+    MOMENT_ERR_PARAM_MILLISECOND,
+    MOMENT_ERR_PARAM_MILLISECOND_OF_DAY,
+    MOMENT_ERR_PARAM_MICROSECOND,
+    MOMENT_ERR_PARAM_MICROSECOND_OF_DAY,
+    MOMENT_ERR_PARAM_NANOSECOND,
+    MOMENT_ERR_PARAM_NANOSECOND_OF_DAY,
+    MOMENT_ERR_PARAM_OFFSET,
+    MOMENT_ERR_PARAM_PRECISION,
+    MOMENT_ERR_PARAM_FRACTION_PRECISION,
+    MOMENT_ERR_PARAM_RATA_DIE_DAY,
+    MOMENT_ERR_PARAM_EPOCH,
+    MOMENT_ERR_PARAM_RD,
+    MOMENT_ERR_PARAM_JD,
+    MOMENT_ERR_PARAM_MJD,
+    MOMENT_ERR_PARAM_YEARS,
+    MOMENT_ERR_PARAM_MONTHS,
+    MOMENT_ERR_PARAM_WEEKS,
+    MOMENT_ERR_PARAM_DAYS,
+    MOMENT_ERR_PARAM_HOURS,
+    MOMENT_ERR_PARAM_MINUTES,
+    MOMENT_ERR_PARAM_SECONDS,
+    MOMENT_ERR_PARAM_MILLISECONDS,
+    MOMENT_ERR_PARAM_MICROSECONDS,
+    MOMENT_ERR_WEEK_OF_YEAR,
+    MOMENT_ERR_DAY_OF_YEAR,
+    MOMENT_ERR_DAY_OF_QUARTER,
+    MOMENT_ERR_DAY_OF_MONTH,
+    MOMENT_ERR_RD_RANGE,
+    MOMENT_ERR_JD_RANGE,
+    MOMENT_ERR_MJD_RANGE,
+    MOMENT_ERR_NANOS_OVERFLOW,
+    MOMENT_ERR_UNIT,
+    MOMENT_ERR_COMPONENT,
+    MOMENT_ERR_DURATION_RANGE,
+    MOMENT_ERR_DURATION_NOMINAL,
+    MOMENT_ERR_INTERVAL_ANCHOR,
+    MOMENT_ERR_INTERVAL_ORDER,
+    MOMENT_ERR_PARAM_STEP,
+    MOMENT_ERR_PARAM_ORDINAL,
+    MOMENT_ERR_PARAM_EASTER,
+    MOMENT_ERR_HOLIDAY_RULE,
+    MOMENT_ERR_BUSINESS_YEARS,
+    MOMENT_ERR_BUSINESS_RANGE,
+    MOMENT_ERR_CRON_SYNTAX,
+    MOMENT_ERR_CRON_NEVER,
+    MOMENT_ERR_RRULE_SYNTAX,
+    MOMENT_ERR_RRULE_UNSUPPORTED,
+    MOMENT_ERR_PACKED_FIELD,
+    MOMENT_ERR_ZONEMAP_BLOCK,
+    MOMENT_ERR_ZONEMAP_INVALID,
+    MOMENT_ERR_ZONEMAP_SHRUNK,
+    MOMENT_ERR_PARAM_TOLERANCE,
+    MOMENT_ERR_PARAM_WINDOW,
+} moment_status_t;
+
+const char *    moment_status_message(moment_status_t status);
+
+moment_status_t moment_core_new(int64_t Y, int64_t M, int64_t D, int64_t h, int64_t m, int64_t s, int64_t ns, int64_t offset, moment_t *r);
+moment_status_t moment_core_from_epoch(int64_t sec, int64_t nsec, int64_t offset, moment_t *r);
+moment_status_t moment_core_from_epoch_nv(double sec, int64_t precision, moment_t *r);
+moment_status_t moment_core_from_string(const char *str, size_t len, bool lenient, moment_t *r);
+
+moment_status_t moment_core_from_rd(double rd, double epoch, int64_t precision, int64_t offset, moment_t *r);
+moment_status_t moment_core_from_jd(double jd, double epoch, int64_t precision, moment_t *r);
+moment_status_t moment_core_from_mjd(double mjd, double epoch, int64_t precision, moment_t *r);
+
+moment_status_t moment_core_with_field(const moment_t *mt, moment_component_t c, int64_t v, moment_t *r);
+moment_status_t moment_core_with_offset_same_instant(const moment_t *mt, int64_t offset, moment_t *r);
+moment_status_t moment_core_with_offset_same_local(const moment_t *mt, int64_t offset, moment_t *r);
+moment_status_t moment_core_with_precision(const moment_t *mt, int64_t precision, moment_t *r);
+
+moment_status_t moment_core_plus_unit(const moment_t *mt, moment_unit_t u, int64_t v, moment_t *r);
+moment_status_t moment_core_minus_unit(const moment_t *mt, moment_unit_t u, int64_t v, moment_t *r);
+moment_status_t moment_core_plus_duration(const moment_t *mt, const moment_duration_t *d, moment_t *r);
+moment_status_t moment_core_minus_duration(const moment_t *mt, const moment_duration_t *d, moment_t *r);
+moment_status_t moment_core_plus_period(const moment_t *mt, const moment_period_t *p, moment_t *r);
+moment_status_t moment_core_minus_period(const moment_t *mt, const moment_period_t *p, moment_t *r);
+
+moment_status_t moment_core_delta_unit(const moment_t *mt1, const moment_t *mt2, moment_unit_t u, int64_t *r);
+
+moment_status_t moment_core_at_utc(const moment_t *mt, moment_t *r);
+moment_status_t moment_core_at_midnight(const moment_t *mt, moment_t *r);
+moment_status_t moment_core_at_noon(const moment_t *mt, moment_t *r);
+moment_status_t moment_core_at_last_day_of_year(const moment_t *mt, moment_t *r);
+moment_status_t moment_core_at_last_day_of_quarter(const moment_t *mt, moment_t *r);
+moment_status_t moment_core_at_last_day_of_month(const moment_t *mt, moment_t *r);
+
+moment_status_t moment_core_compare_precision(const moment_t *mt1, const moment_t *mt2, int64_t precision, int *r);
+
+moment_status_t moment_core_western_easter(int64_t y, int *rdn);
+moment_status_t moment_core_orthodox_easter(int64_t y, int *rdn);
+
+moment_duration_t moment_subtract_moment(const moment_t *mt1, const moment_t *mt2);
+
+void        moment_delta_ymd(const moment_t *mt1, const moment_t *mt2, int *y, int *m, int *d);
+void        moment_delta_yqd(const moment_t *mt1, const moment_t *mt2, int *y, int *q, int *d);
+void        moment_delta_ymdhms(const moment_t *mt1, const moment_t *mt2, int *y, int *m, int *d,
+                                int *h, int *mi, int *s, int *ns);
+
+int64_t     moment_instant_rd_seconds(const moment_t *mt);
+int64_t     moment_local_rd_seconds(const moment_t *mt);
+int         moment_instant_rd(const moment_t *mt);
+int         moment_local_rd(const moment_t *mt);
+
+dt_t        moment_local_dt(const moment_t *mt);
+
+int         moment_compare_instant(const moment_t *m1, const moment_t *m2);
+int         moment_compare_local(const moment_t *m1, const moment_t *m2);
+bool        moment_equals(const moment_t *m1, const moment_t *m2);
+
+int         moment_year(const moment_t *mt);
+int         moment_quarter(const moment_t *mt);
+int         moment_month(const moment_t *mt);
+int         moment_week(const moment_t *mt);
+int         moment_day_of_year(const moment_t *mt);
+int         moment_day_of_quarter(const moment_t *mt);
+int         moment_day_of_month(const moment_t *mt);
+int         moment_day_of_week(const moment_t *mt);
+int         moment_hour(const moment_t *mt);
+int         moment_minute(const moment_t *mt);
+int         moment_minute_of_day(const moment_t *mt);
+int         moment_second(const moment_t *mt);
+int         moment_second_of_day(const moment_t *mt);
+int         moment_millisecond(const moment_t *mt);
+int         moment_millisecond_of_day(const moment_t *mt);
+int         moment_microsecond(const moment_t *mt);
+int64_t     moment_microsecond_of_day(const moment_t *mt);
+int         moment_nanosecond(const moment_t *mt);
+int64_t     moment_nanosecond_of_day(const moment_t *mt);
+int         moment_offset(const moment_t *mt);
+int64_t     moment_epoch(const moment_t *mt);
+int         moment_precision(const moment_t *mt);
+int         moment_rata_die_day(const moment_t *mt);
+
+bool        moment_is_leap_year(const moment_t *mt);
+
+double      moment_jd(const moment_t *mt);
+double      moment_mjd(const moment_t *mt);
+double      moment_rd(const moment_t *mt);
+
+int         moment_length_of_year(const moment_t *mt);
+int         moment_length_of_quarter(const moment_t *mt);
+int         moment_length_of_month(const moment_t *mt);
+int         moment_length_of_week_year(const moment_t *mt);
+
+size_t      moment_to_string_buffer(const moment_t *mt, bool reduced, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,332 @@
+#include <string.h>
+#include "moment_cron.h"
+#include "moment_bits.h"
+#include "dt_core.h"
+#include "dt_util.h"
+
+#define CHECK(expr) do {                    \
+    const moment_status_t status_ = (expr); \
+    if (status_ != MOMENT_OK)               \
+        return status_;                     \
+} while (0)
+
+#define MIN_RDN         1
+#define MAX_RDN         3652059
+#define MINUTES_PER_DAY 1440
+
+static const char * const kMonthNames[] = {
+    "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+    "JUL", "AUG", "SEP", "OCT", "NOV", "DEC",
+};
+
+static const char * const kDayNames[] = {
+    "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT",
+};
+
+typedef struct {
+    const char *p;
+    const char *end;
+} cron_input_t;
+
+static int
+upper(int c) {
+    return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+/* Parses a number, or a three letter name numbered from base */
+static bool
+parse_value(cron_input_t *in, const char * const *names, int nnames, int base, int *v) {
+    const char *p = in->p;
+    int i, n = 0;
+
+    if (p < in->end && *p >= '0' && *p <= '9') {
+        do {
+            n = n * 10 + (*p++ - '0');
+            if (n > 99)
+                return false;
+        } while (p < in->end && *p >= '0' && *p <= '9');
+        in->p = p;
+        *v = n;
+        return true;
+    }
+    if (!names || in->end - p < 3)
+        return false;
+    for (i = 0; i < nnames; i++) {
+        if (upper(p[0]) == names[i][0] &&
+            upper(p[1]) == names[i][1] &&
+            upper(p[2]) == names[i][2]) {
+            in->p = p + 3;
+            *v = i + base;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Parses a comma separated list of '*', 'n' or 'n-m', each optionally followed by '/step' */
+static moment_status_t
+parse_field(cron_input_t *in, int min, int max, const char * const *names, int nnames,
+            int base, uint64_t *mask, bool *star) {
+    uint64_t bits = 0;
+    int lo, hi, step, v;
+
+    *star = in->p < in->end && *in->p == '*';
+    for (;;) {
+        if (in->p < in->end && *in->p == '*') {
+            in->p++;
+            lo = min, hi = max;
+        }
+        else {
+            if (!parse_value(in, names, nnames, base, &lo))
+                return MOMENT_ERR_CRON_SYNTAX;
+            hi = lo;
+            if (in->p < in->end && *in->p == '-') {
+                in->p++;
+                if (!parse_value(in, names, nnames, base, &hi))
+                    return MOMENT_ERR_CRON_SYNTAX;
+            }
+            else if (in->p < in->end && *in->p == '/')
+                hi = max;
+            if (lo < min || hi > max || lo > hi)
+                return MOMENT_ERR_CRON_SYNTAX;
+        }
+        step = 1;
+        if (in->p < in->end && *in->p == '/') {
+            in->p++;
+            if (!parse_value(in, NULL, 0, 0, &step) || step < 1)
+                return MOMENT_ERR_CRON_SYNTAX;
+        }
+        for (v = lo; v <= hi; v += step)
+            bits |= UINT64_C(1) << v;
+        if (in->p == in->end || *in->p != ',')
+            break;
+        in->p++;
+    }
+    *mask = bits;
+    return MOMENT_OK;
+}
+
+static bool
+is_space(int c) {
+    return c == ' ' || c == '\t';
+}
+
+static void
+skip_space(cron_input_t *in) {
+    while (in->p < in->end && is_space(*in->p))
+        in->p++;
+}
+
+static const struct {
+    const char *name;
+    const char *expr;
+} kMacros[] = {
+    { "@yearly",   "0 0 1 1 *" },
+    { "@annually", "0 0 1 1 *" },
+    { "@monthly",  "0 0 1 * *" },
+    { "@weekly",   "0 0 * * 0" },
+    { "@daily",    "0 0 * * *" },
+    { "@midnight", "0 0 * * *" },
+    { "@hourly",   "0 * * * *" },
+};
+
+moment_status_t
+moment_core_cron_parse(const char *str, size_t len, moment_cron_t *r) {
+    moment_cron_t cron;
+    cron_input_t in;
+    uint64_t mask;
+    bool star;
+    size_t i;
+    int m;
+
+    in.p = str;
+    in.end = str + len;
+    skip_space(&in);
+    if (in.p < in.end && *in.p == '@') {
+        const char *p = in.p;
+        while (p < in.end && !is_space(*p))
+            p++;
+        for (i = 0; i < sizeof(kMacros) / sizeof(kMacros[0]); i++) {
+            const size_t n = strlen(kMacros[i].name);
+            if ((size_t)(p - in.p) == n && memcmp(in.p, kMacros[i].name, n) == 0)
+                break;
+        }
+        if (i == sizeof(kMacros) / sizeof(kMacros[0]))
+            return MOMENT_ERR_CRON_SYNTAX;
+        in.p = p;
+        skip_space(&in);
+        if (in.p != in.end)
+            return MOMENT_ERR_CRON_SYNTAX;
+        return moment_core_cron_parse(kMacros[i].expr, strlen(kMacros[i].expr), r);
+    }
+
+    memset(&cron, 0, sizeof(cron));
+    CHECK(parse_field(&in, 0, 59, NULL, 0, 0, &mask, &star));
+    cron.minutes = mask;
+    if (in.p == in.end || !is_space(*in.p))
+        return MOMENT_ERR_CRON_SYNTAX;
+    skip_space(&in);
+    CHECK(parse_field(&in, 0, 23, NULL, 0, 0, &mask, &star));
+    cron.hours = (uint32_t)mask;
+    if (in.p == in.end || !is_space(*in.p))
+        return MOMENT_ERR_CRON_SYNTAX;
+    skip_space(&in);
+    CHECK(parse_field(&in, 1, 31, NULL, 0, 0, &mask, &star));
+    cron.days = (uint32_t)mask;
+    if (star)
+        cron.flags |= MOMENT_CRON_DOM_STAR;
+    if (in.p == in.end || !is_space(*in.p))
+        return MOMENT_ERR_CRON_SYNTAX;
+    skip_space(&in);
+    CHECK(parse_field(&in, 1, 12, kMonthNames, 12, 1, &mask, &star));
+    cron.months = (uint16_t)mask;
+    if (in.p == in.end || !is_space(*in.p))
+        return MOMENT_ERR_CRON_SYNTAX;
+    skip_space(&in);
+    CHECK(parse_field(&in, 0, 7, kDayNames, 7, 0, &mask, &star));
+    /* Sunday is both 0 and 7 */
+    cron.weekdays = (uint8_t)((mask | (mask & 1) << 7) & 0xFE);
+    if (star)
+        cron.flags |= MOMENT_CRON_DOW_STAR;
+    skip_space(&in);
+    if (in.p != in.end)
+        return MOMENT_ERR_CRON_SYNTAX;
+
+    /* A day of month alone must exist in one of the months, February 29 included */
+    if ((cron.flags & MOMENT_CRON_DOW_STAR) && !(cron.flags & MOMENT_CRON_DOM_STAR)) {
+        for (m = 1; m <= 12; m++) {
+            const int days = m == 2 ? 29 : dt_days_in_month(1, m);
+            if ((cron.months >> m & 1) && (cron.days & ((UINT32_C(2) << days) - 1)))
+                break;
+        }
+        if (m > 12)
+            return MOMENT_ERR_CRON_NEVER;
+    }
+    *r = cron;
+    return MOMENT_OK;
+}
+
+static bool
+day_matches(const moment_cron_t *cron, dt_t dt, int d) {
+    const bool dom = (cron->days >> d) & 1;
+    const bool dow = (cron->weekdays >> dt_dow(dt)) & 1;
+
+    if (cron->flags & (MOMENT_CRON_DOM_STAR | MOMENT_CRON_DOW_STAR))
+        return dom && dow;
+    return dom || dow;
+}
+
+static void
+cron_result(const moment_t *mt, int rdn, int h, int m, moment_t *r) {
+    r->sec    = (int64_t)rdn * 86400 + h * 3600 + m * 60;
+    r->nsec   = 0;
+    r->offset = mt->offset;
+}
+
+bool
+moment_cron_matches(const moment_cron_t *cron, const moment_t *mt) {
+    const int sod = (int)(moment_local_rd_seconds(mt) % 86400);
+    const dt_t dt = moment_local_dt(mt);
+    int y, m, d;
+
+    dt_to_ymd(dt, &y, &m, &d);
+    return ((cron->months >> m) & 1)
+        && day_matches(cron, dt, d)
+        && ((cron->hours >> (sod / 3600)) & 1)
+        && ((cron->minutes >> (sod / 60 % 60)) & 1);
+}
+
+/* Stores the first minute of the schedule after mt, or returns false if there is none */
+bool
+moment_cron_next(const moment_cron_t *cron, const moment_t *mt, moment_t *r) {
+    const int64_t t = moment_local_rd_seconds(mt) / 60 + 1;
+    int rdn = (int)(t / MINUTES_PER_DAY);
+    int mod = (int)(t % MINUTES_PER_DAY);
+    int y, m, d;
+
+    while (rdn <= MAX_RDN) {
+        const dt_t dt = dt_from_rdn(rdn);
+        uint64_t bits;
+        int h;
+
+        dt_to_ymd(dt, &y, &m, &d);
+        if (!((cron->months >> m) & 1)) {
+            /* Jump to the first day of the next month of the schedule */
+            bits = cron->months & ~((UINT64_C(2) << m) - 1);
+            if (bits)
+                m = ctz64(bits);
+            else
+                y++, m = ctz64(cron->months);
+            rdn = dt_rdn(dt_from_ymd(y, m, 1));
+            mod = 0;
+            continue;
+        }
+        if (day_matches(cron, dt, d)) {
+            h = mod / 60;
+            if ((cron->hours >> h) & 1) {
+                bits = cron->minutes & ~((UINT64_C(1) << (mod % 60)) - 1);
+                if (bits) {
+                    cron_result(mt, rdn, h, ctz64(bits), r);
+                    return true;
+                }
+            }
+            bits = cron->hours & ~((UINT64_C(2) << h) - 1);
+            if (bits) {
+                cron_result(mt, rdn, ctz64(bits), ctz64(cron->minutes), r);
+                return true;
+            }
+        }
+        rdn++;
+        mod = 0;
+    }
+    return false;
+}
+
+/* Stores the last minute of the schedule before mt, or returns false if there is none */
+bool
+moment_cron_prev(const moment_cron_t *cron, const moment_t *mt, moment_t *r) {
+    const int64_t sec = moment_local_rd_seconds(mt);
+    const int64_t t = sec / 60 - ((sec % 60 == 0 && mt->nsec == 0) ? 1 : 0);
+    int rdn = (int)(t / MINUTES_PER_DAY);
+    int mod = (int)(t % MINUTES_PER_DAY);
+    int y, m, d;
+
+    while (rdn >= MIN_RDN) {
+        const dt_t dt = dt_from_rdn(rdn);
+        uint64_t bits;
+        int h;
+
+        dt_to_ymd(dt, &y, &m, &d);
+        if (!((cron->months >> m) & 1)) {
+            /* Jump to the last day of the previous month of the schedule */
+            bits = cron->months & ((UINT64_C(1) << m) - 1);
+            if (bits)
+                m = 63 - clz64(bits);
+            else
+                y--, m = 63 - clz64(cron->months);
+            if (y < 1)
+                break;
+            rdn = dt_rdn(dt_from_ymd(y, m + 1, 0));
+            mod = MINUTES_PER_DAY - 1;
+            continue;
+        }
+        if (day_matches(cron, dt, d)) {
+            h = mod / 60;
+            if ((cron->hours >> h) & 1) {
+                bits = cron->minutes & ((UINT64_C(2) << (mod % 60)) - 1);
+                if (bits) {
+                    cron_result(mt, rdn, h, 63 - clz64(bits), r);
+                    return true;
+                }
+            }
+            bits = cron->hours & ((UINT64_C(1) << h) - 1);
+            if (bits) {
+                cron_result(mt, rdn, 63 - clz64(bits), 63 - clz64(cron->minutes), r);
+                return true;
+            }
+        }
+        rdn--;
+        mod = MINUTES_PER_DAY - 1;
+    }
+    return false;
+}
@@ -0,0 +1,38 @@
+#ifndef __MOMENT_CRON_H__
+#define __MOMENT_CRON_H__
+#include "moment_core.h"
+
+/*
+ * Cron schedules: the five fields of a crontab(5) time specification,
+ * minute, hour, day of month, month and day of week, compiled to one
+ * bitmask per field. As in Vixie cron, a day matches both the day of month
+ * and the day of week if either field begins with '*', otherwise it
+ * matches either of them.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOMENT_CRON_DOM_STAR    0x01
+#define MOMENT_CRON_DOW_STAR    0x02
+
+typedef struct {
+    uint64_t minutes;   /* bits 0-59 */
+    uint32_t hours;     /* bits 0-23 */
+    uint32_t days;      /* bits 1-31 */
+    uint16_t months;    /* bits 1-12 */
+    uint8_t  weekdays;  /* bits 1-7, where 1 is Monday */
+    uint8_t  flags;
+} moment_cron_t;
+
+moment_status_t moment_core_cron_parse(const char *str, size_t len, moment_cron_t *r);
+
+bool    moment_cron_matches(const moment_cron_t *cron, const moment_t *mt);
+bool    moment_cron_next(const moment_cron_t *cron, const moment_t *mt, moment_t *r);
+bool    moment_cron_prev(const moment_cron_t *cron, const moment_t *mt, moment_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,208 @@
+#include "moment_duration.h"
+
+#define CHECK(expr) do {                    \
+    const moment_status_t status_ = (expr); \
+    if (status_ != MOMENT_OK)               \
+        return status_;                     \
+} while (0)
+
+static moment_status_t
+check_duration(int64_t sec, int32_t nsec) {
+    if (sec < MIN_DURATION_SECONDS || sec > MAX_DURATION_SECONDS
+        || (sec == MAX_DURATION_SECONDS && nsec != 0))
+        return MOMENT_ERR_DURATION_RANGE;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+check_unit(int64_t v, int64_t min, int64_t max, moment_status_t status) {
+    if (v < min || v > max)
+        return status;
+    return MOMENT_OK;
+}
+
+/* Stores sec + nsec/10^9, where nsec is any value, as a normalized duration */
+static moment_status_t
+duration_normalize(int64_t sec, int64_t nsec, moment_duration_t *r) {
+    static const int64_t kMaxCarry = INT64_C(10000000000);
+
+    /* nsec contributes at most 9223372036 seconds */
+    if (sec < MIN_DURATION_SECONDS - kMaxCarry || sec > MAX_DURATION_SECONDS + kMaxCarry)
+        return MOMENT_ERR_DURATION_RANGE;
+
+    sec += nsec / NANOS_PER_SEC;
+    nsec %= NANOS_PER_SEC;
+    if (nsec < 0) {
+        nsec += NANOS_PER_SEC;
+        sec--;
+    }
+    CHECK(check_duration(sec, (int32_t)nsec));
+    r->sec  = sec;
+    r->nsec = (int32_t)nsec;
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_duration_new(int64_t sec, int64_t nsec, moment_duration_t *r) {
+    return duration_normalize(sec, nsec, r);
+}
+
+moment_status_t
+moment_core_duration_from_unit(moment_unit_t u, int64_t v, moment_duration_t *r) {
+    switch (u) {
+        case MOMENT_UNIT_WEEKS:
+            CHECK(check_unit(v, MIN_UNIT_WEEKS, MAX_UNIT_WEEKS, MOMENT_ERR_PARAM_WEEKS));
+            return duration_normalize(v * 604800, 0, r);
+        case MOMENT_UNIT_DAYS:
+            CHECK(check_unit(v, MIN_UNIT_DAYS, MAX_UNIT_DAYS, MOMENT_ERR_PARAM_DAYS));
+            return duration_normalize(v * 86400, 0, r);
+        case MOMENT_UNIT_HOURS:
+            CHECK(check_unit(v, MIN_UNIT_HOURS, MAX_UNIT_HOURS, MOMENT_ERR_PARAM_HOURS));
+            return duration_normalize(v * 3600, 0, r);
+        case MOMENT_UNIT_MINUTES:
+            CHECK(check_unit(v, MIN_UNIT_MINUTES, MAX_UNIT_MINUTES, MOMENT_ERR_PARAM_MINUTES));
+            return duration_normalize(v * 60, 0, r);
+        case MOMENT_UNIT_SECONDS:
+            CHECK(check_unit(v, MIN_UNIT_SECONDS, MAX_UNIT_SECONDS, MOMENT_ERR_PARAM_SECONDS));
+            return duration_normalize(v, 0, r);
+        case MOMENT_UNIT_MILLIS:
+            CHECK(check_unit(v, MIN_UNIT_MILLIS, MAX_UNIT_MILLIS, MOMENT_ERR_PARAM_MILLISECONDS));
+            return duration_normalize(v / 1000, (v % 1000) * 1000000, r);
+        case MOMENT_UNIT_MICROS:
+            CHECK(check_unit(v, MIN_UNIT_MICROS, MAX_UNIT_MICROS, MOMENT_ERR_PARAM_MICROSECONDS));
+            return duration_normalize(v / 1000000, (v % 1000000) * 1000, r);
+        case MOMENT_UNIT_NANOS:
+            return duration_normalize(0, v, r);
+        default:
+            break;
+    }
+    return MOMENT_ERR_UNIT;
+}
+
+/* Truncates the same way as the delta_* methods of Time::Moment */
+moment_status_t
+moment_core_duration_to_unit(const moment_duration_t *d, moment_unit_t u, int64_t *r) {
+    static const int64_t kMaxSec = INT64_C(9223372035);
+
+    switch (u) {
+        case MOMENT_UNIT_WEEKS:
+            *r = d->sec / 604800;
+            return MOMENT_OK;
+        case MOMENT_UNIT_DAYS:
+            *r = d->sec / 86400;
+            return MOMENT_OK;
+        case MOMENT_UNIT_HOURS:
+            *r = d->sec / 3600;
+            return MOMENT_OK;
+        case MOMENT_UNIT_MINUTES:
+            *r = d->sec / 60;
+            return MOMENT_OK;
+        case MOMENT_UNIT_SECONDS:
+            *r = d->sec;
+            return MOMENT_OK;
+        case MOMENT_UNIT_MILLIS:
+            *r = d->sec * 1000 + (d->nsec / 1000000);
+            return MOMENT_OK;
+        case MOMENT_UNIT_MICROS:
+            *r = d->sec * 1000000 + (d->nsec / 1000);
+            return MOMENT_OK;
+        case MOMENT_UNIT_NANOS:
+            if (d->sec > kMaxSec || d->sec < -kMaxSec)
+                return MOMENT_ERR_NANOS_OVERFLOW;
+            *r = d->sec * 1000000000 + d->nsec;
+            return MOMENT_OK;
+        default:
+            break;
+    }
+    return MOMENT_ERR_UNIT;
+}
+
+moment_status_t
+moment_core_duration_add(const moment_duration_t *d1, const moment_duration_t *d2, moment_duration_t *r) {
+    return duration_normalize(d1->sec + d2->sec, (int64_t)d1->nsec + d2->nsec, r);
+}
+
+moment_status_t
+moment_core_duration_subtract(const moment_duration_t *d1, const moment_duration_t *d2, moment_duration_t *r) {
+    return duration_normalize(d1->sec - d2->sec, (int64_t)d1->nsec - d2->nsec, r);
+}
+
+/*
+ * The product is formed from the magnitudes, splitting the factor at 10^9
+ * so that no intermediate result can overflow, and the sign is applied last.
+ */
+moment_status_t
+moment_core_duration_multiply(const moment_duration_t *d, int64_t n, moment_duration_t *r) {
+    static const uint64_t kMaxSec = (uint64_t)MAX_DURATION_SECONDS;
+    uint64_t s, ns, m, hi, lo, sec;
+    int neg;
+
+    neg = (d->sec < 0) != (n < 0);
+    if (d->sec < 0) {
+        s  = (uint64_t)-(d->sec + (d->nsec != 0));
+        ns = d->nsec != 0 ? NANOS_PER_SEC - d->nsec : 0;
+    }
+    else {
+        s  = (uint64_t)d->sec;
+        ns = (uint64_t)d->nsec;
+    }
+    m = n < 0 ? (uint64_t)-(n + 1) + 1 : (uint64_t)n;
+
+    if (s && m > kMaxSec / s)
+        return MOMENT_ERR_DURATION_RANGE;
+    sec = s * m;
+
+    hi = m / NANOS_PER_SEC;
+    lo = m % NANOS_PER_SEC;
+    if (ns && hi > kMaxSec / ns)
+        return MOMENT_ERR_DURATION_RANGE;
+    sec += ns * hi;
+
+    ns  *= lo;
+    sec += ns / NANOS_PER_SEC;
+    ns  %= NANOS_PER_SEC;
+    if (sec > kMaxSec)
+        return MOMENT_ERR_DURATION_RANGE;
+
+    if (neg)
+        return duration_normalize(-(int64_t)sec, -(int64_t)ns, r);
+    return duration_normalize((int64_t)sec, (int64_t)ns, r);
+}
+
+moment_duration_t
+moment_duration_negate(const moment_duration_t *d) {
+    moment_duration_t r;
+
+    if (d->nsec == 0) {
+        r.sec  = -d->sec;
+        r.nsec = 0;
+    }
+    else {
+        r.sec  = -d->sec - 1;
+        r.nsec = NANOS_PER_SEC - d->nsec;
+    }
+    return r;
+}
+
+moment_duration_t
+moment_duration_abs(const moment_duration_t *d) {
+    if (d->sec < 0)
+        return moment_duration_negate(d);
+    return *d;
+}
+
+int
+moment_duration_compare(const moment_duration_t *d1, const moment_duration_t *d2) {
+    if (d1->sec != d2->sec)
+        return d1->sec < d2->sec ? -1 : 1;
+    if (d1->nsec != d2->nsec)
+        return d1->nsec < d2->nsec ? -1 : 1;
+    return 0;
+}
+
+int
+moment_duration_sign(const moment_duration_t *d) {
+    if (d->sec < 0)
+        return -1;
+    return (d->sec > 0 || d->nsec > 0);
+}
@@ -0,0 +1,37 @@
+#ifndef __MOMENT_DURATION_H__
+#define __MOMENT_DURATION_H__
+#include "moment_core.h"
+
+/*
+ * Exact durations, as produced by moment_subtract_moment(). The seconds
+ * carry the sign and the nanoseconds are always in the range
+ * [0, 999999999], so -1.5 seconds is represented as {-2, 500000000}.
+ * A duration is limited to the span of MAX_UNIT_SECONDS in either
+ * direction, which covers the difference of any two moments.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIN_DURATION_SECONDS MIN_UNIT_SECONDS
+#define MAX_DURATION_SECONDS MAX_UNIT_SECONDS
+
+moment_status_t moment_core_duration_new(int64_t sec, int64_t nsec, moment_duration_t *r);
+moment_status_t moment_core_duration_from_unit(moment_unit_t u, int64_t v, moment_duration_t *r);
+moment_status_t moment_core_duration_to_unit(const moment_duration_t *d, moment_unit_t u, int64_t *r);
+
+moment_status_t moment_core_duration_add(const moment_duration_t *d1, const moment_duration_t *d2, moment_duration_t *r);
+moment_status_t moment_core_duration_subtract(const moment_duration_t *d1, const moment_duration_t *d2, moment_duration_t *r);
+moment_status_t moment_core_duration_multiply(const moment_duration_t *d, int64_t n, moment_duration_t *r);
+
+moment_duration_t moment_duration_negate(const moment_duration_t *d);
+moment_duration_t moment_duration_abs(const moment_duration_t *d);
+
+int         moment_duration_compare(const moment_duration_t *d1, const moment_duration_t *d2);
+int         moment_duration_sign(const moment_duration_t *d);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,4 +1,5 @@
 #include "moment.h"
+#include "moment_iso.h"
 #include "dt_core.h"
 #include "dt_accessor.h"
 
@@ -463,45 +464,29 @@ THX_moment_strftime(pTHX_ const moment_t *mt, const char *s, STRLEN len) {
 SV *
 THX_moment_to_string(pTHX_ const moment_t *mt, bool reduced) {
     SV *dsv;
-    dt_t dt;
-    int year, month, day, sec, ns, offset, sign;
 
-    dsv = sv_2mortal(newSV(16));
-    SvCUR_set(dsv, 0);
+    dsv = sv_2mortal(newSV(MOMENT_STRING_MAX));
     SvPOK_only(dsv);
+    SvCUR_set(dsv, moment_to_string_buffer(mt, reduced, SvPVX(dsv), MOMENT_STRING_MAX));
+    return dsv;
+}
 
-    dt = moment_local_dt(mt);
-    dt_to_ymd(dt, &year, &month, &day);
-
-    sv_catpvf(dsv, "%04d-%02d-%02dT%02d:%02d",
-        year, month, day, moment_hour(mt), moment_minute(mt));
-
-    sec = moment_second(mt);
-    ns  = moment_nanosecond(mt);
-    if (!reduced || sec || ns) {
-        sv_catpvf(dsv, ":%02d", sec);
-        if (ns) {
-            if      ((ns % 1000000) == 0) sv_catpvf(dsv, ".%03d", ns / 1000000);
-            else if ((ns % 1000)    == 0) sv_catpvf(dsv, ".%06d", ns / 1000);
-            else                          sv_catpvf(dsv, ".%09d", ns);
-        }
-    }
+SV *
+THX_moment_duration_to_string(pTHX_ const moment_duration_t *d) {
+    SV *dsv;
 
-    offset = moment_offset(mt);
-    if (offset == 0)
-        sv_catpvn(dsv, "Z", 1);
-    else {
-        if (offset < 0)
-            sign = '-', offset = -offset;
-        else
-            sign = '+';
+    dsv = sv_2mortal(newSV(MOMENT_PERIOD_STRING_MAX));
+    SvPOK_only(dsv);
+    SvCUR_set(dsv, moment_duration_to_string_buffer(d, SvPVX(dsv), MOMENT_PERIOD_STRING_MAX));
+    return dsv;
+}
 
-        if (reduced && (offset % 60) == 0)
-            sv_catpvf(dsv, "%c%02d", sign, offset / 60);
-        else
-            sv_catpvf(dsv, "%c%02d:%02d", sign, offset / 60, offset % 60);
-    }
+SV *
+THX_moment_interval_to_string(pTHX_ const moment_t *start, const moment_t *end) {
+    SV *dsv;
 
+    dsv = sv_2mortal(newSV(2 * MOMENT_STRING_MAX));
+    SvPOK_only(dsv);
+    SvCUR_set(dsv, moment_interval_to_string_buffer(start, end, SvPVX(dsv), 2 * MOMENT_STRING_MAX));
     return dsv;
 }
-
@@ -4,6 +4,8 @@
 
 SV * THX_moment_strftime(pTHX_ const moment_t *mt, const char *str, STRLEN len);
 SV * THX_moment_to_string(pTHX_ const moment_t *mt, bool reduced);
+SV * THX_moment_duration_to_string(pTHX_ const moment_duration_t *d);
+SV * THX_moment_interval_to_string(pTHX_ const moment_t *start, const moment_t *end);
 
 #define moment_strftime(mt, str, len) \
     THX_moment_strftime(aTHX_ mt, str, len)
@@ -11,5 +13,11 @@ SV * THX_moment_to_string(pTHX_ const moment_t *mt, bool reduced);
 #define moment_to_string(mt, reduced) \
     THX_moment_to_string(aTHX_ mt, reduced)
 
+#define moment_duration_to_string(d) \
+    THX_moment_duration_to_string(aTHX_ d)
+
+#define moment_interval_to_string(start, end) \
+    THX_moment_interval_to_string(aTHX_ start, end)
+
 #endif
 
@@ -0,0 +1,178 @@
+#include <stdlib.h>
+#include "moment_interval.h"
+
+#define CMP(m1, m2) moment_compare_instant(m1, m2)
+
+moment_status_t
+moment_core_interval_new(const moment_t *start, const moment_t *end, moment_interval_t *r) {
+    if (CMP(start, end) > 0)
+        return MOMENT_ERR_INTERVAL_ORDER;
+    r->start = *start;
+    r->end   = *end;
+    return MOMENT_OK;
+}
+
+bool
+moment_interval_is_empty(const moment_interval_t *iv) {
+    return CMP(&iv->start, &iv->end) >= 0;
+}
+
+bool
+moment_interval_contains(const moment_interval_t *iv, const moment_t *mt) {
+    return CMP(&iv->start, mt) <= 0 && CMP(mt, &iv->end) < 0;
+}
+
+bool
+moment_interval_overlaps(const moment_interval_t *iv1, const moment_interval_t *iv2) {
+    return CMP(&iv1->start, &iv2->end) < 0
+        && CMP(&iv2->start, &iv1->end) < 0
+        && !moment_interval_is_empty(iv1)
+        && !moment_interval_is_empty(iv2);
+}
+
+bool
+moment_interval_intersection(const moment_interval_t *iv1, const moment_interval_t *iv2, moment_interval_t *r) {
+    const moment_t *start, *end;
+
+    start = CMP(&iv1->start, &iv2->start) >= 0 ? &iv1->start : &iv2->start;
+    end   = CMP(&iv1->end, &iv2->end) <= 0 ? &iv1->end : &iv2->end;
+    if (CMP(start, end) >= 0)
+        return false;
+    r->start = *start;
+    r->end   = *end;
+    return true;
+}
+
+bool
+moment_interval_equals(const moment_interval_t *iv1, const moment_interval_t *iv2) {
+    return CMP(&iv1->start, &iv2->start) == 0
+        && CMP(&iv1->end, &iv2->end) == 0;
+}
+
+static int
+interval_compare(const void *p1, const void *p2) {
+    const moment_interval_t *iv1 = (const moment_interval_t *)p1;
+    const moment_interval_t *iv2 = (const moment_interval_t *)p2;
+    int r;
+
+    r = CMP(&iv1->start, &iv2->start);
+    if (r == 0)
+        r = CMP(&iv1->end, &iv2->end);
+    return r;
+}
+
+/* Appends iv to the canonical set r of n intervals, which must not start after iv */
+static size_t
+interval_append(moment_interval_t *r, size_t n, const moment_interval_t *iv) {
+    if (n > 0 && CMP(&iv->start, &r[n - 1].end) <= 0) {
+        if (CMP(&iv->end, &r[n - 1].end) > 0)
+            r[n - 1].end = iv->end;
+        return n;
+    }
+    r[n] = *iv;
+    return n + 1;
+}
+
+/* Sorts and coalesces the n intervals of iv in place and returns the new count */
+size_t
+moment_interval_set_normalize(moment_interval_t *iv, size_t n) {
+    size_t i, c;
+
+    qsort(iv, n, sizeof(moment_interval_t), interval_compare);
+    for (i = 0, c = 0; i < n; i++) {
+        if (!moment_interval_is_empty(&iv[i]))
+            c = interval_append(iv, c, &iv[i]);
+    }
+    return c;
+}
+
+/* Returns the index of the first interval that ends after mt, or n if none does */
+size_t
+moment_interval_set_search(const moment_interval_t *iv, size_t n, const moment_t *mt) {
+    size_t lo = 0, hi = n;
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (CMP(&iv[mid].end, mt) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+bool
+moment_interval_set_contains(const moment_interval_t *iv, size_t n, const moment_t *mt) {
+    const size_t i = moment_interval_set_search(iv, n, mt);
+    return i < n && CMP(&iv[i].start, mt) <= 0;
+}
+
+bool
+moment_interval_set_overlaps(const moment_interval_t *iv, size_t n, const moment_interval_t *other) {
+    size_t i;
+
+    if (moment_interval_is_empty(other))
+        return false;
+    i = moment_interval_set_search(iv, n, &other->start);
+    return i < n && CMP(&iv[i].start, &other->end) < 0;
+}
+
+size_t
+moment_interval_set_union(const moment_interval_t *a, size_t na,
+                          const moment_interval_t *b, size_t nb, moment_interval_t *r) {
+    size_t i = 0, j = 0, n = 0;
+
+    while (i < na || j < nb) {
+        if (j == nb || (i < na && CMP(&a[i].start, &b[j].start) <= 0))
+            n = interval_append(r, n, &a[i++]);
+        else
+            n = interval_append(r, n, &b[j++]);
+    }
+    return n;
+}
+
+size_t
+moment_interval_set_intersection(const moment_interval_t *a, size_t na,
+                                 const moment_interval_t *b, size_t nb, moment_interval_t *r) {
+    size_t i = 0, j = 0, n = 0;
+
+    while (i < na && j < nb) {
+        if (moment_interval_intersection(&a[i], &b[j], &r[n]))
+            n++;
+        if (CMP(&a[i].end, &b[j].end) < 0)
+            i++;
+        else
+            j++;
+    }
+    return n;
+}
+
+size_t
+moment_interval_set_difference(const moment_interval_t *a, size_t na,
+                               const moment_interval_t *b, size_t nb, moment_interval_t *r) {
+    size_t i, j = 0, k, n = 0;
+
+    for (i = 0; i < na; i++) {
+        moment_t start = a[i].start;
+
+        while (j < nb && CMP(&b[j].end, &start) <= 0)
+            j++;
+        /* b[j] may also cover the following interval of a, so scan with k */
+        for (k = j; k < nb && CMP(&b[k].start, &a[i].end) < 0; k++) {
+            if (CMP(&b[k].start, &start) > 0) {
+                r[n].start = start;
+                r[n].end   = b[k].start;
+                n++;
+            }
+            start = b[k].end;
+            if (CMP(&start, &a[i].end) >= 0)
+                break;
+        }
+        if (CMP(&start, &a[i].end) < 0) {
+            r[n].start = start;
+            r[n].end   = a[i].end;
+            n++;
+        }
+    }
+    return n;
+}
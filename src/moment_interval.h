@@ -0,0 +1,48 @@
+#ifndef __MOMENT_INTERVAL_H__
+#define __MOMENT_INTERVAL_H__
+#include "moment_core.h"
+
+/*
+ * Half-open intervals [start, end) on the time-line and sets of them.
+ *
+ * A set is an array of intervals in canonical form: sorted by instant,
+ * none empty, and each ending strictly before the next one starts, so that
+ * overlapping and adjacent intervals are always coalesced. The set
+ * operations take their operands in canonical form and store a canonical
+ * result in r, which must have room for na + nb intervals and must not
+ * alias either operand; they return the number of intervals stored.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    moment_t start;
+    moment_t end;
+} moment_interval_t;
+
+moment_status_t moment_core_interval_new(const moment_t *start, const moment_t *end, moment_interval_t *r);
+
+bool        moment_interval_is_empty(const moment_interval_t *iv);
+bool        moment_interval_contains(const moment_interval_t *iv, const moment_t *mt);
+bool        moment_interval_overlaps(const moment_interval_t *iv1, const moment_interval_t *iv2);
+bool        moment_interval_intersection(const moment_interval_t *iv1, const moment_interval_t *iv2, moment_interval_t *r);
+bool        moment_interval_equals(const moment_interval_t *iv1, const moment_interval_t *iv2);
+
+size_t      moment_interval_set_normalize(moment_interval_t *iv, size_t n);
+size_t      moment_interval_set_search(const moment_interval_t *iv, size_t n, const moment_t *mt);
+bool        moment_interval_set_contains(const moment_interval_t *iv, size_t n, const moment_t *mt);
+bool        moment_interval_set_overlaps(const moment_interval_t *iv, size_t n, const moment_interval_t *other);
+
+size_t      moment_interval_set_union(const moment_interval_t *a, size_t na,
+                                      const moment_interval_t *b, size_t nb, moment_interval_t *r);
+size_t      moment_interval_set_intersection(const moment_interval_t *a, size_t na,
+                                             const moment_interval_t *b, size_t nb, moment_interval_t *r);
+size_t      moment_interval_set_difference(const moment_interval_t *a, size_t na,
+                                           const moment_interval_t *b, size_t nb, moment_interval_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,326 @@
+#include <string.h>
+#include "moment_iso.h"
+#include "moment_duration.h"
+
+#define CHECK(expr) do {                    \
+    const moment_status_t status_ = (expr); \
+    if (status_ != MOMENT_OK)               \
+        return status_;                     \
+} while (0)
+
+enum {
+    DESIGNATOR_YEARS=0,
+    DESIGNATOR_MONTHS,
+    DESIGNATOR_WEEKS,
+    DESIGNATOR_DAYS,
+    DESIGNATOR_HOURS,
+    DESIGNATOR_MINUTES,
+    DESIGNATOR_SECONDS,
+};
+
+static size_t
+count_digits(const unsigned char *p, size_t i, size_t len) {
+    const size_t n = i;
+
+    for (; i < len; i++) {
+        const unsigned char c = p[i] - '0';
+        if (c > 9)
+            break;
+    }
+    return i - n;
+}
+
+static int64_t
+parse_number(const unsigned char *p, size_t i, size_t n) {
+    int64_t v = 0;
+
+    while (n--)
+        v = v * 10 + (p[i++] - '0');
+    return v;
+}
+
+/*
+ *  [+-]PnYnMnWnDTnHnMnS
+ *
+ *  Every component is optional, but at least one must be present and they
+ *  must appear in this order. The last component may have a decimal
+ *  fraction when it is hours, minutes or seconds. The sign is an extension
+ *  of ISO 8601-2. Returns the number of characters parsed, or 0.
+ */
+size_t
+moment_parse_iso_period(const char *str, size_t len, moment_period_t *r) {
+    const unsigned char *p = (const unsigned char *)str;
+    moment_period_t v;
+    size_t i, n;
+    int last, count;
+    bool time, fraction;
+
+    memset(&v, 0, sizeof(v));
+    v.sign = 1;
+
+    i = 0;
+    if (i < len && (p[i] == '+' || p[i] == '-'))
+        v.sign = p[i++] == '-' ? -1 : 1;
+    if (i >= len || p[i++] != 'P')
+        return 0;
+
+    last = -1;
+    count = 0;
+    time = fraction = false;
+    while (i < len) {
+        int64_t number, f = 0;
+        bool has_fraction = false;
+        int d;
+
+        if (p[i] == 'T') {
+            if (time)
+                return 0;
+            time = true;
+            i++;
+            continue;
+        }
+
+        n = count_digits(p, i, len);
+        if (n == 0)
+            break;
+        if (n > 18 || fraction)
+            return 0;
+        number = parse_number(p, i, n);
+        i += n;
+
+        if (i < len && (p[i] == '.' || p[i] == ',')) {
+            size_t nf = count_digits(p, ++i, len);
+            if (nf == 0)
+                return 0;
+            f = parse_number(p, i, nf > 9 ? 9 : nf);
+            for (n = nf; n < 9; n++)
+                f *= 10;
+            i += nf;
+            fraction = has_fraction = true;
+        }
+
+        if (i >= len)
+            return 0;
+        switch (p[i++]) {
+            case 'Y': d = time ? -1 : DESIGNATOR_YEARS;  break;
+            case 'W': d = time ? -1 : DESIGNATOR_WEEKS;  break;
+            case 'D': d = time ? -1 : DESIGNATOR_DAYS;   break;
+            case 'H': d = time ? DESIGNATOR_HOURS : -1;  break;
+            case 'S': d = time ? DESIGNATOR_SECONDS : -1; break;
+            case 'M': d = time ? DESIGNATOR_MINUTES : DESIGNATOR_MONTHS; break;
+            default:  d = -1; break;
+        }
+        if (d <= last)
+            return 0;
+        if (has_fraction && d < DESIGNATOR_HOURS)
+            return 0;
+        last = d;
+        count++;
+
+        switch (d) {
+            case DESIGNATOR_YEARS:   v.years   = number; break;
+            case DESIGNATOR_MONTHS:  v.months  = number; break;
+            case DESIGNATOR_WEEKS:   v.weeks   = number; break;
+            case DESIGNATOR_DAYS:    v.days    = number; break;
+            case DESIGNATOR_HOURS:   v.hours   = number; f *= 3600; break;
+            case DESIGNATOR_MINUTES: v.minutes = number; f *= 60;   break;
+            case DESIGNATOR_SECONDS: v.seconds = number; break;
+        }
+        v.seconds += f / NANOS_PER_SEC;
+        v.nanoseconds = (int32_t)(f % NANOS_PER_SEC);
+    }
+
+    if (count == 0 || (time && last < DESIGNATOR_HOURS))
+        return 0;
+    if (r)
+        *r = v;
+    return i;
+}
+
+moment_status_t
+moment_core_period_from_string(const char *str, size_t len, moment_period_t *r) {
+    size_t n;
+
+    n = moment_parse_iso_period(str, len, r);
+    if (!n || n != len)
+        return MOMENT_ERR_PARSE;
+    return MOMENT_OK;
+}
+
+moment_status_t
+moment_core_duration_from_period(const moment_period_t *p, moment_duration_t *r) {
+    int64_t sec;
+
+    if (p->years || p->months)
+        return MOMENT_ERR_DURATION_NOMINAL;
+    if (p->weeks   > MAX_UNIT_WEEKS   || p->days    > MAX_UNIT_DAYS ||
+        p->hours   > MAX_UNIT_HOURS   || p->minutes > MAX_UNIT_MINUTES ||
+        p->seconds > MAX_UNIT_SECONDS)
+        return MOMENT_ERR_DURATION_RANGE;
+
+    sec = p->weeks * 604800 + p->days * 86400
+        + p->hours * 3600 + p->minutes * 60 + p->seconds;
+    return moment_core_duration_new(sec * p->sign, (int64_t)p->nanoseconds * p->sign, r);
+}
+
+moment_status_t
+moment_core_duration_from_string(const char *str, size_t len, moment_duration_t *r) {
+    moment_period_t p;
+
+    CHECK(moment_core_period_from_string(str, len, &p));
+    return moment_core_duration_from_period(&p, r);
+}
+
+static bool
+is_period(const char *str, size_t len) {
+    if (len && (*str == '+' || *str == '-'))
+        str++, len--;
+    return len && *str == 'P';
+}
+
+moment_status_t
+moment_core_interval_from_string(const char *str, size_t len, moment_iso_interval_t *r) {
+    const char *sep;
+    size_t n1, n2;
+    moment_iso_interval_t v;
+
+    memset(&v, 0, sizeof(v));
+    sep = (const char *)memchr(str, '/', len);
+    if (!sep) {
+        v.form = MOMENT_INTERVAL_DURATION;
+        CHECK(moment_core_period_from_string(str, len, &v.period));
+        *r = v;
+        return MOMENT_OK;
+    }
+
+    n1 = sep - str;
+    n2 = len - n1 - 1;
+    if (is_period(str, n1)) {
+        if (is_period(sep + 1, n2))
+            return MOMENT_ERR_PARSE;
+        v.form = MOMENT_INTERVAL_DURATION_END;
+        CHECK(moment_core_period_from_string(str, n1, &v.period));
+        CHECK(moment_core_from_string(sep + 1, n2, false, &v.end));
+        CHECK(moment_core_minus_period(&v.end, &v.period, &v.start));
+    }
+    else if (is_period(sep + 1, n2)) {
+        v.form = MOMENT_INTERVAL_START_DURATION;
+        CHECK(moment_core_from_string(str, n1, false, &v.start));
+        CHECK(moment_core_period_from_string(sep + 1, n2, &v.period));
+        CHECK(moment_core_plus_period(&v.start, &v.period, &v.end));
+    }
+    else {
+        v.form = MOMENT_INTERVAL_START_END;
+        CHECK(moment_core_from_string(str, n1, false, &v.start));
+        CHECK(moment_core_from_string(sep + 1, n2, false, &v.end));
+    }
+    /* A negative duration would give an end before the start */
+    if (moment_compare_instant(&v.end, &v.start) < 0)
+        return MOMENT_ERR_INTERVAL_ORDER;
+    *r = v;
+    return MOMENT_OK;
+}
+
+static char *
+format_number(char *d, int64_t v) {
+    char tmp[20], *t = tmp;
+
+    do {
+        *t++ = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (t > tmp)
+        *d++ = *--t;
+    return d;
+}
+
+static char *
+format_component(char *d, int64_t v, char designator) {
+    if (v < 0)
+        *d++ = '-', v = -v;
+    d = format_number(d, v);
+    *d++ = designator;
+    return d;
+}
+
+static char *
+format_seconds(char *d, int64_t sec, int ns) {
+    if (sec < 0)
+        *d++ = '-', sec = -sec;
+    d = format_number(d, sec);
+    if (ns) {
+        int i, digits;
+
+        if      ((ns % 1000000) == 0) ns /= 1000000, digits = 3;
+        else if ((ns % 1000)    == 0) ns /= 1000,    digits = 6;
+        else                          digits = 9;
+        *d++ = '.';
+        for (i = digits - 1; i >= 0; i--, ns /= 10)
+            d[i] = (char)('0' + ns % 10);
+        d += digits;
+    }
+    *d++ = 'S';
+    return d;
+}
+
+static size_t
+copy_buffer(const char *str, size_t n, char *buf, size_t len) {
+    if (len) {
+        const size_t c = (n < len) ? n : len - 1;
+        memcpy(buf, str, c);
+        buf[c] = '\0';
+    }
+    return n;
+}
+
+size_t
+moment_period_to_string_buffer(const moment_period_t *p, char *buf, size_t len) {
+    char str[MOMENT_PERIOD_STRING_MAX], *d;
+
+    d = str;
+    if (p->sign < 0)
+        *d++ = '-';
+    *d++ = 'P';
+    if (p->years)  d = format_component(d, p->years, 'Y');
+    if (p->months) d = format_component(d, p->months, 'M');
+    if (p->weeks)  d = format_component(d, p->weeks, 'W');
+    if (p->days)   d = format_component(d, p->days, 'D');
+    if (p->hours || p->minutes || p->seconds || p->nanoseconds || d == str + 1 + (p->sign < 0)) {
+        *d++ = 'T';
+        if (p->hours)   d = format_component(d, p->hours, 'H');
+        if (p->minutes) d = format_component(d, p->minutes, 'M');
+        if (p->seconds || p->nanoseconds || d[-1] == 'T')
+            d = format_seconds(d, p->seconds, p->nanoseconds);
+    }
+    return copy_buffer(str, d - str, buf, len);
+}
+
+/* Days are exactly 86400 seconds, as in Time::Moment */
+size_t
+moment_duration_to_string_buffer(const moment_duration_t *d, char *buf, size_t len) {
+    moment_duration_t a;
+    moment_period_t p;
+    int64_t sec;
+
+    a = moment_duration_abs(d);
+    memset(&p, 0, sizeof(p));
+    p.sign = moment_duration_sign(d) < 0 ? -1 : 1;
+    sec = a.sec;
+    p.days    = sec / 86400;
+    p.hours   = sec / 3600 % 24;
+    p.minutes = sec / 60 % 60;
+    p.seconds = sec % 60;
+    p.nanoseconds = a.nsec;
+    return moment_period_to_string_buffer(&p, buf, len);
+}
+
+size_t
+moment_interval_to_string_buffer(const moment_t *start, const moment_t *end, char *buf, size_t len) {
+    char str[2 * MOMENT_STRING_MAX], *d;
+
+    d = str;
+    d += moment_to_string_buffer(start, false, d, MOMENT_STRING_MAX);
+    *d++ = '/';
+    d += moment_to_string_buffer(end, false, d, MOMENT_STRING_MAX);
+    return copy_buffer(str, d - str, buf, len);
+}
@@ -0,0 +1,45 @@
+#ifndef __MOMENT_ISO_H__
+#define __MOMENT_ISO_H__
+#include "moment_core.h"
+
+/*
+ * ISO 8601 durations (PnYnMnWnDTnHnMnS) and time intervals, in the forms
+ * <start>/<end>, <start>/<duration>, <duration>/<end> and <duration>.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOMENT_PERIOD_STRING_MAX 160
+
+typedef enum {
+    MOMENT_INTERVAL_START_END=0,
+    MOMENT_INTERVAL_START_DURATION,
+    MOMENT_INTERVAL_DURATION_END,
+    MOMENT_INTERVAL_DURATION,
+} moment_interval_form_t;
+
+/* A parsed interval; start and end are resolved unless form is MOMENT_INTERVAL_DURATION */
+typedef struct {
+    moment_interval_form_t form;
+    moment_t start;
+    moment_t end;
+    moment_period_t period;
+} moment_iso_interval_t;
+
+size_t          moment_parse_iso_period(const char *str, size_t len, moment_period_t *p);
+
+moment_status_t moment_core_period_from_string(const char *str, size_t len, moment_period_t *r);
+moment_status_t moment_core_duration_from_period(const moment_period_t *p, moment_duration_t *r);
+moment_status_t moment_core_duration_from_string(const char *str, size_t len, moment_duration_t *r);
+moment_status_t moment_core_interval_from_string(const char *str, size_t len, moment_iso_interval_t *r);
+
+size_t          moment_period_to_string_buffer(const moment_period_t *p, char *buf, size_t len);
+size_t          moment_duration_to_string_buffer(const moment_duration_t *d, char *buf, size_t len);
+size_t          moment_interval_to_string_buffer(const moment_t *start, const moment_t *end, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
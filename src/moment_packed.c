@@ -0,0 +1,1256 @@
+#include <string.h>
+#include "moment_packed.h"
+#include "moment_bits.h"
+
+static const int64_t kUnitsPerSecond[4] = {
+    1,
+    1000,
+    1000000,
+    1000000000,
+};
+
+size_t
+moment_packed_width(moment_packed_t f) {
+    return f == MOMENT_PACKED_MOMENT ? sizeof(moment_t) : sizeof(int64_t);
+}
+
+static int64_t
+packed_epoch(const void *buf, size_t i) {
+    int64_t v;
+    memcpy(&v, (const char *)buf + i * sizeof(int64_t), sizeof(int64_t));
+    return v;
+}
+
+static moment_t
+packed_moment(const void *buf, size_t i) {
+    moment_t mt;
+    memcpy(&mt, (const char *)buf + i * sizeof(moment_t), sizeof(moment_t));
+    return mt;
+}
+
+moment_instant_t
+moment_instant(const moment_t *mt) {
+    moment_instant_t r;
+
+    r.sec  = moment_instant_rd_seconds(mt);
+    r.nsec = mt->nsec;
+    return r;
+}
+
+static moment_instant_t
+epoch_instant(int64_t v, moment_packed_t f) {
+    const int64_t u = kUnitsPerSecond[f];
+    moment_instant_t r;
+    int64_t sec = v / u;
+    int64_t rem = v % u;
+
+    if (rem < 0)
+        sec--, rem += u;
+    r.sec  = sec + UNIX_EPOCH;
+    r.nsec = (int32_t)(rem * (1000000000 / u));
+    return r;
+}
+
+moment_instant_t
+moment_packed_get(const void *buf, moment_packed_t f, size_t i) {
+    if (f == MOMENT_PACKED_MOMENT) {
+        const moment_t mt = packed_moment(buf, i);
+        return moment_instant(&mt);
+    }
+    return epoch_instant(packed_epoch(buf, i), f);
+}
+
+int
+moment_instant_compare(const moment_instant_t *a, const moment_instant_t *b) {
+    int r;
+
+    r = (a->sec > b->sec) - (a->sec < b->sec);
+    if (r == 0)
+        r = (a->nsec > b->nsec) - (a->nsec < b->nsec);
+    return r;
+}
+
+/*
+ * Converts an instant to a count of units since the epoch, rounded down or
+ * up. Returns -1 or 1 if the count is below or above the range of int64_t.
+ */
+static int
+instant_to_epoch(const moment_instant_t *in, moment_packed_t f, bool up, int64_t *r) {
+    const int64_t u = kUnitsPerSecond[f];
+    const int64_t sec = in->sec - UNIX_EPOCH;
+    const int64_t nsu = 1000000000 / u;
+    int64_t frac = in->nsec / nsu;
+
+    if (up && in->nsec % nsu)
+        frac++;
+    if (sec > (INT64_MAX - frac) / u)
+        return 1;
+    if (sec < INT64_MIN / u)
+        return -1;
+    *r = sec * u + frac;
+    return 0;
+}
+
+/* Returns the index of the first element that is not before the key, or after it if upper */
+static size_t
+packed_search(const void *buf, size_t n, moment_packed_t f, const moment_t *key, bool upper) {
+    const moment_instant_t k = moment_instant(key);
+    size_t lo = 0, hi = n;
+
+    if (f == MOMENT_PACKED_MOMENT) {
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            const moment_instant_t v = moment_packed_get(buf, f, mid);
+            const int c = moment_instant_compare(&v, &k);
+
+            if (c < 0 || (upper && c == 0))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+    }
+    else {
+        int64_t e;
+
+        /* lower: first v >= ceil(k), upper: first v > floor(k) */
+        switch (instant_to_epoch(&k, f, !upper, &e)) {
+            case -1: return 0;
+            case  1: return n;
+        }
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            const int64_t v = packed_epoch(buf, mid);
+
+            if (v < e || (upper && v == e))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+    }
+    return lo;
+}
+
+size_t
+moment_packed_lower_bound(const void *buf, size_t n, moment_packed_t f, const moment_t *key) {
+    return packed_search(buf, n, f, key, false);
+}
+
+size_t
+moment_packed_upper_bound(const void *buf, size_t n, moment_packed_t f, const moment_t *key) {
+    return packed_search(buf, n, f, key, true);
+}
+
+/*
+ * Field extraction. Elements are decoded a block at a time into columns
+ * of local rata die days, seconds of day and nanoseconds, and each
+ * requested field is then computed over the block in its own loop. The
+ * loops have no branches and no calls, except for the ISO week and the
+ * precision, so compilers can vectorize them.
+ */
+#define FIELDS_BLOCK 256
+
+/* Days to calendar date as dt_to_ymd() and dt_to_yd() in dt_core.c */
+#define NS_CYCLES 82
+#define NS_DAYS   (NS_CYCLES * 146097 + 305)
+#define NS_YEARS  (NS_CYCLES * 400)
+
+typedef struct {
+    int32_t valid[FIELDS_BLOCK];
+    int32_t rdn[FIELDS_BLOCK];
+    int32_t sod[FIELDS_BLOCK];
+    int32_t nsec[FIELDS_BLOCK];
+    int32_t year[FIELDS_BLOCK];
+    int32_t month[FIELDS_BLOCK];
+    int32_t day[FIELDS_BLOCK];
+    int32_t doy[FIELDS_BLOCK];
+    int32_t leap[FIELDS_BLOCK];
+} fields_block_t;
+
+static bool
+field_is_date(moment_component_t c) {
+    switch (c) {
+        case MOMENT_FIELD_YEAR:
+        case MOMENT_FIELD_QUARTER_OF_YEAR:
+        case MOMENT_FIELD_MONTH_OF_YEAR:
+        case MOMENT_FIELD_DAY_OF_YEAR:
+        case MOMENT_FIELD_DAY_OF_QUARTER:
+        case MOMENT_FIELD_DAY_OF_MONTH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Decodes n elements into local days, seconds of day and nanoseconds.
+ * Elements that are out of range are marked as not valid and decoded as
+ * 0001-01-01T00:00:00, so the fields can still be computed safely; returns
+ * false if there is any.
+ */
+static bool
+fields_decode(const void *buf, size_t n, moment_packed_t f, int64_t offset, fields_block_t *b) {
+    int64_t local[FIELDS_BLOCK];
+    int32_t bad = 0;
+    size_t i;
+
+    if (f == MOMENT_PACKED_MOMENT) {
+        for (i = 0; i < n; i++) {
+            const moment_t mt = packed_moment(buf, i);
+            const int32_t ok = (mt.nsec >= 0) & (mt.nsec < NANOS_PER_SEC);
+
+            local[i]    = (int64_t)((uint64_t)mt.sec - (uint64_t)((int64_t)mt.offset * 60) + (uint64_t)(offset * 60));
+            b->nsec[i]  = ok ? mt.nsec : 0;
+            b->valid[i] = ok;
+        }
+    }
+    else {
+        const int64_t u = kUnitsPerSecond[f];
+        const int64_t nsu = 1000000000 / u;
+
+        for (i = 0; i < n; i++) {
+            const int64_t v = packed_epoch(buf, i);
+            const int64_t neg = (v % u) < 0;
+            const int64_t sec = v / u - neg;
+            const int64_t rem = v % u + neg * u;
+
+            local[i]    = (int64_t)((uint64_t)sec + (uint64_t)(UNIX_EPOCH + offset * 60));
+            b->nsec[i]  = (int32_t)(rem * nsu);
+            b->valid[i] = 1;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        const int32_t ok = b->valid[i] & (local[i] >= MIN_RANGE) & (local[i] <= MAX_RANGE);
+        const int64_t s = ok ? local[i] : MIN_RANGE;
+        const int32_t rdn = (int32_t)(s / SECS_PER_DAY);
+
+        bad |= !ok;
+        b->valid[i] = ok;
+        b->rdn[i] = rdn;
+        b->sod[i] = (int32_t)(s - (int64_t)rdn * SECS_PER_DAY);
+    }
+    return !bad;
+}
+
+static void
+fields_decode_date(size_t n, fields_block_t *b) {
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        const uint32_t t  = (uint32_t)(b->rdn[i] + NS_DAYS) * 4 + 3;
+        const uint32_t c  = t / 146097;
+        const uint32_t nc = t % 146097 | 3;
+        const uint64_t p  = (uint64_t)2939745 * nc;
+        const uint32_t z  = (uint32_t)(p >> 32);
+        const uint32_t d  = (uint32_t)p / 2939745 / 4;
+        const uint32_t md = 2141 * d + 197913;
+        const int32_t  j  = d >= 306;
+        const int32_t  l  = z != 0 ? (z & 3) == 0 : (c & 3) == 0;
+
+        b->year[i]  = (int32_t)(100 * c + z) - NS_YEARS + j;
+        b->month[i] = (int32_t)(md >> 16) - 12 * j;
+        b->day[i]   = (int32_t)((md & 0xFFFF) / 2141) + 1;
+        b->doy[i]   = (int32_t)d + 60 + l - j * (365 + l);
+        b->leap[i]  = l;
+    }
+}
+
+static void
+fields_column(const fields_block_t *b, size_t n, int64_t offset, moment_component_t c, int32_t *r) {
+    static const int32_t kQuarterStart[5] = { 0, 0, 90, 181, 273 };
+    size_t i;
+
+    switch (c) {
+        case MOMENT_FIELD_YEAR:
+            for (i = 0; i < n; i++)
+                r[i] = b->year[i];
+            break;
+        case MOMENT_FIELD_QUARTER_OF_YEAR:
+            for (i = 0; i < n; i++)
+                r[i] = (b->month[i] + 2) / 3;
+            break;
+        case MOMENT_FIELD_MONTH_OF_YEAR:
+            for (i = 0; i < n; i++)
+                r[i] = b->month[i];
+            break;
+        case MOMENT_FIELD_WEEK_OF_YEAR:
+            for (i = 0; i < n; i++) {
+                int w;
+                dt_to_ywd(dt_from_rdn(b->rdn[i]), NULL, &w, NULL);
+                r[i] = w;
+            }
+            break;
+        case MOMENT_FIELD_DAY_OF_YEAR:
+            for (i = 0; i < n; i++)
+                r[i] = b->doy[i];
+            break;
+        case MOMENT_FIELD_DAY_OF_QUARTER:
+            /* January and February are in the first quarter, so the leap day never precedes it */
+            for (i = 0; i < n; i++) {
+                const int32_t q = (b->month[i] + 2) / 3;
+                r[i] = b->doy[i] - kQuarterStart[q] - (q > 1) * b->leap[i];
+            }
+            break;
+        case MOMENT_FIELD_DAY_OF_MONTH:
+            for (i = 0; i < n; i++)
+                r[i] = b->day[i];
+            break;
+        case MOMENT_FIELD_DAY_OF_WEEK:
+            for (i = 0; i < n; i++)
+                r[i] = (b->rdn[i] + 6) % 7 + 1;
+            break;
+        case MOMENT_FIELD_HOUR_OF_DAY:
+            for (i = 0; i < n; i++)
+                r[i] = b->sod[i] / 3600;
+            break;
+        case MOMENT_FIELD_MINUTE_OF_HOUR:
+            for (i = 0; i < n; i++)
+                r[i] = b->sod[i] / 60 % 60;
+            break;
+        case MOMENT_FIELD_MINUTE_OF_DAY:
+            for (i = 0; i < n; i++)
+                r[i] = b->sod[i] / 60;
+            break;
+        case MOMENT_FIELD_SECOND_OF_MINUTE:
+            for (i = 0; i < n; i++)
+                r[i] = b->sod[i] % 60;
+            break;
+        case MOMENT_FIELD_SECOND_OF_DAY:
+            for (i = 0; i < n; i++)
+                r[i] = b->sod[i];
+            break;
+        case MOMENT_FIELD_MILLI_OF_SECOND:
+            for (i = 0; i < n; i++)
+                r[i] = b->nsec[i] / 1000000;
+            break;
+        case MOMENT_FIELD_MILLI_OF_DAY:
+            for (i = 0; i < n; i++)
+                r[i] = b->sod[i] * 1000 + b->nsec[i] / 1000000;
+            break;
+        case MOMENT_FIELD_MICRO_OF_SECOND:
+            for (i = 0; i < n; i++)
+                r[i] = b->nsec[i] / 1000;
+            break;
+        case MOMENT_FIELD_NANO_OF_SECOND:
+            for (i = 0; i < n; i++)
+                r[i] = b->nsec[i];
+            break;
+        case MOMENT_FIELD_PRECISION:
+            for (i = 0; i < n; i++) {
+                moment_t mt;
+                mt.sec    = (int64_t)b->rdn[i] * SECS_PER_DAY + b->sod[i];
+                mt.nsec   = b->nsec[i];
+                mt.offset = (int32_t)offset;
+                r[i] = moment_precision(&mt);
+            }
+            break;
+        case MOMENT_FIELD_RATA_DIE_DAY:
+            for (i = 0; i < n; i++)
+                r[i] = b->rdn[i];
+            break;
+        default:
+            break;
+    }
+}
+
+moment_status_t
+moment_core_packed_fields(const void *buf, size_t n, moment_packed_t f, int64_t offset,
+                          const moment_component_t *fields, size_t nfields, int32_t * const *cols) {
+    fields_block_t b;
+    bool date = false;
+    size_t i, k;
+
+    if (offset < -1080 || offset > 1080)
+        return MOMENT_ERR_PARAM_OFFSET;
+    for (k = 0; k < nfields; k++) {
+        if (fields[k] == MOMENT_FIELD_MICRO_OF_DAY || fields[k] == MOMENT_FIELD_NANO_OF_DAY)
+            return MOMENT_ERR_PACKED_FIELD;
+        date |= field_is_date(fields[k]);
+    }
+    for (i = 0; i < n; i += FIELDS_BLOCK) {
+        const size_t m = n - i < FIELDS_BLOCK ? n - i : FIELDS_BLOCK;
+
+        if (!fields_decode((const char *)buf + i * moment_packed_width(f), m, f, offset, &b))
+            return MOMENT_ERR_RANGE;
+        if (date)
+            fields_decode_date(m, &b);
+        for (k = 0; k < nfields; k++)
+            fields_column(&b, m, offset, fields[k], cols[k] + i);
+    }
+    return MOMENT_OK;
+}
+
+static int64_t
+floor_div(int64_t a, int64_t b) {
+    const int64_t q = a / b;
+    return q - ((a % b) < 0);
+}
+
+static bool
+moment_valid(const moment_t *mt) {
+    return mt->sec >= MIN_RANGE && mt->sec <= MAX_RANGE
+        && mt->nsec >= 0 && mt->nsec < NANOS_PER_SEC
+        && mt->offset >= -1080 && mt->offset <= 1080;
+}
+
+/* Reads an element as a moment; returns false if it is not a valid moment */
+static bool
+packed_element_moment(const void *buf, moment_packed_t f, size_t i, moment_t *r) {
+    if (f == MOMENT_PACKED_MOMENT) {
+        *r = packed_moment(buf, i);
+        return moment_valid(r);
+    }
+    else {
+        const int64_t u = kUnitsPerSecond[f];
+        const int64_t v = packed_epoch(buf, i);
+        const int64_t sec = floor_div(v, u);
+
+        return moment_core_from_epoch(sec, (v - sec * u) * (1000000000 / u), 0, r) == MOMENT_OK;
+    }
+}
+
+static int64_t
+floor_mod(int64_t a, int64_t b) {
+    const int64_t r = a % b;
+    return r < 0 ? r + b : r;
+}
+
+/*
+ * Difference b - a of two counts of bu units per second, in tu units per
+ * second and divided by div. The counts are split into seconds and a
+ * fraction first, so only the difference in seconds must be representable.
+ */
+static bool
+epoch_delta(int64_t a, int64_t b, int64_t bu, int64_t tu, int64_t div, int64_t *r) {
+    const int64_t as = floor_div(a, bu);
+    const int64_t bs = floor_div(b, bu);
+    int64_t ds, df, frac;
+
+    if ((as < 0 && bs > INT64_MAX + as) || (as > 0 && bs < INT64_MIN + as))
+        return false;
+    ds = bs - as;
+    df = floor_mod(b, bu) - floor_mod(a, bu);
+    if (df < 0) {
+        if (ds == INT64_MIN)
+            return false;
+        ds--, df += bu;
+    }
+    frac = tu >= bu ? df * (tu / bu) : df / (bu / tu);
+    if (ds > (INT64_MAX - frac) / tu || ds < INT64_MIN / tu)
+        return false;
+    *r = (ds * tu + frac) / div;
+    return true;
+}
+
+/* The difference of two elements in a unit, as moment_core_delta_unit() */
+typedef struct {
+    moment_packed_t f;
+    moment_unit_t u;
+    bool counts;        /* computed from the counts of an epoch format */
+    int64_t bu, tu, div;
+} delta_t;
+
+static void
+delta_init(delta_t *d, moment_packed_t f, moment_unit_t u) {
+    d->f      = f;
+    d->u      = u;
+    d->counts = f != MOMENT_PACKED_MOMENT && u >= MOMENT_UNIT_HOURS;
+    d->bu     = d->counts ? kUnitsPerSecond[f] : 1;
+    d->tu     = 1;
+    d->div    = 1;
+    switch (u) {
+        case MOMENT_UNIT_HOURS:   d->div = 3600; break;
+        case MOMENT_UNIT_MINUTES: d->div = 60;   break;
+        case MOMENT_UNIT_MILLIS:  d->tu = 1000;       break;
+        case MOMENT_UNIT_MICROS:  d->tu = 1000000;    break;
+        case MOMENT_UNIT_NANOS:   d->tu = 1000000000; break;
+        default:                                      break;
+    }
+}
+
+/* Difference b[j] - a[i]; returns false if it overflows or an element is not a valid moment */
+static bool
+delta_element(const delta_t *d, const void *a, size_t i, const void *b, size_t j, int64_t *r) {
+    moment_t mt1, mt2;
+
+    if (d->counts)
+        return epoch_delta(packed_epoch(a, i), packed_epoch(b, j), d->bu, d->tu, d->div, r);
+    return packed_element_moment(a, d->f, i, &mt1)
+        && packed_element_moment(b, d->f, j, &mt2)
+        && moment_core_delta_unit(&mt1, &mt2, d->u, r) == MOMENT_OK;
+}
+
+/*
+ * Element-wise differences end[i] - start[i] in the given unit, with the
+ * semantics of moment_core_delta_unit(): calendar units count the local
+ * days or months between the dates and time units are the difference of
+ * the instants, rounded down to the unit and truncated to hours or
+ * minutes. Epoch buffers are in UTC, and their differences in time units
+ * are computed directly from the counts, so they are exact for any pair
+ * of counts whose difference is representable.
+ *
+ * An element whose difference cannot be computed, because it overflows
+ * int64_t or an element is not a valid moment, is stored as zero and its
+ * bit in overflow (LSB first, as vec() in Perl) is set. Returns the number
+ * of such elements.
+ */
+size_t
+moment_packed_delta(const void *start, const void *end, size_t n, moment_packed_t f,
+                    moment_unit_t u, int64_t *r, unsigned char *overflow) {
+    size_t i, count = 0;
+    delta_t d;
+
+    memset(overflow, 0, (n + 7) / 8);
+    delta_init(&d, f, u);
+    for (i = 0; i < n; i++) {
+        if (!delta_element(&d, start, i, end, i, &r[i])) {
+            r[i] = 0;
+            overflow[i >> 3] |= 1 << (i & 7);
+            count++;
+        }
+    }
+    return count;
+}
+
+/* Truncates to the start of the year, month, ISO week, day or any smaller unit */
+static moment_status_t
+moment_truncate(const moment_t *mt, moment_unit_t u, moment_t *r) {
+    static const int kPrecision[] = { -3, -3, -3, -3, -2, -1, 0, 3, 6, 9 };
+    moment_t t = *mt;
+    moment_status_t s = MOMENT_OK;
+
+    switch (u) {
+        case MOMENT_UNIT_YEARS:
+            s = moment_core_with_field(mt, MOMENT_FIELD_DAY_OF_YEAR, 1, &t);
+            break;
+        case MOMENT_UNIT_MONTHS:
+            s = moment_core_with_field(mt, MOMENT_FIELD_DAY_OF_MONTH, 1, &t);
+            break;
+        case MOMENT_UNIT_WEEKS:
+            s = moment_core_with_field(mt, MOMENT_FIELD_DAY_OF_WEEK, 1, &t);
+            break;
+        default:
+            break;
+    }
+    if (s != MOMENT_OK)
+        return s;
+    return moment_core_with_precision(&t, kPrecision[u], r);
+}
+
+static moment_status_t
+packed_transform_one(const moment_t *mt, moment_packed_op_t op, moment_unit_t u, int64_t v, moment_t *r) {
+    switch (op) {
+        case MOMENT_PACKED_PLUS_UNIT:
+            return moment_core_plus_unit(mt, u, v, r);
+        case MOMENT_PACKED_WITH_OFFSET_SAME_INSTANT:
+            return moment_core_with_offset_same_instant(mt, v, r);
+        case MOMENT_PACKED_WITH_PRECISION:
+            return moment_core_with_precision(mt, v, r);
+        case MOMENT_PACKED_AT_MIDNIGHT:
+            return moment_core_at_midnight(mt, r);
+        case MOMENT_PACKED_TRUNCATE:
+            return moment_truncate(mt, u, r);
+    }
+    return MOMENT_ERR_UNIT;
+}
+
+/*
+ * Applies an operation in place to every element of a buffer of moments,
+ * with the unit u and value v as its parameters. An element that is not a
+ * valid moment, or whose result would be out of range, is left unchanged
+ * and its bit in failed is set; their number is stored in r. Any other
+ * error is an invalid parameter and is returned before any element is
+ * changed, as it fails for the first valid element.
+ */
+moment_status_t
+moment_core_packed_transform(void *buf, size_t n, moment_packed_op_t op, moment_unit_t u, int64_t v,
+                             unsigned char *failed, size_t *r) {
+    char *p = (char *)buf;
+    size_t i, count = 0;
+
+    memset(failed, 0, (n + 7) / 8);
+    for (i = 0; i < n; i++, p += sizeof(moment_t)) {
+        moment_t mt, t;
+        moment_status_t s;
+
+        memcpy(&mt, p, sizeof(moment_t));
+        s = moment_valid(&mt) ? packed_transform_one(&mt, op, u, v, &t) : MOMENT_ERR_RANGE;
+        if (s == MOMENT_OK)
+            memcpy(p, &t, sizeof(moment_t));
+        else if (s == MOMENT_ERR_RANGE) {
+            failed[i >> 3] |= 1 << (i & 7);
+            count++;
+        }
+        else
+            return s;
+    }
+    *r = count;
+    return MOMENT_OK;
+}
+
+/*
+ * Selection. Elements are filtered a block at a time into 64-bit words of
+ * a bitmap. The instant range is a compare of each element against bounds
+ * converted once to the format of the buffer, and each field is computed
+ * as a column of the block and looked up in its set, all without branches
+ * so that compilers can vectorize the loops.
+ */
+#define FILTER_WORDS (FIELDS_BLOCK / 64)
+
+/*
+ * Stores the inclusive bounds of the counts of an epoch format in the range
+ * [from, to), either of which may be NULL for no bound; returns false if
+ * the range is empty.
+ */
+bool
+moment_packed_epoch_bounds(moment_packed_t f, const moment_t *from, const moment_t *to, int64_t *lo, int64_t *hi) {
+    moment_instant_t k;
+    int64_t e;
+
+    *lo = INT64_MIN;
+    *hi = INT64_MAX;
+    if (from) {
+        k = moment_instant(from);
+        switch (instant_to_epoch(&k, f, true, &e)) {
+            case -1: break;
+            case  1: return false;
+            default: *lo = e;
+        }
+    }
+    if (to) {
+        k = moment_instant(to);
+        switch (instant_to_epoch(&k, f, true, &e)) {
+            case -1: return false;
+            case  1: break;
+            default:
+                if (e == INT64_MIN)
+                    return false;
+                *hi = e - 1;
+        }
+    }
+    return *lo <= *hi;
+}
+
+static uint64_t
+filter_epoch_word(const void *buf, size_t n, int64_t lo, int64_t hi) {
+    uint64_t w = 0;
+    size_t j;
+
+    for (j = 0; j < n; j++) {
+        const int64_t v = packed_epoch(buf, j);
+        w |= (uint64_t)((v >= lo) & (v <= hi)) << j;
+    }
+    return w;
+}
+
+static uint64_t
+filter_moment_word(const void *buf, size_t n, const moment_instant_t *lo, const moment_instant_t *hi) {
+    uint64_t w = 0;
+    size_t j;
+
+    for (j = 0; j < n; j++) {
+        const moment_t mt = packed_moment(buf, j);
+        const int64_t s = (int64_t)((uint64_t)mt.sec - (uint64_t)((int64_t)mt.offset * 60));
+        const int32_t after  = (s > lo->sec) | ((s == lo->sec) & (mt.nsec >= lo->nsec));
+        const int32_t before = (s < hi->sec) | ((s == hi->sec) & (mt.nsec < hi->nsec));
+
+        w |= (uint64_t)(after & before) << j;
+    }
+    return w;
+}
+
+static uint64_t
+filter_set_word(const int32_t *col, size_t n, const moment_field_set_t *fs) {
+    uint64_t w = 0;
+    size_t j;
+
+    for (j = 0; j < n; j++) {
+        const int32_t v = col[j];
+        const uint32_t in = (v >= fs->min) & (v <= fs->max);
+        const uint32_t i = in ? (uint32_t)(v - fs->min) : 0;
+
+        w |= ((fs->set[i >> 6] >> (i & 63)) & in) << j;
+    }
+    return w;
+}
+
+static uint64_t
+filter_valid_word(const int32_t *valid, size_t n) {
+    uint64_t w = 0;
+    size_t j;
+
+    for (j = 0; j < n; j++)
+        w |= (uint64_t)valid[j] << j;
+    return w;
+}
+
+/*
+ * Sets bit i of the bitmap (LSB first, as vec() in Perl, (n + 7) / 8
+ * bytes) for each element i selected by the filter, and stores their
+ * number in r. Elements that are out of range never match a field.
+ */
+moment_status_t
+moment_core_packed_filter(const void *buf, size_t n, moment_packed_t f,
+                          const moment_packed_filter_t *flt, unsigned char *bitmap, size_t *r) {
+    const size_t width = moment_packed_width(f);
+    const size_t nbytes = (n + 7) / 8;
+    moment_instant_t lo, hi;
+    int64_t elo = 0, ehi = 0;
+    bool empty = false, date = false;
+    fields_block_t b;
+    int32_t col[FIELDS_BLOCK];
+    size_t i, k, count = 0;
+
+    if (flt->offset < -1080 || flt->offset > 1080)
+        return MOMENT_ERR_PARAM_OFFSET;
+    for (k = 0; k < flt->nfields; k++) {
+        const moment_component_t c = flt->fields[k].field;
+        if (c == MOMENT_FIELD_MICRO_OF_DAY || c == MOMENT_FIELD_NANO_OF_DAY)
+            return MOMENT_ERR_PACKED_FIELD;
+        date |= field_is_date(c);
+    }
+
+    if (f == MOMENT_PACKED_MOMENT) {
+        lo.sec = INT64_MIN, lo.nsec = 0;
+        hi.sec = INT64_MAX, hi.nsec = NANOS_PER_SEC;
+        if (flt->from)
+            lo = moment_instant(flt->from);
+        if (flt->to)
+            hi = moment_instant(flt->to);
+    }
+    else
+        empty = !moment_packed_epoch_bounds(f, flt->from, flt->to, &elo, &ehi);
+
+    for (i = 0; i < n; i += FIELDS_BLOCK) {
+        const size_t m = n - i < FIELDS_BLOCK ? n - i : FIELDS_BLOCK;
+        const char *p = (const char *)buf + i * width;
+        uint64_t words[FILTER_WORDS];
+        size_t w, nw = (m + 63) / 64;
+
+        for (w = 0; w < nw; w++) {
+            const size_t wn = m - w * 64 < 64 ? m - w * 64 : 64;
+            const void *wp = p + w * 64 * width;
+
+            if (empty)
+                words[w] = 0;
+            else if (f == MOMENT_PACKED_MOMENT)
+                words[w] = filter_moment_word(wp, wn, &lo, &hi);
+            else
+                words[w] = filter_epoch_word(wp, wn, elo, ehi);
+        }
+
+        if (flt->nfields && !empty) {
+            fields_decode(p, m, f, flt->offset, &b);
+            if (date)
+                fields_decode_date(m, &b);
+            for (w = 0; w < nw; w++) {
+                const size_t wn = m - w * 64 < 64 ? m - w * 64 : 64;
+                words[w] &= filter_valid_word(b.valid + w * 64, wn);
+            }
+            for (k = 0; k < flt->nfields; k++) {
+                fields_column(&b, m, flt->offset, flt->fields[k].field, col);
+                for (w = 0; w < nw; w++) {
+                    const size_t wn = m - w * 64 < 64 ? m - w * 64 : 64;
+                    words[w] &= filter_set_word(col + w * 64, wn, &flt->fields[k]);
+                }
+            }
+        }
+
+        for (w = 0; w < nw; w++) {
+            const size_t at = i / 8 + w * 8;
+            const size_t nb = nbytes - at < 8 ? nbytes - at : 8;
+
+            count += popcount64(words[w]);
+            for (k = 0; k < nb; k++)
+                bitmap[at + k] = (unsigned char)(words[w] >> (k * 8));
+        }
+    }
+    *r = count;
+    return MOMENT_OK;
+}
+
+/* Stores the index of each set bit of a bitmap of n bits in r; returns their number */
+size_t
+moment_packed_bitmap_indices(const unsigned char *bitmap, size_t n, int64_t *r) {
+    const size_t nbytes = (n + 7) / 8;
+    size_t i, count = 0;
+
+    for (i = 0; i < nbytes; i++) {
+        uint64_t b = bitmap[i];
+
+        while (b) {
+            r[count++] = (int64_t)(i * 8 + ctz64(b));
+            b &= b - 1;
+        }
+    }
+    return count;
+}
+
+/*
+ * Set operations over sorted buffers, merging the two buffers in one pass.
+ * The buffers are multisets: an element that occurs m times in a and n
+ * times in b occurs max(m, n), min(m, n) or max(m - n, 0) times in the
+ * union, intersection or difference, as in the C++ std::set_* algorithms,
+ * and an element that is in both is copied from a.
+ */
+static int
+packed_compare(const void *a, size_t i, const void *b, size_t j, moment_packed_t f) {
+    if (f == MOMENT_PACKED_MOMENT) {
+        const moment_instant_t x = moment_packed_get(a, f, i);
+        const moment_instant_t y = moment_packed_get(b, f, j);
+
+        return moment_instant_compare(&x, &y);
+    }
+    else {
+        const int64_t x = packed_epoch(a, i);
+        const int64_t y = packed_epoch(b, j);
+
+        return (x > y) - (x < y);
+    }
+}
+
+/* Stores the result of a set operation over a and b in r, of room for na + nb elements; returns its number */
+size_t
+moment_packed_setop(const void *a, size_t na, const void *b, size_t nb, moment_packed_t f,
+                    moment_packed_setop_t op, void *r) {
+    const size_t width = moment_packed_width(f);
+    const bool keep_a = op != MOMENT_PACKED_INTERSECTION;
+    const bool keep_b = op == MOMENT_PACKED_UNION;
+    const bool keep_both = op != MOMENT_PACKED_DIFFERENCE;
+    char *dst = (char *)r;
+    size_t i = 0, j = 0;
+
+    while (i < na && j < nb) {
+        const int c = packed_compare(a, i, b, j, f);
+
+        if (c < 0) {
+            if (keep_a)
+                memcpy(dst, (const char *)a + i * width, width), dst += width;
+            i++;
+        }
+        else if (c > 0) {
+            if (keep_b)
+                memcpy(dst, (const char *)b + j * width, width), dst += width;
+            j++;
+        }
+        else {
+            if (keep_both)
+                memcpy(dst, (const char *)a + i * width, width), dst += width;
+            i++, j++;
+        }
+    }
+    if (keep_a && i < na) {
+        memcpy(dst, (const char *)a + i * width, (na - i) * width);
+        dst += (na - i) * width;
+    }
+    if (keep_b && j < nb) {
+        memcpy(dst, (const char *)b + j * width, (nb - j) * width);
+        dst += (nb - j) * width;
+    }
+    return (size_t)(dst - (char *)r) / width;
+}
+
+/* Seconds of the precisions -1 to -3: minutes, hours and days */
+static const int64_t kPrecisionSeconds[3] = { 60, 3600, 86400 };
+
+/* The key of a moment compared at a precision, as moment_core_compare_precision() */
+static moment_instant_t
+precision_key(const moment_t *mt, int64_t precision) {
+    static const int32_t kNanos[10] = {
+        1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+    };
+    moment_instant_t r;
+
+    if (precision < 0) {
+        const int64_t n = kPrecisionSeconds[-precision - 1];
+        const int64_t sec = moment_local_rd_seconds(mt);
+
+        r.sec  = sec - sec % n - mt->offset * 60;
+        r.nsec = 0;
+    }
+    else {
+        r.sec  = moment_instant_rd_seconds(mt);
+        r.nsec = precision ? mt->nsec - mt->nsec % kNanos[precision] : 0;
+    }
+    return r;
+}
+
+/*
+ * Copies the first element of each run of consecutive elements that are
+ * equal at the given precision to r; stores their number in rn. A sorted
+ * buffer has no duplicates left.
+ */
+moment_status_t
+moment_core_packed_dedupe(const void *buf, size_t n, moment_packed_t f, int64_t precision,
+                          void *r, size_t *rn) {
+    const size_t width = moment_packed_width(f);
+    char *dst = (char *)r;
+    size_t i;
+
+    if (precision < -3 || precision > 9)
+        return MOMENT_ERR_PARAM_PRECISION;
+
+    if (n == 0) {
+        *rn = 0;
+        return MOMENT_OK;
+    }
+
+    if (f == MOMENT_PACKED_MOMENT) {
+        moment_t mt = packed_moment(buf, 0);
+        moment_instant_t last = precision_key(&mt, precision);
+
+        memcpy(dst, &mt, width), dst += width;
+        for (i = 1; i < n; i++) {
+            moment_instant_t k;
+
+            mt = packed_moment(buf, i);
+            k = precision_key(&mt, precision);
+            if (moment_instant_compare(&k, &last) != 0) {
+                memcpy(dst, &mt, width), dst += width;
+                last = k;
+            }
+        }
+    }
+    else {
+        /* Epoch counts are in UTC, where every unit starts at a multiple of its length */
+        const int64_t u = kUnitsPerSecond[f];
+        int64_t d, last, v;
+
+        if (precision < 0)
+            d = u * kPrecisionSeconds[-precision - 1];
+        else {
+            d = u;
+            while (precision-- > 0 && d > 1)
+                d /= 10;
+        }
+
+        v = packed_epoch(buf, 0);
+        last = floor_div(v, d);
+        memcpy(dst, &v, width), dst += width;
+        for (i = 1; i < n; i++) {
+            int64_t k;
+
+            v = packed_epoch(buf, i);
+            k = floor_div(v, d);
+            if (k != last) {
+                memcpy(dst, &v, width), dst += width;
+                last = k;
+            }
+        }
+    }
+    *rn = (size_t)(dst - (char *)r) / width;
+    return MOMENT_OK;
+}
+
+/*
+ * K-way merge of sorted buffers with a binary heap of the next element of
+ * each buffer. The keys of epoch buffers are the counts themselves, which
+ * order the same as their instants; ties are broken by the buffer, so the
+ * merge is stable.
+ */
+static moment_instant_t
+merge_key(const void *buf, moment_packed_t f, size_t i) {
+    if (f == MOMENT_PACKED_MOMENT)
+        return moment_packed_get(buf, f, i);
+    else {
+        moment_instant_t r;
+
+        r.sec  = packed_epoch(buf, i);
+        r.nsec = 0;
+        return r;
+    }
+}
+
+static bool
+merge_less(const moment_merge_node_t *a, const moment_merge_node_t *b) {
+    const int c = moment_instant_compare(&a->key, &b->key);
+
+    return c < 0 || (c == 0 && a->source < b->source);
+}
+
+static void
+merge_sift_down(moment_merge_node_t *heap, size_t n, size_t i) {
+    const moment_merge_node_t node = heap[i];
+
+    for (;;) {
+        size_t c = 2 * i + 1;
+
+        if (c >= n)
+            break;
+        if (c + 1 < n && merge_less(&heap[c + 1], &heap[c]))
+            c++;
+        if (!merge_less(&heap[c], &node))
+            break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    heap[i] = node;
+}
+
+/*
+ * Merges k sorted buffers of ns[s] elements, storing the buffer and the
+ * index of each element in instant order in sources and indices; heap has
+ * room for k nodes. Returns the number of elements.
+ */
+size_t
+moment_packed_merge(const void * const *bufs, const size_t *ns, size_t k, moment_packed_t f,
+                    moment_merge_node_t *heap, int32_t *sources, int64_t *indices) {
+    size_t n = 0, count = 0, s, i;
+
+    for (s = 0; s < k; s++) {
+        if (ns[s] == 0)
+            continue;
+        heap[n].key    = merge_key(bufs[s], f, 0);
+        heap[n].source = s;
+        heap[n].index  = 0;
+        n++;
+    }
+    for (i = n / 2; i-- > 0;)
+        merge_sift_down(heap, n, i);
+
+    while (n > 0) {
+        moment_merge_node_t *top = &heap[0];
+
+        sources[count] = (int32_t)top->source;
+        indices[count] = (int64_t)top->index;
+        count++;
+        if (++top->index < ns[top->source])
+            top->key = merge_key(bufs[top->source], f, top->index);
+        else
+            heap[0] = heap[--n];
+        merge_sift_down(heap, n, 0);
+    }
+    return count;
+}
+
+/*
+ * As-of join: for each element of a sorted buffer, the index of the last
+ * element of another sorted buffer of the same format on or before it
+ * (backward), the first on or after it (forward) or the closer of the two
+ * (nearest, the backward one on a tie), optionally no further away than a
+ * tolerance in a unit.
+ */
+typedef struct {
+    const moment_packed_asof_t *join;
+    moment_packed_t f;
+    bool counts;        /* the tolerance is compared as a difference of counts */
+    uint64_t gap;       /* the tolerance in counts */
+} asof_t;
+
+/*
+ * Converts v >= 0 units of time (hours or smaller) to counts of an epoch
+ * format, rounded down or up, and saturated to UINT64_MAX.
+ */
+static uint64_t
+epoch_span(moment_packed_t f, moment_unit_t u, int64_t v, bool up) {
+    static const int64_t kNanosPerUnit[] = {
+        INT64_C(3600000000000), INT64_C(60000000000), 1000000000, 1000000, 1000, 1
+    };
+    const int64_t unit  = kNanosPerUnit[u - MOMENT_UNIT_HOURS];
+    const int64_t count = 1000000000 / kUnitsPerSecond[f];
+
+    if (unit < count) {
+        const int64_t ratio = count / unit;
+        return (uint64_t)(v / ratio + (up && v % ratio != 0));
+    }
+    if (v > INT64_MAX / (unit / count))
+        return UINT64_MAX;
+    return (uint64_t)(v * (unit / count));
+}
+
+static void
+asof_init(asof_t *a, const moment_packed_asof_t *join, moment_packed_t f) {
+    a->join   = join;
+    a->f      = f;
+    a->counts = join->tolerant && f != MOMENT_PACKED_MOMENT && join->unit >= MOMENT_UNIT_HOURS;
+    a->gap    = a->counts ? epoch_span(f, join->unit, join->tolerance, false) : 0;
+}
+
+/*
+ * Stores the instant of the element moved by the tolerance towards the
+ * other buffer in r; returns false if the element is not a valid moment,
+ * and sets unbounded if the limit is beyond the range of moments.
+ */
+static bool
+asof_limit(const asof_t *a, const void *buf, size_t i, bool backward, moment_instant_t *r, bool *unbounded) {
+    const moment_packed_asof_t *join = a->join;
+    moment_t mt, lim;
+
+    if (!packed_element_moment(buf, a->f, i, &mt))
+        return false;
+    *unbounded = moment_core_plus_unit(&mt, join->unit, backward ? -join->tolerance : join->tolerance,
+                                       &lim) != MOMENT_OK;
+    if (!*unbounded)
+        *r = moment_instant(&lim);
+    return true;
+}
+
+/* Returns whether element j of right is within the tolerance of element i of left */
+static bool
+asof_within(const asof_t *a, const void *left, size_t i, const void *right, size_t j, bool backward) {
+    moment_instant_t lim, v;
+    bool unbounded;
+
+    if (!a->join->tolerant)
+        return true;
+    if (a->counts) {
+        const uint64_t l = (uint64_t)packed_epoch(left, i);
+        const uint64_t r = (uint64_t)packed_epoch(right, j);
+
+        return (backward ? l - r : r - l) <= a->gap;
+    }
+    if (!asof_limit(a, left, i, backward, &lim, &unbounded))
+        return false;
+    if (unbounded)
+        return true;
+    v = moment_packed_get(right, a->f, j);
+    return backward ? moment_instant_compare(&v, &lim) >= 0
+                    : moment_instant_compare(&v, &lim) <= 0;
+}
+
+/* Returns whether element j of right is strictly closer to element i of left than element k */
+static bool
+asof_closer(const void *left, size_t i, const void *right, size_t j, size_t k, moment_packed_t f) {
+    if (f == MOMENT_PACKED_MOMENT) {
+        const moment_instant_t l = moment_packed_get(left, f, i);
+        const moment_instant_t x = moment_packed_get(right, f, j);
+        const moment_instant_t y = moment_packed_get(right, f, k);
+        moment_instant_t dx, dy;
+
+        /* j is after and k before the element, so both distances are positive */
+        dx.sec  = (int64_t)((uint64_t)x.sec - (uint64_t)l.sec);
+        dx.nsec = x.nsec - l.nsec;
+        dy.sec  = (int64_t)((uint64_t)l.sec - (uint64_t)y.sec);
+        dy.nsec = l.nsec - y.nsec;
+        if (dx.nsec < 0)
+            dx.sec--, dx.nsec += NANOS_PER_SEC;
+        if (dy.nsec < 0)
+            dy.sec--, dy.nsec += NANOS_PER_SEC;
+        return moment_instant_compare(&dx, &dy) < 0;
+    }
+    else {
+        const uint64_t l = (uint64_t)packed_epoch(left, i);
+
+        return (uint64_t)packed_epoch(right, j) - l < l - (uint64_t)packed_epoch(right, k);
+    }
+}
+
+/*
+ * Stores the index in right of the match of each element of left in r, or
+ * -1 if it has none, and the number of elements with a match in rn.
+ */
+moment_status_t
+moment_core_packed_asof(const void *left, size_t nl, const void *right, size_t nr, moment_packed_t f,
+                        const moment_packed_asof_t *join, int64_t *r, size_t *rn) {
+    size_t i, lo = 0, hi = 0, count = 0;
+    asof_t a;
+
+    if (join->tolerant && join->tolerance < 0)
+        return MOMENT_ERR_PARAM_TOLERANCE;
+    asof_init(&a, join, f);
+
+    for (i = 0; i < nl; i++) {
+        int64_t back = -1, fwd = -1;
+
+        /* lo is the first element of right on or after the element, hi the first after it */
+        while (lo < nr && packed_compare(right, lo, left, i, f) < 0)
+            lo++;
+        if (hi < lo)
+            hi = lo;
+        while (hi < nr && packed_compare(right, hi, left, i, f) <= 0)
+            hi++;
+
+        if (join->direction != MOMENT_ASOF_FORWARD && hi > 0 && asof_within(&a, left, i, right, hi - 1, true))
+            back = (int64_t)(hi - 1);
+        if (join->direction != MOMENT_ASOF_BACKWARD && lo < nr && asof_within(&a, left, i, right, lo, false))
+            fwd = (int64_t)lo;
+
+        if (back >= 0 && fwd >= 0)
+            r[i] = asof_closer(left, i, right, (size_t)fwd, (size_t)back, f) ? fwd : back;
+        else
+            r[i] = back >= 0 ? back : fwd;
+        count += r[i] >= 0;
+    }
+    *rn = count;
+    return MOMENT_OK;
+}
+
+/* Returns whether an element can be compared with delta_element() */
+static bool
+delta_valid(const delta_t *d, const void *buf, size_t i) {
+    moment_t mt;
+
+    return d->counts || packed_element_moment(buf, d->f, i, &mt);
+}
+
+/*
+ * Sliding windows over a sorted buffer: the window of an element holds the
+ * elements from less than window units before it up to and including the
+ * elements of the same instant, with the distance in units as
+ * moment_core_delta_unit() computes it. Both ends of the window only move
+ * forwards, so each element enters and leaves a window once.
+ *
+ * Stores the number of elements in the window of each element in counts,
+ * and if not NULL the index of the first and the last element of the
+ * window in first and last; an element that is not a valid moment has an
+ * empty window, with a count of zero and indices of -1, and is not counted
+ * in the window of any other element.
+ */
+moment_status_t
+moment_core_packed_window(const void *buf, size_t n, moment_packed_t f, moment_unit_t u, int64_t window,
+                          int64_t *counts, int64_t *first, int64_t *last) {
+    size_t i, lo = 0, hi = 0;
+    size_t invalid_lo = 0;  /* invalid elements before lo */
+    size_t invalid_i = 0;   /* invalid elements before i */
+    uint64_t span = 0;
+    delta_t d;
+
+    if (window < 1)
+        return MOMENT_ERR_PARAM_WINDOW;
+    delta_init(&d, f, u);
+
+    /* The difference of counts in whole units is less than the window if the difference itself is */
+    if (d.counts)
+        span = epoch_span(f, u, window, true);
+
+    for (i = 0; i < n; i++) {
+        int64_t v;
+
+        if (!delta_valid(&d, buf, i)) {
+            counts[i] = 0;
+            if (first)
+                first[i] = last[i] = -1;
+            invalid_i++;
+            continue;
+        }
+
+        /* Element i is valid and in its own window, so lo stops at i at the latest */
+        if (d.counts) {
+            const uint64_t t = (uint64_t)packed_epoch(buf, i);
+
+            while (lo < i && t - (uint64_t)packed_epoch(buf, lo) >= span)
+                lo++;
+        }
+        else {
+            while (lo < i) {
+                if (!delta_valid(&d, buf, lo))
+                    invalid_lo++;
+                else if (delta_element(&d, buf, lo, buf, i, &v) && v < window)
+                    break;
+                lo++;
+            }
+        }
+
+        /* The elements after i up to hi are valid */
+        if (hi < i)
+            hi = i;
+        while (hi + 1 < n && delta_valid(&d, buf, hi + 1) && packed_compare(buf, hi + 1, buf, i, f) <= 0)
+            hi++;
+
+        counts[i] = (int64_t)(hi - lo + 1 - (invalid_i - invalid_lo));
+        if (first) {
+            first[i] = (int64_t)lo;
+            last[i]  = (int64_t)hi;
+        }
+    }
+    return MOMENT_OK;
+}
@@ -0,0 +1,127 @@
+#ifndef __MOMENT_PACKED_H__
+#define __MOMENT_PACKED_H__
+#include "moment_core.h"
+
+/*
+ * Kernels over packed buffers of timestamps: native int64 counts of
+ * seconds, milliseconds, microseconds or nanoseconds since the Unix
+ * epoch, or raw 16-byte moment_t records. Elements are read with
+ * memcpy(), so a buffer need not be aligned.
+ *
+ * Elements of every format are ordered by their instant, decoded to
+ * rata die seconds and a nanosecond (moment_instant_t), so epoch buffers
+ * and moment_t buffers compare exactly with any Time::Moment key.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MOMENT_PACKED_SECONDS=0,
+    MOMENT_PACKED_MILLIS,
+    MOMENT_PACKED_MICROS,
+    MOMENT_PACKED_NANOS,
+    MOMENT_PACKED_MOMENT,
+} moment_packed_t;
+
+typedef enum {
+    MOMENT_PACKED_PLUS_UNIT=0,
+    MOMENT_PACKED_WITH_OFFSET_SAME_INSTANT,
+    MOMENT_PACKED_WITH_PRECISION,
+    MOMENT_PACKED_AT_MIDNIGHT,
+    MOMENT_PACKED_TRUNCATE,
+} moment_packed_op_t;
+
+typedef enum {
+    MOMENT_PACKED_UNION=0,
+    MOMENT_PACKED_INTERSECTION,
+    MOMENT_PACKED_DIFFERENCE,
+} moment_packed_setop_t;
+
+typedef enum {
+    MOMENT_ASOF_BACKWARD=0,
+    MOMENT_ASOF_FORWARD,
+    MOMENT_ASOF_NEAREST,
+} moment_asof_direction_t;
+
+typedef struct {
+    int64_t sec;        /* instant as rata die seconds */
+    int32_t nsec;
+} moment_instant_t;
+
+/* The next element of a buffer in a k-way merge */
+typedef struct {
+    moment_instant_t key;
+    size_t source;
+    size_t index;
+} moment_merge_node_t;
+
+/*
+ * An as-of join matches each element with the last element of the other
+ * buffer on or before it, the first on or after it, or the closer of the
+ * two, and if tolerant only with one within the tolerance in the unit.
+ */
+typedef struct {
+    moment_asof_direction_t direction;
+    bool tolerant;
+    moment_unit_t unit;
+    int64_t tolerance;
+} moment_packed_asof_t;
+
+/* A set of values of a field, as a bitset over the values min to max */
+typedef struct {
+    moment_component_t field;
+    int32_t min;
+    int32_t max;
+    const uint64_t *set;    /* bit v - min is set for each value v in the set */
+} moment_field_set_t;
+
+/*
+ * The elements selected by a filter are on or after from and before to,
+ * either of which may be NULL for no bound, and have a value of each field
+ * in its set at the given offset.
+ */
+typedef struct {
+    const moment_t *from;
+    const moment_t *to;
+    int64_t offset;
+    const moment_field_set_t *fields;
+    size_t nfields;
+} moment_packed_filter_t;
+
+size_t           moment_packed_width(moment_packed_t f);
+moment_instant_t moment_packed_get(const void *buf, moment_packed_t f, size_t i);
+moment_instant_t moment_instant(const moment_t *mt);
+int              moment_instant_compare(const moment_instant_t *a, const moment_instant_t *b);
+
+bool        moment_packed_epoch_bounds(moment_packed_t f, const moment_t *from, const moment_t *to,
+                                       int64_t *lo, int64_t *hi);
+size_t      moment_packed_lower_bound(const void *buf, size_t n, moment_packed_t f, const moment_t *key);
+size_t      moment_packed_upper_bound(const void *buf, size_t n, moment_packed_t f, const moment_t *key);
+size_t      moment_packed_delta(const void *start, const void *end, size_t n, moment_packed_t f,
+                                moment_unit_t u, int64_t *r, unsigned char *overflow);
+
+moment_status_t moment_core_packed_fields(const void *buf, size_t n, moment_packed_t f, int64_t offset,
+                                          const moment_component_t *fields, size_t nfields, int32_t * const *cols);
+moment_status_t moment_core_packed_filter(const void *buf, size_t n, moment_packed_t f,
+                                          const moment_packed_filter_t *flt, unsigned char *bitmap, size_t *r);
+size_t          moment_packed_bitmap_indices(const unsigned char *bitmap, size_t n, int64_t *r);
+moment_status_t moment_core_packed_transform(void *buf, size_t n, moment_packed_op_t op, moment_unit_t u, int64_t v,
+                                             unsigned char *failed, size_t *r);
+
+size_t          moment_packed_setop(const void *a, size_t na, const void *b, size_t nb, moment_packed_t f,
+                                    moment_packed_setop_t op, void *r);
+moment_status_t moment_core_packed_dedupe(const void *buf, size_t n, moment_packed_t f, int64_t precision,
+                                          void *r, size_t *rn);
+moment_status_t moment_core_packed_asof(const void *left, size_t nl, const void *right, size_t nr, moment_packed_t f,
+                                        const moment_packed_asof_t *join, int64_t *r, size_t *rn);
+moment_status_t moment_core_packed_window(const void *buf, size_t n, moment_packed_t f, moment_unit_t u, int64_t window,
+                                          int64_t *counts, int64_t *first, int64_t *last);
+size_t          moment_packed_merge(const void * const *bufs, const size_t *ns, size_t k, moment_packed_t f,
+                                    moment_merge_node_t *heap, int32_t *sources, int64_t *indices);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,9 +1,9 @@
-#include "moment.h"
+#include "moment_core.h"
 #include "dt_core.h"
 #include "dt_parse_iso.h"
 
 static int
-parse_string_lenient(const char *str, size_t len, int64_t *sp, IV *np, IV *op) {
+parse_string_lenient(const char *str, size_t len, int64_t *sp, int64_t *np, int64_t *op) {
     size_t n;
     dt_t dt;
     char c;
@@ -41,7 +41,7 @@ parse_string_lenient(const char *str, size_t len, int64_t *sp, IV *np, IV *op) {
 }
 
 static int
-parse_string_strict(const char *str, size_t len, int64_t *sp, IV *np, IV *op) {
+parse_string_strict(const char *str, size_t len, int64_t *sp, int64_t *np, int64_t *op) {
     size_t n;
     dt_t dt;
     int sod, nanosecond, offset;
@@ -87,11 +87,10 @@ parse_string_strict(const char *str, size_t len, int64_t *sp, IV *np, IV *op) {
     return 0;
 }
 
-moment_t
-THX_moment_from_string(pTHX_ const char *str, STRLEN len, bool lenient) {
+moment_status_t
+moment_core_from_string(const char *str, size_t len, bool lenient, moment_t *r) {
     int ret;
-    int64_t seconds;
-    IV nanosecond, offset;
+    int64_t seconds, nanosecond, offset;
 
     if (lenient)
         ret = parse_string_lenient(str, len, &seconds, &nanosecond, &offset);
@@ -99,8 +98,7 @@ THX_moment_from_string(pTHX_ const char *str, STRLEN len, bool lenient) {
         ret = parse_string_strict(str, len, &seconds, &nanosecond, &offset);
 
     if (ret != 0)
-        croak("Could not parse the given string");
+        return MOMENT_ERR_PARSE;
 
-    return moment_from_epoch(seconds, nanosecond, offset);
+    return moment_core_from_epoch(seconds, nanosecond, offset, r);
 }
-
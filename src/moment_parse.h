@@ -1,11 +1,24 @@
 #ifndef __MOMENT_PARSE_H__
 #define __MOMENT_PARSE_H__
 #include "moment.h"
+#include "moment_iso.h"
 
 moment_t THX_moment_from_string(pTHX_ const char *str, STRLEN len, bool lenient);
+moment_period_t THX_moment_period_from_string(pTHX_ const char *str, STRLEN len);
+moment_duration_t THX_moment_duration_from_string(pTHX_ const char *str, STRLEN len);
+moment_iso_interval_t THX_moment_interval_from_string(pTHX_ const char *str, STRLEN len);
 
 #define moment_from_string(str, len, lenient) \
     THX_moment_from_string(aTHX_ str, len, lenient)
 
+#define moment_period_from_string(str, len) \
+    THX_moment_period_from_string(aTHX_ str, len)
+
+#define moment_duration_from_string(str, len) \
+    THX_moment_duration_from_string(aTHX_ str, len)
+
+#define moment_interval_from_string(str, len) \
+    THX_moment_interval_from_string(aTHX_ str, len)
+
 #endif
 
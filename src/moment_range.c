@@ -0,0 +1,81 @@
+#include "moment_range.h"
+
+#define CHECK(expr) do {                    \
+    const moment_status_t status_ = (expr); \
+    if (status_ != MOMENT_OK)               \
+        return status_;                     \
+} while (0)
+
+moment_status_t
+moment_core_range_new(const moment_t *start, const moment_t *end, moment_unit_t u, int64_t step, moment_range_t *r) {
+    moment_range_t range;
+
+    if (step == 0)
+        return MOMENT_ERR_PARAM_STEP;
+
+    range.start    = *start;
+    range.end      = *end;
+    range.index    = 0;
+    range.sign     = step < 0 ? -1 : 1;
+    range.months   = 0;
+    range.duration.sec  = 0;
+    range.duration.nsec = 0;
+
+    switch (u) {
+        case MOMENT_UNIT_YEARS:
+        case MOMENT_UNIT_MONTHS: {
+            moment_t tmp;
+            const moment_status_t status = moment_core_plus_unit(start, u, step, &tmp);
+
+            /* The first step may fall outside the supported range */
+            if (status != MOMENT_OK && status != MOMENT_ERR_RANGE)
+                return status;
+            range.calendar = 1;
+            range.months   = u == MOMENT_UNIT_YEARS ? step * 12 : step;
+            break;
+        }
+        default:
+            CHECK(moment_core_duration_from_unit(u, step, &range.duration));
+            range.calendar = 0;
+            break;
+    }
+    *r = range;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+range_at(const moment_range_t *r, int64_t k, moment_t *mt) {
+    moment_duration_t d;
+
+    if (r->calendar)
+        return moment_core_plus_unit(&r->start, MOMENT_UNIT_MONTHS, k * r->months, mt);
+    CHECK(moment_core_duration_multiply(&r->duration, k, &d));
+    return moment_core_plus_duration(&r->start, &d, mt);
+}
+
+/* Stores the next moment of the range in mt, or returns false at the end */
+bool
+moment_range_next(moment_range_t *r, moment_t *mt) {
+    moment_t m;
+    int c;
+
+    if (r->index < 0)
+        return false;
+    if (range_at(r, r->index, &m) != MOMENT_OK)
+        goto done;
+    c = moment_compare_instant(&m, &r->end);
+    if (r->sign > 0 ? c >= 0 : c <= 0)
+        goto done;
+    r->index++;
+    *mt = m;
+    return true;
+
+  done:
+    r->index = -1;
+    return false;
+}
+
+void
+moment_range_reset(moment_range_t *r) {
+    r->index = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef __MOMENT_RANGE_H__
+#define __MOMENT_RANGE_H__
+#include "moment_core.h"
+#include "moment_duration.h"
+
+/*
+ * Lazy sequences of moments start, start + step, start + 2 * step, ...
+ * up to, but not including, end. A negative step counts down from start
+ * towards end. The k-th moment is always computed from start, so years
+ * and months are clamped to the end of the month as by dt_add_months()
+ * without accumulating: 01-31, 02-29, 03-31, ...
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    moment_t start;
+    moment_t end;
+    moment_duration_t duration; /* step of the time units */
+    int64_t months;             /* step of the calendar units */
+    int64_t index;
+    int32_t calendar;
+    int32_t sign;
+} moment_range_t;
+
+moment_status_t moment_core_range_new(const moment_t *start, const moment_t *end, moment_unit_t u, int64_t step, moment_range_t *r);
+
+bool        moment_range_next(moment_range_t *r, moment_t *mt);
+void        moment_range_reset(moment_range_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
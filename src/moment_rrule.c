@@ -0,0 +1,494 @@
+#include <stdlib.h>
+#include <string.h>
+#include "moment_rrule.h"
+#include "dt_core.h"
+#include "dt_util.h"
+#include "dt_valid.h"
+
+#define CHECK(expr) do {                    \
+    const moment_status_t status_ = (expr); \
+    if (status_ != MOMENT_OK)               \
+        return status_;                     \
+} while (0)
+
+#define MIN_RDN 1
+#define MAX_RDN 3652059
+
+static const char * const kDayNames[] = {
+    "MO", "TU", "WE", "TH", "FR", "SA", "SU",
+};
+
+typedef struct {
+    const char *p;
+    const char *end;
+} rrule_input_t;
+
+static bool
+consume(rrule_input_t *in, const char *s) {
+    const size_t n = strlen(s);
+
+    if ((size_t)(in->end - in->p) < n || memcmp(in->p, s, n) != 0)
+        return false;
+    in->p += n;
+    return true;
+}
+
+static bool
+at_value_end(const rrule_input_t *in) {
+    return in->p == in->end || *in->p == ';';
+}
+
+static bool
+parse_int(rrule_input_t *in, bool sign, int *v) {
+    const char *p = in->p;
+    int n = 0, neg = 0;
+
+    if (sign && p < in->end && (*p == '+' || *p == '-'))
+        neg = *p++ == '-';
+    if (p == in->end || *p < '0' || *p > '9')
+        return false;
+    do {
+        n = n * 10 + (*p++ - '0');
+        if (n > 999999)
+            return false;
+    } while (p < in->end && *p >= '0' && *p <= '9');
+    in->p = p;
+    *v = neg ? -n : n;
+    return true;
+}
+
+static bool
+parse_weekday(rrule_input_t *in, int *dow) {
+    int i;
+
+    for (i = 0; i < 7; i++) {
+        if (consume(in, kDayNames[i])) {
+            *dow = i + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Parses a comma separated list of integers in [min, max], excluding zero */
+static moment_status_t
+parse_int_list(rrule_input_t *in, int min, int max, int *list, int maxn, int *n) {
+    int v;
+
+    *n = 0;
+    for (;;) {
+        if (!parse_int(in, min < 0, &v) || v < min || v > max || v == 0)
+            return MOMENT_ERR_RRULE_SYNTAX;
+        if (*n == maxn)
+            return MOMENT_ERR_RRULE_SYNTAX;
+        list[(*n)++] = v;
+        if (at_value_end(in))
+            return MOMENT_OK;
+        if (!consume(in, ","))
+            return MOMENT_ERR_RRULE_SYNTAX;
+    }
+}
+
+static moment_status_t
+parse_until(rrule_input_t *in, const moment_t *dtstart, moment_rrule_t *rr) {
+    const char *start = in->p;
+    char buf[32];
+    size_t len;
+    moment_t mt;
+
+    while (!at_value_end(in))
+        in->p++;
+    len = in->p - start;
+    if (len == 8) {
+        int y, m, d;
+        memcpy(buf, start, 8);
+        buf[8] = '\0';
+        y = (buf[0] - '0') * 1000 + (buf[1] - '0') * 100 + (buf[2] - '0') * 10 + (buf[3] - '0');
+        m = (buf[4] - '0') * 10 + (buf[5] - '0');
+        d = (buf[6] - '0') * 10 + (buf[7] - '0');
+        if (strspn(buf, "0123456789") != 8 || !dt_valid_ymd(y, m, d) || y < 1)
+            return MOMENT_ERR_RRULE_SYNTAX;
+        rr->until_date = dt_rdn(dt_from_ymd(y, m, d));
+        rr->has_until = 1;
+        return MOMENT_OK;
+    }
+    if (len == 0 || len >= sizeof(buf) - 1)
+        return MOMENT_ERR_RRULE_SYNTAX;
+    memcpy(buf, start, len);
+    if (start[len - 1] == 'Z') {
+        if (moment_core_from_string(buf, len, false, &mt) != MOMENT_OK)
+            return MOMENT_ERR_RRULE_SYNTAX;
+    }
+    else {
+        /* A floating date and time is in the offset of DTSTART */
+        buf[len] = 'Z';
+        if (moment_core_from_string(buf, len + 1, false, &mt) != MOMENT_OK)
+            return MOMENT_ERR_RRULE_SYNTAX;
+        mt.offset = dtstart->offset;
+    }
+    rr->until = mt;
+    rr->has_until = 1;
+    return MOMENT_OK;
+}
+
+static moment_status_t
+parse_byday(rrule_input_t *in, moment_rrule_t *rr) {
+    int ordinal, dow;
+
+    for (;;) {
+        ordinal = 0;
+        if (in->p < in->end && ((*in->p >= '0' && *in->p <= '9') || *in->p == '+' || *in->p == '-')) {
+            if (!parse_int(in, true, &ordinal) || ordinal == 0 || ordinal < -53 || ordinal > 53)
+                return MOMENT_ERR_RRULE_SYNTAX;
+        }
+        if (!parse_weekday(in, &dow) || rr->nbyday == MOMENT_RRULE_MAX_BYDAY)
+            return MOMENT_ERR_RRULE_SYNTAX;
+        rr->byday[rr->nbyday].ordinal = (int8_t)ordinal;
+        rr->byday[rr->nbyday].day_of_week = (int8_t)dow;
+        rr->nbyday++;
+        if (at_value_end(in))
+            return MOMENT_OK;
+        if (!consume(in, ","))
+            return MOMENT_ERR_RRULE_SYNTAX;
+    }
+}
+
+enum {
+    PART_FREQ       = 1 << 0,
+    PART_INTERVAL   = 1 << 1,
+    PART_COUNT      = 1 << 2,
+    PART_UNTIL      = 1 << 3,
+    PART_BYMONTH    = 1 << 4,
+    PART_BYMONTHDAY = 1 << 5,
+    PART_BYDAY      = 1 << 6,
+    PART_BYSETPOS   = 1 << 7,
+    PART_WKST       = 1 << 8,
+};
+
+moment_status_t
+moment_core_rrule_parse(const moment_t *dtstart, const char *str, size_t len, moment_rrule_t *r) {
+    moment_rrule_t rr;
+    rrule_input_t in;
+    int list[MOMENT_RRULE_MAX_BYSETPOS];
+    int parts = 0, part, n, i;
+    dt_t dt;
+
+    memset(&rr, 0, sizeof(rr));
+    rr.dtstart  = *dtstart;
+    rr.interval = 1;
+    rr.wkst     = DT_MONDAY;
+
+    in.p = str;
+    in.end = str + len;
+    (void)consume(&in, "RRULE:");
+    for (;;) {
+        if (consume(&in, "FREQ=")) {
+            part = PART_FREQ;
+            if (consume(&in, "YEARLY"))
+                rr.freq = MOMENT_FREQ_YEARLY;
+            else if (consume(&in, "MONTHLY"))
+                rr.freq = MOMENT_FREQ_MONTHLY;
+            else if (consume(&in, "WEEKLY"))
+                rr.freq = MOMENT_FREQ_WEEKLY;
+            else if (consume(&in, "DAILY"))
+                rr.freq = MOMENT_FREQ_DAILY;
+            else if (consume(&in, "HOURLY") || consume(&in, "MINUTELY") || consume(&in, "SECONDLY"))
+                return MOMENT_ERR_RRULE_UNSUPPORTED;
+            else
+                return MOMENT_ERR_RRULE_SYNTAX;
+        }
+        else if (consume(&in, "INTERVAL=")) {
+            part = PART_INTERVAL;
+            if (!parse_int(&in, false, &n) || n < 1)
+                return MOMENT_ERR_RRULE_SYNTAX;
+            rr.interval = n;
+        }
+        else if (consume(&in, "COUNT=")) {
+            part = PART_COUNT;
+            if (!parse_int(&in, false, &n) || n < 1)
+                return MOMENT_ERR_RRULE_SYNTAX;
+            rr.count = n;
+        }
+        else if (consume(&in, "UNTIL=")) {
+            part = PART_UNTIL;
+            CHECK(parse_until(&in, dtstart, &rr));
+        }
+        else if (consume(&in, "BYMONTH=")) {
+            part = PART_BYMONTH;
+            CHECK(parse_int_list(&in, 1, 12, list, MOMENT_RRULE_MAX_BYSETPOS, &n));
+            for (i = 0; i < n; i++)
+                rr.bymonth |= UINT32_C(1) << list[i];
+        }
+        else if (consume(&in, "BYMONTHDAY=")) {
+            part = PART_BYMONTHDAY;
+            CHECK(parse_int_list(&in, -31, 31, list, MOMENT_RRULE_MAX_BYSETPOS, &n));
+            for (i = 0; i < n; i++) {
+                if (list[i] > 0)
+                    rr.bymonthday |= UINT32_C(1) << list[i];
+                else
+                    rr.bymonthday_neg |= UINT32_C(1) << -list[i];
+            }
+        }
+        else if (consume(&in, "BYDAY=")) {
+            part = PART_BYDAY;
+            CHECK(parse_byday(&in, &rr));
+        }
+        else if (consume(&in, "BYSETPOS=")) {
+            part = PART_BYSETPOS;
+            CHECK(parse_int_list(&in, -366, 366, list, MOMENT_RRULE_MAX_BYSETPOS, &n));
+            for (i = 0; i < n; i++)
+                rr.bysetpos[i] = (int16_t)list[i];
+            rr.nbysetpos = n;
+        }
+        else if (consume(&in, "WKST=")) {
+            part = PART_WKST;
+            if (!parse_weekday(&in, &n))
+                return MOMENT_ERR_RRULE_SYNTAX;
+            rr.wkst = n;
+        }
+        else if (consume(&in, "BYSECOND=") || consume(&in, "BYMINUTE=") || consume(&in, "BYHOUR=")
+              || consume(&in, "BYYEARDAY=") || consume(&in, "BYWEEKNO="))
+            return MOMENT_ERR_RRULE_UNSUPPORTED;
+        else
+            return MOMENT_ERR_RRULE_SYNTAX;
+
+        if (parts & part)
+            return MOMENT_ERR_RRULE_SYNTAX;
+        parts |= part;
+        if (in.p == in.end)
+            break;
+        if (!consume(&in, ";") || in.p == in.end)
+            return MOMENT_ERR_RRULE_SYNTAX;
+    }
+
+    if (!(parts & PART_FREQ))
+        return MOMENT_ERR_RRULE_SYNTAX;
+    if ((parts & PART_COUNT) && (parts & PART_UNTIL))
+        return MOMENT_ERR_RRULE_SYNTAX;
+
+    /* Ordinal days of the week are only defined within a month or a year */
+    for (i = 0; i < rr.nbyday; i++) {
+        const int ordinal = rr.byday[i].ordinal;
+        if (ordinal == 0)
+            continue;
+        if (rr.freq == MOMENT_FREQ_WEEKLY || rr.freq == MOMENT_FREQ_DAILY)
+            return MOMENT_ERR_RRULE_SYNTAX;
+        if ((rr.freq == MOMENT_FREQ_MONTHLY || rr.bymonth) && (ordinal < -5 || ordinal > 5))
+            return MOMENT_ERR_RRULE_SYNTAX;
+    }
+
+    /* Without any day parts, the day is taken from DTSTART */
+    if (!(parts & (PART_BYMONTHDAY | PART_BYDAY))) {
+        int y, m, d;
+
+        dt = moment_local_dt(dtstart);
+        dt_to_ymd(dt, &y, &m, &d);
+        switch (rr.freq) {
+            case MOMENT_FREQ_YEARLY:
+                if (!rr.bymonth)
+                    rr.bymonth = UINT32_C(1) << m;
+                /* FALLTHROUGH */
+            case MOMENT_FREQ_MONTHLY:
+                rr.bymonthday = UINT32_C(1) << d;
+                break;
+            case MOMENT_FREQ_WEEKLY:
+                rr.byday[0].ordinal = 0;
+                rr.byday[0].day_of_week = (int8_t)dt_dow(dt);
+                rr.nbyday = 1;
+                break;
+        }
+    }
+    moment_rrule_reset(&rr);
+    *r = rr;
+    return MOMENT_OK;
+}
+
+bool
+moment_rrule_is_bounded(const moment_rrule_t *rr) {
+    return rr->count != 0 || rr->has_until;
+}
+
+void
+moment_rrule_reset(moment_rrule_t *rr) {
+    rr->period  = 0;
+    rr->emitted = 0;
+    rr->ndays   = 0;
+    rr->pos     = 0;
+    rr->done    = 0;
+}
+
+static bool
+byday_matches(const moment_rrule_t *rr, dt_t dt, int dow, dt_t first, dt_t last) {
+    int i;
+
+    for (i = 0; i < rr->nbyday; i++) {
+        const moment_rrule_day_t *bd = &rr->byday[i];
+        if (bd->day_of_week != dow)
+            continue;
+        if (bd->ordinal == 0)
+            return true;
+        if (bd->ordinal > 0 && (dt - first) / 7 + 1 == bd->ordinal)
+            return true;
+        if (bd->ordinal < 0 && -((last - dt) / 7 + 1) == bd->ordinal)
+            return true;
+    }
+    return false;
+}
+
+static bool
+day_matches(const moment_rrule_t *rr, dt_t dt, dt_t year_first, dt_t year_last) {
+    int y, m, d;
+
+    dt_to_ymd(dt, &y, &m, &d);
+    if (rr->bymonth && !((rr->bymonth >> m) & 1))
+        return false;
+    if (rr->bymonthday | rr->bymonthday_neg) {
+        const int neg = dt_days_in_month(y, m) - d + 1;
+        if (!((rr->bymonthday >> d) & 1) && !((rr->bymonthday_neg >> neg) & 1))
+            return false;
+    }
+    if (rr->nbyday) {
+        dt_t first = year_first, last = year_last;
+
+        /* Ordinals count within the month, unless yearly without BYMONTH */
+        if (rr->freq != MOMENT_FREQ_YEARLY || rr->bymonth) {
+            first = dt - (d - 1);
+            last  = first + dt_days_in_month(y, m) - 1;
+        }
+        if (!byday_matches(rr, dt, dt_dow(dt), first, last))
+            return false;
+    }
+    return true;
+}
+
+static int
+compare_int32(const void *a, const void *b) {
+    const int32_t x = *(const int32_t *)a;
+    const int32_t y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Expands the days of the k-th period into rr->days, or returns false past the supported range */
+static bool
+rrule_expand(moment_rrule_t *rr, int64_t k) {
+    const dt_t start = moment_local_dt(&rr->dtstart);
+    int32_t days[366];
+    dt_t first, last, dt;
+    int y, m, n = 0, i;
+
+    switch (rr->freq) {
+        case MOMENT_FREQ_YEARLY: {
+            int64_t year;
+
+            dt_to_ymd(start, &y, NULL, NULL);
+            year = y + k * rr->interval;
+            if (year > 9999)
+                return false;
+            first = dt_from_ymd((int)year, 1, 1);
+            last  = dt_from_ymd((int)year + 1, 1, 1) - 1;
+            break;
+        }
+        case MOMENT_FREQ_MONTHLY: {
+            int64_t month;
+
+            dt_to_ymd(start, &y, &m, NULL);
+            month = (int64_t)y * 12 + (m - 1) + k * rr->interval;
+            if (month / 12 > 9999)
+                return false;
+            first = dt_from_ymd((int)(month / 12), (int)(month % 12) + 1, 1);
+            last  = dt_from_ymd((int)(month / 12), (int)(month % 12) + 2, 0);
+            break;
+        }
+        case MOMENT_FREQ_WEEKLY: {
+            const dt_t week = start - (dt_dow(start) - rr->wkst + 7) % 7;
+            const int64_t f = dt_rdn(week) + k * rr->interval * 7;
+
+            if (f > MAX_RDN)
+                return false;
+            first = dt_from_rdn((int)f);
+            last  = first + 6;
+            break;
+        }
+        default: {
+            const int64_t f = dt_rdn(start) + k * rr->interval;
+
+            if (f > MAX_RDN)
+                return false;
+            first = last = dt_from_rdn((int)f);
+            break;
+        }
+    }
+
+    {
+        dt_t year_first = 0, year_last = 0;
+
+        if (rr->freq == MOMENT_FREQ_YEARLY)
+            year_first = first, year_last = last;
+        for (dt = first; dt <= last; dt++) {
+            if (dt_rdn(dt) > MAX_RDN)
+                break;
+            if (day_matches(rr, dt, year_first, year_last))
+                days[n++] = dt_rdn(dt);
+        }
+    }
+
+    if (rr->nbysetpos) {
+        int j = 0;
+
+        for (i = 0; i < rr->nbysetpos; i++) {
+            const int p = rr->bysetpos[i];
+            const int idx = p > 0 ? p - 1 : n + p;
+            if (idx >= 0 && idx < n)
+                rr->days[j++] = days[idx];
+        }
+        /* Positions may select the same day more than once, in any order */
+        qsort(rr->days, j, sizeof(int32_t), compare_int32);
+        for (i = 0, n = 0; i < j; i++) {
+            if (n == 0 || rr->days[n - 1] != rr->days[i])
+                rr->days[n++] = rr->days[i];
+        }
+    }
+    else
+        memcpy(rr->days, days, n * sizeof(int32_t));
+    rr->ndays = n;
+    rr->pos = 0;
+    return true;
+}
+
+/* Stores the next occurrence in mt, or returns false when there are no more */
+bool
+moment_rrule_next(moment_rrule_t *rr, moment_t *mt) {
+    const int start = dt_rdn(moment_local_dt(&rr->dtstart));
+    const int64_t sod = rr->dtstart.sec % 86400;
+
+    if (rr->done)
+        return false;
+    for (;;) {
+        while (rr->pos < rr->ndays) {
+            const int rdn = rr->days[rr->pos++];
+            moment_t m;
+
+            if (rdn < start)
+                continue;
+            m.sec    = (int64_t)rdn * 86400 + sod;
+            m.nsec   = rr->dtstart.nsec;
+            m.offset = rr->dtstart.offset;
+            if (rr->has_until) {
+                if (rr->until_date ? rdn > rr->until_date
+                                   : moment_compare_instant(&m, &rr->until) > 0)
+                    goto done;
+            }
+            *mt = m;
+            if (rr->count && ++rr->emitted == rr->count)
+                rr->done = 1;
+            return true;
+        }
+        if (!rrule_expand(rr, rr->period))
+            goto done;
+        rr->period++;
+    }
+  done:
+    rr->done = 1;
+    rr->ndays = rr->pos = 0;
+    return false;
+}
@@ -0,0 +1,68 @@
+#ifndef __MOMENT_RRULE_H__
+#define __MOMENT_RRULE_H__
+#include "moment_core.h"
+
+/*
+ * RFC 5545 recurrence rules with the FREQ values YEARLY, MONTHLY, WEEKLY
+ * and DAILY and the rule parts INTERVAL, COUNT, UNTIL, BYMONTH,
+ * BYMONTHDAY, BYDAY, BYSETPOS and WKST. The occurrences have the time of
+ * day and offset of DTSTART and are expanded lazily, one period of the
+ * frequency at a time; the days of the current period are kept in the
+ * rule itself, so it is a single block of memory without pointers.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOMENT_RRULE_MAX_BYDAY      64
+#define MOMENT_RRULE_MAX_BYSETPOS   64
+
+typedef enum {
+    MOMENT_FREQ_YEARLY=0,
+    MOMENT_FREQ_MONTHLY,
+    MOMENT_FREQ_WEEKLY,
+    MOMENT_FREQ_DAILY,
+} moment_freq_t;
+
+typedef struct {
+    int8_t ordinal;     /* 0 for every such day of the week */
+    int8_t day_of_week; /* 1 is Monday */
+} moment_rrule_day_t;
+
+typedef struct {
+    moment_t dtstart;
+    moment_t until;
+    int64_t  count;             /* 0 if not limited by COUNT */
+    int32_t  freq;
+    int32_t  interval;
+    int32_t  wkst;
+    int32_t  until_date;        /* rata die day of a date UNTIL, or 0 */
+    int32_t  has_until;
+    uint32_t bymonth;           /* bits 1-12 */
+    uint32_t bymonthday;        /* bits 1-31 */
+    uint32_t bymonthday_neg;    /* bit n for -n */
+    int32_t  nbyday;
+    int32_t  nbysetpos;
+    moment_rrule_day_t byday[MOMENT_RRULE_MAX_BYDAY];
+    int16_t  bysetpos[MOMENT_RRULE_MAX_BYSETPOS];
+
+    /* Iteration state */
+    int64_t  period;
+    int64_t  emitted;
+    int32_t  ndays;
+    int32_t  pos;
+    int32_t  done;
+    int32_t  days[366];
+} moment_rrule_t;
+
+moment_status_t moment_core_rrule_parse(const moment_t *dtstart, const char *str, size_t len, moment_rrule_t *r);
+
+bool        moment_rrule_next(moment_rrule_t *rr, moment_t *mt);
+void        moment_rrule_reset(moment_rrule_t *rr);
+bool        moment_rrule_is_bounded(const moment_rrule_t *rr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
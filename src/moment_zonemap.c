@@ -0,0 +1,159 @@
+#include <string.h>
+#include "moment_zonemap.h"
+
+#define MAX_BLOCK INT64_C(0x7FFFFFFF)
+
+static moment_zone_t *
+zonemap_zones(const moment_zonemap_t *zm) {
+    return (moment_zone_t *)(zm + 1);
+}
+
+static size_t
+zonemap_size(uint64_t elements, uint32_t block) {
+    const uint64_t blocks = elements / block + (elements % block != 0);
+    return sizeof(moment_zonemap_t) + (size_t)blocks * sizeof(moment_zone_t);
+}
+
+moment_status_t
+moment_core_zonemap_size(uint64_t elements, int64_t block, size_t *r) {
+    if (block < 1 || block > MAX_BLOCK)
+        return MOMENT_ERR_ZONEMAP_BLOCK;
+    *r = zonemap_size(elements, (uint32_t)block);
+    return MOMENT_OK;
+}
+
+size_t
+moment_zonemap_blocks(const moment_zonemap_t *zm) {
+    return (size_t)(zm->elements / zm->block + (zm->elements % zm->block != 0));
+}
+
+moment_status_t
+moment_core_zonemap_check(const void *blob, size_t len) {
+    moment_zonemap_t zm;
+
+    if (len < sizeof(moment_zonemap_t) ||
+        (len - sizeof(moment_zonemap_t)) % sizeof(moment_zone_t) != 0)
+        return MOMENT_ERR_ZONEMAP_INVALID;
+    memcpy(&zm, blob, sizeof(moment_zonemap_t));
+    if (zm.magic != MOMENT_ZONEMAP_MAGIC ||
+        zm.format > MOMENT_PACKED_MOMENT ||
+        zm.block < 1 || zm.block > MAX_BLOCK)
+        return MOMENT_ERR_ZONEMAP_INVALID;
+    /* The number of blocks is taken from the length, as a forged number of
+       elements could wrap the size computed from it */
+    if ((uint64_t)((len - sizeof(moment_zonemap_t)) / sizeof(moment_zone_t)) !=
+        zm.elements / zm.block + (zm.elements % zm.block != 0))
+        return MOMENT_ERR_ZONEMAP_INVALID;
+    return MOMENT_OK;
+}
+
+/* The keys of the elements [from, to) of a block */
+static moment_zone_t
+zone_of(const void *buf, size_t from, size_t to, moment_packed_t f) {
+    moment_zone_t z;
+    size_t i;
+
+    z.min = INT64_MAX;
+    z.max = INT64_MIN;
+    if (f == MOMENT_PACKED_MOMENT) {
+        for (i = from; i < to; i++) {
+            moment_t mt;
+            int64_t s;
+
+            memcpy(&mt, (const char *)buf + i * sizeof(moment_t), sizeof(moment_t));
+            s = moment_instant_rd_seconds(&mt);
+            z.min = s < z.min ? s : z.min;
+            s += mt.nsec > 0;
+            z.max = s > z.max ? s : z.max;
+        }
+    }
+    else {
+        for (i = from; i < to; i++) {
+            int64_t v;
+
+            memcpy(&v, (const char *)buf + i * sizeof(int64_t), sizeof(int64_t));
+            z.min = v < z.min ? v : z.min;
+            z.max = v > z.max ? v : z.max;
+        }
+    }
+    return z;
+}
+
+static void
+zonemap_fill(moment_zonemap_t *zm, const void *buf, size_t first) {
+    const moment_packed_t f = (moment_packed_t)zm->format;
+    const size_t n = (size_t)zm->elements;
+    const size_t blocks = moment_zonemap_blocks(zm);
+    moment_zone_t *zones = zonemap_zones(zm);
+    size_t b;
+
+    for (b = first; b < blocks; b++) {
+        const size_t from = b * zm->block;
+        const size_t to = n - from < zm->block ? n : from + zm->block;
+
+        zones[b] = zone_of(buf, from, to, f);
+    }
+}
+
+/* Builds a zone map in zm, of moment_core_zonemap_size(n, block) bytes */
+moment_status_t
+moment_core_zonemap_build(const void *buf, size_t n, moment_packed_t f, int64_t block, moment_zonemap_t *zm) {
+    if (block < 1 || block > MAX_BLOCK)
+        return MOMENT_ERR_ZONEMAP_BLOCK;
+
+    zm->magic    = MOMENT_ZONEMAP_MAGIC;
+    zm->format   = (uint32_t)f;
+    zm->block    = (uint32_t)block;
+    zm->reserved = 0;
+    zm->elements = n;
+    zonemap_fill(zm, buf, 0);
+    return MOMENT_OK;
+}
+
+/*
+ * Builds in r the zone map of a buffer that has grown by appending to the
+ * buffer of zm: the complete blocks of zm are kept and the rest are
+ * computed from the buffer. The buffer must have at least the elements
+ * of zm and r must have room for the zone map of all of them.
+ */
+moment_status_t
+moment_core_zonemap_extend(const moment_zonemap_t *zm, const void *buf, size_t n, moment_zonemap_t *r) {
+    const size_t complete = (size_t)(zm->elements / zm->block);
+
+    if (n < zm->elements)
+        return MOMENT_ERR_ZONEMAP_SHRUNK;
+
+    memcpy(r, zm, sizeof(moment_zonemap_t) + complete * sizeof(moment_zone_t));
+    r->elements = n;
+    zonemap_fill(r, buf, complete);
+    return MOMENT_OK;
+}
+
+/* Stores the index of each block that may have an element in [from, to) in r; returns their number */
+size_t
+moment_zonemap_candidates(const moment_zonemap_t *zm, const moment_t *from, const moment_t *to, int64_t *r) {
+    const moment_zone_t *zones = zonemap_zones(zm);
+    const size_t blocks = moment_zonemap_blocks(zm);
+    int64_t lo, hi;
+    size_t b, count = 0;
+
+    if (zm->format == MOMENT_PACKED_MOMENT) {
+        if (from && to) {
+            const moment_instant_t a = moment_instant(from);
+            const moment_instant_t b = moment_instant(to);
+
+            if (moment_instant_compare(&a, &b) >= 0)
+                return 0;
+        }
+        lo = from ? moment_instant_rd_seconds(from) : INT64_MIN;
+        hi = to   ? moment_instant_rd_seconds(to) - (to->nsec == 0) : INT64_MAX;
+    }
+    else if (!moment_packed_epoch_bounds((moment_packed_t)zm->format, from, to, &lo, &hi))
+        return 0;
+
+    for (b = 0; b < blocks; b++) {
+        r[count] = (int64_t)b;
+        count += (zones[b].max >= lo) & (zones[b].min <= hi);
+    }
+    return count;
+}
@@ -0,0 +1,56 @@
+#ifndef __MOMENT_ZONEMAP_H__
+#define __MOMENT_ZONEMAP_H__
+#include "moment_packed.h"
+
+/*
+ * Zone maps: the smallest and the largest key of each block of a fixed
+ * number of elements of a packed buffer, so that a range query only scans
+ * the blocks that may contain a match. The buffer need not be sorted.
+ *
+ * A zone map is a single block of memory, the header below followed by
+ * the keys of each block, with no pointers, so it can be stored next to
+ * the buffer and read back as is; its size is given by
+ * moment_core_zonemap_size(). Integers are in native byte order, as in the
+ * packed buffers.
+ *
+ * The keys are the counts of an epoch format, or the instant as rata die
+ * seconds for moments, the smallest rounded down and the largest rounded
+ * up, so the candidates of a query are exact for epoch buffers and may
+ * include a block that only has moments within a second of the range.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOMENT_ZONEMAP_MAGIC   0x315A4D54   /* "TMZ1" in little-endian */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t format;    /* moment_packed_t */
+    uint32_t block;     /* elements per block */
+    uint32_t reserved;
+    uint64_t elements;
+} moment_zonemap_t;
+
+typedef struct {
+    int64_t min;
+    int64_t max;
+} moment_zone_t;
+
+size_t      moment_zonemap_blocks(const moment_zonemap_t *zm);
+
+moment_status_t moment_core_zonemap_size(uint64_t elements, int64_t block, size_t *r);
+moment_status_t moment_core_zonemap_check(const void *blob, size_t len);
+moment_status_t moment_core_zonemap_build(const void *buf, size_t n, moment_packed_t f, int64_t block,
+                                          moment_zonemap_t *zm);
+moment_status_t moment_core_zonemap_extend(const moment_zonemap_t *zm, const void *buf, size_t n,
+                                           moment_zonemap_t *r);
+
+size_t      moment_zonemap_candidates(const moment_zonemap_t *zm, const moment_t *from, const moment_t *to,
+                                      int64_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,92 @@
+#ifndef __TIME_MOMENT_H__
+#define __TIME_MOMENT_H__
+
+/*
+ * Public C API of Time::Moment.
+ *
+ * This header is installed alongside the module so that other XS modules
+ * can create and inspect Time::Moment instances without method dispatch.
+ * The API table is only declared when the header is included after
+ * "EXTERN.h" and "perl.h"; otherwise only the moment_t type is declared.
+ *
+ *   #include "time_moment.h"
+ *
+ *   const moment_api_t *api;
+ *   MOMENT_API_FETCH(api);
+ *
+ *   moment_t mt = api->from_epoch(aTHX_ 1356355845, 0, 60);
+ *   SV *sv = api->newSVmoment(aTHX_ &mt);
+ *
+ * The table is published by Time::Moment when it is loaded, so the
+ * downstream module must load Time::Moment before fetching the table.
+ */
+
+#ifndef _MSC_VER
+#  include <stdint.h>
+#else
+#  if _MSC_VER >= 1600
+#   include <stdint.h>
+#  else
+    typedef __int32             int32_t;
+    typedef __int64             int64_t;
+    typedef unsigned __int32    uint32_t;
+    typedef unsigned __int64    uint64_t;
+#  endif
+#  ifndef INT64_C
+#   define INT64_C(x) x##i64
+#  endif
+#endif
+
+#define MOMENT_API_KEY        "Time::Moment::API"
+#define MOMENT_API_VERSION    1
+
+/* Large enough for the longest string produced by to_string() including NUL */
+#define MOMENT_STRING_MAX     40
+
+typedef struct {
+    int64_t sec;
+    int32_t nsec;
+    int32_t offset;
+} moment_t;
+
+#ifdef PERL_REVISION
+
+typedef struct {
+    int                 version;
+    size_t              size;
+
+    /* Constructs a moment from Unix epoch seconds, nanoseconds and an offset
+       in minutes; croaks if any of the values are out of range */
+    moment_t            (*from_epoch)(pTHX_ int64_t sec, IV nsec, IV offset);
+
+    /* Returns a new reference to a Time::Moment instance */
+    SV *                (*newSVmoment)(pTHX_ const moment_t *mt);
+
+    /* Returns true if the SV is a Time::Moment instance (or a subclass) */
+    bool                (*sv_isa_moment)(pTHX_ SV *sv);
+
+    /* Returns a pointer to the moment of a Time::Moment instance; croaks
+       with "<name> is not an instance of Time::Moment" otherwise */
+    const moment_t *    (*sv_2moment_ptr)(pTHX_ SV *sv, const char *name);
+
+    /* Writes the ISO 8601 representation into buf (NUL terminated, truncated
+       to len - 1 characters); returns the length of the full representation */
+    size_t              (*to_string)(const moment_t *mt, bool reduced, char *buf, size_t len);
+
+    /* Compares the instants of the two moments; returns -1, 0 or 1 */
+    int                 (*compare_instant)(const moment_t *mt1, const moment_t *mt2);
+} moment_api_t;
+
+#define MOMENT_API_FETCH(api) STMT_START {                                     \
+    SV ** const api_svp_ = hv_fetch(PL_modglobal, MOMENT_API_KEY,              \
+                                    sizeof(MOMENT_API_KEY) - 1, 0);            \
+    if (!api_svp_ || !SvIOK(*api_svp_))                                        \
+        croak("Time::Moment C API is not available, load Time::Moment first"); \
+    (api) = INT2PTR(const moment_api_t *, SvIVX(*api_svp_));                   \
+    if ((api)->version < MOMENT_API_VERSION)                                   \
+        croak("Time::Moment C API version %d is older than the required %d",   \
+              (api)->version, MOMENT_API_VERSION);                             \
+} STMT_END
+
+#endif /* PERL_REVISION */
+#endif
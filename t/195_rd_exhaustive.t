@@ -0,0 +1,46 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+
+BEGIN {
+    use_ok('Time::Moment');
+}
+
+# Walks every day between 0001-01-01 and 9999-12-31 and compares the
+# calendar date decoded from the rata die day against a day by day count.
+{
+    my @days_in_month = (0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31);
+
+    my $tm  = Time::Moment->new(year => 1, month => 1, day => 1);
+    my $rdn = 1;
+
+    for my $y (1..9999) {
+        my $leap = ($y % 4 == 0 && ($y % 100 != 0 || $y % 400 == 0)) ? 1 : 0;
+        my $doy  = 0;
+        my @bad;
+
+        for my $m (1..12) {
+            my $dim = $days_in_month[$m] + ($m == 2 ? $leap : 0);
+            for my $d (1..$dim) {
+                $doy++;
+                if (   $tm->year != $y
+                    || $tm->month != $m
+                    || $tm->day_of_month != $d
+                    || $tm->day_of_year != $doy
+                    || $tm->rdn != $rdn) {
+                    push @bad, sprintf '%04d-%02d-%02d (rdn: %d) decoded as %s',
+                      $y, $m, $d, $rdn, $tm->strftime('%Y-%m-%d (day of year: %j)');
+                }
+                $rdn++;
+                $tm = $tm->plus_days(1) if $rdn <= 3652059;
+            }
+        }
+        ok(!@bad, "every day of year $y")
+          or diag(join "\n", @bad[0 .. ($#bad < 4 ? $#bad : 4)]);
+    }
+    is($rdn - 1, 3652059, 'walked all rata die days');
+}
+
+done_testing();
@@ -0,0 +1,65 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+
+BEGIN {
+    use_ok('Time::Moment');
+}
+
+my @keys = qw(year month day hour minute second nanosecond offset);
+
+{
+    my $tm = Time::Moment->from_string('2012-12-24T15:30:45.123456789+01:00');
+
+    is_deeply([$tm->components], [2012, 12, 24, 15, 30, 45, 123456789, 60],
+      'components');
+
+    is_deeply($tm->to_hash, {
+        year       => 2012,
+        month      => 12,
+        day        => 24,
+        hour       => 15,
+        minute     => 30,
+        second     => 45,
+        nanosecond => 123456789,
+        offset     => 60,
+    }, 'to_hash');
+}
+
+{
+    my @strings = qw(
+        0001-01-01T00:00:00Z
+        9999-12-31T23:59:59.999999999Z
+        1970-01-01T00:00:00-18:00
+        2000-02-29T12:00:00+18:00
+        2013-03-31T01:59:59.5-05:30
+    );
+
+    foreach my $string (@strings) {
+        my $tm = Time::Moment->from_string($string);
+        my @expected = (
+            $tm->year, $tm->month, $tm->day_of_month,
+            $tm->hour, $tm->minute, $tm->second,
+            $tm->nanosecond, $tm->offset,
+        );
+        is_deeply([$tm->components], \@expected, "components of $string");
+
+        my %expected;
+        @expected{@keys} = @expected;
+        is_deeply($tm->to_hash, \%expected, "to_hash of $string");
+
+        ok($tm->is_equal(Time::Moment->new(%{ $tm->to_hash })),
+          "new(to_hash) round-trips $string");
+    }
+}
+
+{
+    my $tm = Time::Moment->from_epoch(0);
+    my $count = () = $tm->components;
+    is($count, 8, 'components returns eight elements');
+    is(scalar(my @list = $tm->components), 8, 'components in list assignment');
+}
+
+done_testing();
@@ -0,0 +1,125 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+
+BEGIN {
+    use_ok('Time::Moment');
+}
+
+sub tm { Time::Moment->from_string(@_) }
+
+# Quarters are added by day of the quarter, limited to the last day
+sub add_quarters {
+    my ($tm, $n) = @_;
+    my $q = 4 * $tm->year + $tm->quarter - 1 + $n;
+    my $r = $tm->with_day_of_month(1)
+               ->with_month(3 * ($q % 4) + 1)
+               ->with_year(int($q / 4));
+    my $diq = $r->at_last_day_of_quarter->day_of_quarter;
+    my $doq = $tm->day_of_quarter;
+    return $r->with_day_of_quarter($doq < $diq ? $doq : $diq);
+}
+
+{
+    my @tests = (
+        [ '2015-01-01T00Z', '2015-01-01T00Z', [  0,  0,   0 ] ],
+        [ '2008-02-29T00Z', '2015-02-28T00Z', [  6, 11,  30 ] ],
+        [ '2008-02-29T00Z', '2016-02-29T00Z', [  8,  0,   0 ] ],
+        [ '2025-10-11T00Z', '2025-12-10T00Z', [  0,  1,  29 ] ],
+        [ '2025-01-31T00Z', '2025-02-28T00Z', [  0,  0,  28 ] ],
+        [ '2025-01-31T00Z', '2025-03-01T00Z', [  0,  1,   1 ] ],
+        [ '2025-03-31T00Z', '2025-02-28T00Z', [  0, -1,   0 ] ],
+        [ '2025-03-31T00Z', '2025-02-27T00Z', [  0, -1,  -1 ] ],
+        [ '2025-03-30T00Z', '2025-01-31T00Z', [  0, -1, -28 ] ],
+        [ '2025-03-05T00Z', '2025-01-10T00Z', [  0, -1, -26 ] ],
+        [ '2025-12-10T00Z', '2025-10-11T00Z', [  0, -1, -30 ] ],
+        [ '2000-06-15T23:59Z', '2001-06-15T00:00Z', [ 1, 0, 0 ] ],
+    );
+
+    foreach my $test (@tests) {
+        my ($t1, $t2, $exp) = @$test;
+        is_deeply([tm($t1)->delta_ymd(tm($t2))], $exp, "delta_ymd($t1, $t2)");
+    }
+}
+
+{
+    my @tests = (
+        [ '2015-01-01T00Z', '2015-01-01T00Z', [  0,  0,   0 ] ],
+        [ '2014-02-15T00Z', '2015-08-20T00Z', [  1,  2,   5 ] ],
+        [ '2015-03-31T00Z', '2015-06-30T00Z', [  0,  1,   1 ] ],
+        [ '2015-03-31T00Z', '2015-06-29T00Z', [  0,  1,   0 ] ],
+        [ '2015-12-31T00Z', '2015-10-01T00Z', [  0,  0, -91 ] ],
+        [ '2015-12-31T00Z', '2015-09-29T00Z', [  0, -1,  -1 ] ],
+        [ '2015-08-20T00Z', '2014-02-15T00Z', [ -1, -2,  -5 ] ],
+    );
+
+    foreach my $test (@tests) {
+        my ($t1, $t2, $exp) = @$test;
+        is_deeply([tm($t1)->delta_yqd(tm($t2))], $exp, "delta_yqd($t1, $t2)");
+    }
+}
+
+{
+    my @tests = (
+        [ '2012-12-31T23:59:59Z', '2013-01-01T00:59:59Z',
+          [ 0, 0, 0, 1, 0, 0, 0 ] ],
+        [ '2000-01-01T12:00:00Z', '2001-03-02T11:30:15.5Z',
+          [ 1, 2, 0, 23, 30, 15, 500000000 ] ],
+        [ '2001-03-02T11:30:15.5Z', '2000-01-01T12:00:00Z',
+          [ -1, -2, 0, -23, -30, -15, -500000000 ] ],
+        [ '2015-06-01T00:00:00+02:00', '2015-06-01T00:00:00Z',
+          [ 0, 0, 0, 2, 0, 0, 0 ] ],
+        [ '2015-06-01T12:00:00Z', '2015-06-01T11:00:00.000000001Z',
+          [ 0, 0, 0, 0, -59, -59, -999999999 ] ],
+    );
+
+    foreach my $test (@tests) {
+        my ($t1, $t2, $exp) = @$test;
+        is_deeply([tm($t1)->delta_ymdhms(tm($t2))], $exp, "delta_ymdhms($t1, $t2)");
+    }
+}
+
+# Adding the components back to the start reaches the end, and the years
+# and months agree with delta_years and delta_months.
+{
+    srand(42);
+    my @bad;
+    for (1..2000) {
+        my @tm = map {
+            Time::Moment->from_epoch(int(rand(4_000_000_000)) - 1_000_000_000,
+                                     int(rand(1e9)))
+                        ->with_offset_same_instant(int(rand(1081)) - 540)
+        } 1..2;
+
+        my ($y, $m, $d) = $tm[0]->delta_ymd($tm[1]);
+        my $tm = $tm[0]->plus_months(12 * $y + $m)->plus_days($d);
+        push @bad, "delta_ymd $tm[0] $tm[1]"
+          unless $tm->rdn == $tm[1]->rdn
+             and 12 * $y + $m == $tm[0]->delta_months($tm[1])
+             and $y == $tm[0]->delta_years($tm[1])
+             and !grep { $_ * ($tm[1]->rdn <=> $tm[0]->rdn) < 0 } $y, $m, $d;
+
+        my ($q, $qd);
+        ($y, $q, $qd) = $tm[0]->delta_yqd($tm[1]);
+        $tm = add_quarters($tm[0], 4 * $y + $q)->plus_days($qd);
+        push @bad, "delta_yqd $tm[0] $tm[1]"
+          unless $tm->rdn == $tm[1]->rdn;
+
+        my @c = $tm[0]->delta_ymdhms($tm[1]);
+        $tm = $tm[0]->plus_months(12 * $c[0] + $c[1])
+                    ->plus_days($c[2])
+                    ->plus_hours($c[3])
+                    ->plus_minutes($c[4])
+                    ->plus_seconds($c[5])
+                    ->plus_nanoseconds($c[6]);
+        push @bad, "delta_ymdhms $tm[0] $tm[1]"
+          unless $tm->is_equal($tm[1])
+             and !grep { $_ * $tm[0]->compare($tm[1]) > 0 } @c;
+    }
+    ok(!@bad, 'components add back to the end moment')
+      or diag(join "\n", @bad[0 .. ($#bad < 4 ? $#bad : 4)]);
+}
+
+done_testing();
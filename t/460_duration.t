@@ -0,0 +1,132 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Duration');
+}
+
+my $Duration = 'Time::Moment::Duration';
+
+sub tm { Time::Moment->from_string(@_) }
+
+{
+    my $d = $Duration->from_seconds(90, 500_000_000);
+    isa_ok($d, $Duration);
+    is($d->to_seconds,      90,            'to_seconds');
+    is($d->nanosecond,      500_000_000,   'nanosecond');
+    is($d->to_minutes,      1,             'to_minutes');
+    is($d->to_milliseconds, 90_500,        'to_milliseconds');
+    is($d->to_microseconds, 90_500_000,    'to_microseconds');
+    is($d->to_nanoseconds,  90_500_000_000, 'to_nanoseconds');
+}
+
+{
+    my @tests = (
+        [ from_weeks        => 2,             to_days         => 14            ],
+        [ from_days         => 3,             to_hours        => 72            ],
+        [ from_hours        => 49,            to_days         => 2             ],
+        [ from_minutes      => 90,            to_hours        => 1             ],
+        [ from_milliseconds => 1_500,         to_microseconds => 1_500_000     ],
+        [ from_microseconds => -1_500,        to_nanoseconds  => -1_500_000    ],
+        [ from_nanoseconds  => 1_000_000_001, to_seconds      => 1             ],
+    );
+    foreach my $test (@tests) {
+        my ($from, $value, $to, $exp) = @$test;
+        is($Duration->$from($value)->$to, $exp, "$from($value)->$to");
+    }
+}
+
+{
+    my $d = $Duration->from_seconds(1, -1_500_000_000);
+    is($d->to_seconds, -1, 'nanoseconds are normalized (seconds)');
+    is($d->nanosecond, 500_000_000, 'nanoseconds are normalized (nanosecond)');
+    is($d->to_nanoseconds, -500_000_000, 'nanoseconds are normalized (to_nanoseconds)');
+    ok($d->is_negative, 'is_negative');
+    ok(!$d->is_zero, '!is_zero');
+    ok(!$d->is_positive, '!is_positive');
+    is($d->negated->to_nanoseconds, 500_000_000, 'negated');
+    is($d->abs->to_nanoseconds, 500_000_000, 'abs');
+    ok($Duration->from_seconds(0)->is_zero, 'is_zero');
+}
+
+{
+    my $d1 = $Duration->from_milliseconds(1_750);
+    my $d2 = $Duration->from_milliseconds(-2_500);
+
+    is($d1->plus($d2)->to_milliseconds,  -750,  'plus');
+    is($d1->minus($d2)->to_milliseconds, 4_250, 'minus');
+    is($d1->multiplied_by(3)->to_milliseconds,  5_250, 'multiplied_by positive');
+    is($d2->multiplied_by(-3)->to_milliseconds, 7_500, 'multiplied_by negative');
+    is($d1->multiplied_by(0)->to_nanoseconds, 0, 'multiplied_by zero');
+    is($Duration->from_nanoseconds(1)->multiplied_by(1_000_000_000_000)->to_seconds,
+       1_000, 'multiplied_by large factor');
+
+    is($d1->compare($d2), 1, 'compare');
+    is($d2->compare($d1), -1, 'compare');
+    ok($d1->is_equal($Duration->from_microseconds(1_750_000)), 'is_equal');
+    ok($d1 > $d2, 'overloaded >');
+    ok($d1 == $Duration->from_seconds(1, 750_000_000), 'overloaded ==');
+    is_deeply([sort { $a <=> $b } $d1, $d2], [$d2, $d1], 'overloaded <=> sort');
+    like(exception { my $x = $d1 <=> 1 },
+         qr/^A Time::Moment::Duration object can only be compared to another Time::Moment::Duration object/,
+         'compare with non duration');
+}
+
+{
+    my $tm1 = tm('2012-12-24T15:30:45.500+01:00');
+    my $tm2 = tm('2013-01-01T00:00:00Z');
+    my $d   = $tm1->duration_until($tm2);
+
+    isa_ok($d, $Duration);
+    foreach my $unit (qw(weeks days hours minutes seconds milliseconds microseconds nanoseconds)) {
+        my $to    = "to_$unit";
+        my $delta = "delta_$unit";
+        next if $unit eq 'weeks' || $unit eq 'days'; # calendar based in Time::Moment
+        is($d->$to, $tm1->$delta($tm2), "duration_until->$to == $delta");
+    }
+    ok($tm1->plus_duration($d)->is_equal($tm2), 'plus_duration');
+    ok($tm2->minus_duration($d)->is_equal($tm1), 'minus_duration');
+    is($tm1->plus_duration($d)->offset, 60, 'plus_duration keeps the offset');
+    ok($tm2->duration_until($tm1)->is_equal($d->negated), 'duration_until reversed');
+}
+
+{
+    my $max = tm('9999-12-31T23:59:59.999999999Z');
+    my $min = tm('0001-01-01T00:00:00Z');
+    my $d   = $min->duration_until($max);
+    ok($min->plus_duration($d)->is_equal($max), 'span of the whole range');
+    like(exception { $max->plus_duration($Duration->from_nanoseconds(1)) },
+         qr/^Time::Moment is out of range/, 'plus_duration out of range');
+    like(exception { $d->to_nanoseconds },
+         qr/^Nanosecond duration is too large/, 'to_nanoseconds overflow');
+    like(exception { $d->multiplied_by(2) },
+         qr/^Time::Moment::Duration is out of range/, 'multiplied_by out of range');
+    like(exception { $d->plus($d) },
+         qr/^Time::Moment::Duration is out of range/, 'plus out of range');
+    like(exception { $Duration->from_days(3652426) },
+         qr/^Parameter 'days' is out of range/, 'from_days out of range');
+    like(exception { Time::Moment->now->plus_duration(Time::Moment->now) },
+         qr/^duration is not an instance of Time::Moment::Duration/, 'plus_duration with a moment');
+}
+
+# Multiplying agrees with repeated addition for random durations and factors
+{
+    srand(7);
+    my @bad;
+    for (1..500) {
+        my $d = $Duration->from_nanoseconds(int(rand(2e12)) - 1e12);
+        my $n = int(rand(41)) - 20;
+        my $s = $Duration->from_seconds(0);
+        $s = $s->plus($n < 0 ? $d->negated : $d) for 1..abs($n);
+        push @bad, sprintf('%d * %d', $d->to_nanoseconds, $n)
+          unless $d->multiplied_by($n)->is_equal($s);
+    }
+    ok(!@bad, 'multiplied_by agrees with repeated addition') or diag("@bad[0..4]");
+}
+
+done_testing();
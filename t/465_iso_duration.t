@@ -0,0 +1,189 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Interval');
+}
+
+my $Duration = 'Time::Moment::Duration';
+
+sub tm { Time::Moment->from_string(@_) }
+
+{
+    my $tm = tm('2012-01-31T10:00:00Z');
+    my @tests = (
+        [ 'P1Y',                   '2013-01-31T10:00:00Z'           ],
+        [ 'P1M',                   '2012-02-29T10:00:00Z'           ],
+        [ 'P1W',                   '2012-02-07T10:00:00Z'           ],
+        [ 'P1D',                   '2012-02-01T10:00:00Z'           ],
+        [ 'PT1H',                  '2012-01-31T11:00:00Z'           ],
+        [ 'PT1M',                  '2012-01-31T10:01:00Z'           ],
+        [ 'PT1S',                  '2012-01-31T10:00:01Z'           ],
+        [ 'PT0.5H',                '2012-01-31T10:30:00Z'           ],
+        [ 'PT1,5M',                '2012-01-31T10:01:30Z'           ],
+        [ 'PT0.000000001S',        '2012-01-31T10:00:00.000000001Z' ],
+        [ 'PT0.1234567899S',       '2012-01-31T10:00:00.123456789Z' ],
+        [ 'P1Y2M3DT4H5M6.789S',    '2013-04-03T14:05:06.789Z'       ],
+        [ 'P1W1D',                 '2012-02-08T10:00:00Z'           ],
+        [ 'PT36H',                 '2012-02-01T22:00:00Z'           ],
+        [ '-P1M',                  '2011-12-31T10:00:00Z'           ],
+        [ '+P1D',                  '2012-02-01T10:00:00Z'           ],
+        [ '-P1DT10H0.5S',          '2012-01-29T23:59:59.500Z'       ],
+        [ 'P0D',                   '2012-01-31T10:00:00Z'           ],
+    );
+    foreach my $test (@tests) {
+        my ($duration, $exp) = @$test;
+        is($tm->plus_iso_duration($duration)->to_string, $exp,
+          "plus_iso_duration($duration)");
+        is(tm($exp)->minus_iso_duration($duration)->plus_iso_duration($duration)->to_string,
+          $exp, "minus_iso_duration($duration) then plus_iso_duration($duration)")
+          if $duration !~ /M(?!.*T)|Y/;
+    }
+}
+
+{
+    my @invalid = (
+        '', 'P', 'PT', '1D', 'P1', 'P1DT', 'PD', 'P1D1Y', 'P1M1Y', 'PT1S1M',
+        'P1H', 'PT1D', 'P1.5D', 'P0.5Y', 'PT1.5H1M', 'PT.5S', 'PT1.S',
+        'P1DT1H ', ' P1D', 'p1d', 'P--1D', 'P1234567890123456789D', 'P1Y1Y',
+    );
+    my $tm = tm('2012-01-31T10:00:00Z');
+    foreach my $string (@invalid) {
+        like(exception { $tm->plus_iso_duration($string) },
+             qr/^Could not parse the given string/, "invalid duration '$string'");
+    }
+    like(exception { $tm->plus_iso_duration('P10001Y') },
+         qr/^Parameter 'years' is out of range/, 'years out of range');
+    like(exception { $tm->plus_iso_duration('P3652426D') },
+         qr/^Parameter 'days' is out of range/, 'days out of range');
+    like(exception { $tm->plus_iso_duration('P8000Y') },
+         qr/^Time::Moment is out of range/, 'result out of range');
+}
+
+# plus_iso_duration agrees with the equivalent chain of plus_* calls
+{
+    srand(11);
+    my @bad;
+    for (1..1000) {
+        my $tm = Time::Moment->from_epoch(int(rand(2e9)), int(rand(1e9)))
+                             ->with_offset_same_instant(int(rand(241)) - 120);
+        my @c = map { int rand $_ } 20, 30, 10, 400, 100, 5000, 100000, 1e9;
+        my $neg = rand() < 0.5;
+        my $s = sprintf '%sP%dY%dM%dW%dDT%dH%dM%d.%09dS', ($neg ? '-' : ''), @c;
+        my $m = $neg ? -1 : 1;
+        my $exp = $tm->plus_years($m * $c[0])
+                     ->plus_months($m * $c[1])
+                     ->plus_weeks($m * $c[2])
+                     ->plus_days($m * $c[3])
+                     ->plus_hours($m * $c[4])
+                     ->plus_minutes($m * $c[5])
+                     ->plus_seconds($m * $c[6])
+                     ->plus_nanoseconds($m * $c[7]);
+        my $got = $tm->plus_iso_duration($s);
+        push @bad, "$tm + $s = $got, expected $exp"
+          unless $got->is_equal($exp) && $got->offset == $exp->offset;
+    }
+    ok(!@bad, 'plus_iso_duration agrees with plus_*')
+      or diag(join "\n", @bad[0 .. ($#bad < 4 ? $#bad : 4)]);
+}
+
+{
+    my @tests = (
+        [ 'PT0S',           'PT0S',                 0              ],
+        [ 'P0D',            'PT0S',                 0              ],
+        [ 'PT1.5S',         'PT1.500S',             1_500_000_000  ],
+        [ 'PT90M',          'PT1H30M',              5400e9         ],
+        [ 'P1W',            'P7D',                  604800e9       ],
+        [ 'P2DT3H4M5.000006S', 'P2DT3H4M5.000006S', 183845000006000 ],
+        [ '-PT0.000000001S', '-PT0.000000001S',     -1             ],
+        [ '-P1DT0.5S',      '-P1DT0.500S',          -86400.5e9     ],
+    );
+    foreach my $test (@tests) {
+        my ($string, $exp, $ns) = @$test;
+        my $d = $Duration->from_string($string);
+        is($d->to_nanoseconds, $ns, "$Duration->from_string($string)->to_nanoseconds");
+        is($d->to_string, $exp, "$Duration->from_string($string)->to_string");
+        is("$d", $exp, "$Duration->from_string($string) stringifies");
+        ok($Duration->from_string($d->to_string)->is_equal($d), "$string round-trips");
+    }
+    like(exception { $Duration->from_string('P1Y') },
+         qr/^Duration with years or months cannot be represented/, 'nominal years');
+    like(exception { $Duration->from_string('P1M') },
+         qr/^Duration with years or months cannot be represented/, 'nominal months');
+    like(exception { $Duration->from_string('PT1') },
+         qr/^Could not parse the given string/, 'invalid duration');
+
+    my $tm1 = tm('2012-12-24T15:30:45.5+01:00');
+    my $tm2 = tm('2013-03-01T00:00:00Z');
+    my $d   = $tm1->duration_until($tm2);
+    is($d->to_string, 'P66DT9H29M14.500S', 'duration_until to_string');
+    ok($tm1->plus_iso_duration("$d")->is_equal($tm2), 'plus_iso_duration of a duration string');
+}
+
+{
+    my @tests = (
+        [ '2007-03-01T13:00:00Z/2008-05-11T15:30:00Z',
+          '2007-03-01T13:00:00Z', '2008-05-11T15:30:00Z' ],
+        [ '2007-03-01T13:00:00Z/P1Y2M10DT2H30M',
+          '2007-03-01T13:00:00Z', '2008-05-11T15:30:00Z' ],
+        [ 'P1Y2M10DT2H30M/2008-05-11T15:30:00Z',
+          '2007-03-01T13:00:00Z', '2008-05-11T15:30:00Z' ],
+        [ '2012-01-31T00:00:00+01:00/P1M',
+          '2012-01-31T00:00:00+01:00', '2012-02-29T00:00:00+01:00' ],
+        [ '20120131T000000Z/P1D',
+          '2012-01-31T00:00:00Z', '2012-02-01T00:00:00Z' ],
+    );
+    foreach my $test (@tests) {
+        my ($string, @exp) = @$test;
+        my @got = Time::Moment->from_interval_string($string);
+        is_deeply([map { $_->to_string } @got], \@exp, "from_interval_string($string)");
+        isa_ok($_, 'Time::Moment') for @got;
+    }
+
+    my $ref = tm('2012-01-31T10:00:00Z');
+    is_deeply([map { $_->to_string } Time::Moment->from_interval_string('P1M', $ref)],
+              ['2012-01-31T10:00:00Z', '2012-02-29T10:00:00Z'],
+              'from_interval_string(P1M, reference)');
+    like(exception { Time::Moment->from_interval_string('P1M') },
+         qr/^Interval consists of only a duration/, 'duration interval without reference');
+    like(exception { Time::Moment->from_interval_string('2020-02-01T00:00:00Z/2020-01-01T00:00:00Z') },
+         qr/^Interval end precedes its start/, 'interval end before its start');
+    foreach my $test (['-P1D/2024-01-02T00:00:00Z'], ['2024-01-02T00:00:00Z/-P1D'],
+                      ['-P1D', tm('2024-01-02T00:00:00Z')]) {
+        my ($string, @reference) = @$test;
+        like(exception { Time::Moment->from_interval_string($string, @reference) },
+             qr/^Interval end precedes its start/, "negative duration in '$string'");
+        like(exception { Time::Moment::Interval->from_string($string, @reference) },
+             qr/^Interval end precedes its start/,
+             "negative duration in '$string' as a Time::Moment::Interval");
+    }
+    is_deeply([map { $_->to_string } Time::Moment->from_interval_string(
+               '2020-01-01T01:00:00+02:00/2020-01-01T00:00:00Z')],
+              ['2020-01-01T01:00:00+02:00', '2020-01-01T00:00:00Z'],
+              'interval ends are compared as instants');
+    is_deeply([map { $_->to_string } Time::Moment->from_interval_string(
+               '2020-01-01T00:00:00Z/2020-01-01T00:00:00Z')],
+              ['2020-01-01T00:00:00Z', '2020-01-01T00:00:00Z'], 'empty interval');
+
+    foreach my $string ('P1D/P1D', '/', '2012-01-31T10:00:00Z/', '/P1D',
+                        '2012-01-31T10:00:00Z/2012-01-31', '2012-01-31T10:00:00Z//P1D') {
+        like(exception { Time::Moment->from_interval_string($string) },
+             qr/^Could not parse the given string/, "invalid interval '$string'");
+    }
+
+    my $tm1 = tm('2007-03-01T13:00:00Z');
+    my $tm2 = tm('2008-05-11T15:30:00.25+02:00');
+    is($tm1->to_interval_string($tm2), '2007-03-01T13:00:00Z/2008-05-11T15:30:00.250+02:00',
+       'to_interval_string(end)');
+    is($tm1->to_interval_string($Duration->from_hours(36)), '2007-03-01T13:00:00Z/P1DT12H',
+       'to_interval_string(duration)');
+    my @rt = Time::Moment->from_interval_string($tm1->to_interval_string($tm2));
+    ok($rt[0]->is_equal($tm1) && $rt[1]->is_equal($tm2), 'to_interval_string round-trips');
+}
+
+done_testing();
@@ -0,0 +1,166 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Interval');
+    use_ok('Time::Moment::IntervalSet');
+}
+
+my $Base = Time::Moment->from_string('2012-12-24T00:00Z');
+
+sub tm { $Base->plus_minutes($_[0]) }
+sub iv { Time::Moment::Interval->new(tm($_[0]), tm($_[1])) }
+sub set { Time::Moment::IntervalSet->new(map { iv(@$_) } @_) }
+
+sub minutes {
+    my ($set) = @_;
+    return [ map { [ $Base->delta_minutes($_->start), $Base->delta_minutes($_->end) ] }
+             $set->intervals ];
+}
+
+{
+    my $iv = iv(10, 20);
+    isa_ok($iv, 'Time::Moment::Interval');
+    ok($iv->start->is_equal(tm(10)), 'start');
+    ok($iv->end->is_equal(tm(20)), 'end');
+    is($iv->duration->to_minutes, 10, 'duration');
+    ok(!$iv->is_empty, 'is_empty');
+    ok(iv(10, 10)->is_empty, 'is_empty [t, t)');
+
+    ok(!$iv->contains(tm(9)), 'contains before start');
+    ok( $iv->contains(tm(10)), 'contains start');
+    ok( $iv->contains(tm(19)), 'contains before end');
+    ok(!$iv->contains(tm(20)), 'does not contain end');
+    ok( $iv->contains(tm(15)->with_offset_same_instant(120)),
+      'contains compares instants');
+
+    ok( $iv->overlaps(iv(19, 30)), 'overlaps');
+    ok( $iv->overlaps(iv(12, 18)), 'overlaps enclosed');
+    ok(!$iv->overlaps(iv(20, 30)), 'adjacent does not overlap');
+    ok(!$iv->overlaps(iv(15, 15)), 'empty does not overlap');
+
+    my $r = $iv->intersection(iv(15, 30));
+    isa_ok($r, 'Time::Moment::Interval');
+    ok($r->is_equal(iv(15, 20)), 'intersection');
+    is($iv->intersection(iv(20, 30)), undef, 'intersection of adjacent');
+
+    is("$iv", '2012-12-24T00:10:00Z/2012-12-24T00:20:00Z', 'stringify');
+    is($iv->to_string, "$iv", 'to_string');
+
+    like(exception { iv(20, 10) }, qr/^Interval end precedes its start/,
+      'end before start');
+    like(exception { Time::Moment::Interval->new(tm(0), 'x') },
+      qr/^end is not an instance of Time::Moment/, 'end not a moment');
+}
+
+{
+    my $iv = Time::Moment::Interval->from_string('2012-12-24T00:10Z/PT10M');
+    ok($iv->is_equal(iv(10, 20)), 'from_string <start>/<duration>');
+    $iv = Time::Moment::Interval->from_string('PT10M', tm(10));
+    ok($iv->is_equal(iv(10, 20)), 'from_string <duration> with reference');
+    like(exception { Time::Moment::Interval->from_string('PT10M') },
+      qr/^Interval consists of only a duration/, 'from_string <duration>');
+    like(exception { Time::Moment::Interval->from_string('2012-12-24T00:10Z/-PT10M') },
+      qr/^Interval end precedes its start/, 'from_string negative duration');
+}
+
+{
+    my $set = set([30, 40], [0, 10], [5, 15], [15, 20], [50, 50], [60, 70]);
+    isa_ok($set, 'Time::Moment::IntervalSet');
+    is_deeply(minutes($set), [[0, 20], [30, 40], [60, 70]],
+      'new sorts and coalesces overlapping and adjacent intervals');
+    is($set->count, 3, 'count');
+    is(scalar $set->intervals, 3, 'intervals in scalar context');
+    ok(!$set->is_empty, 'is_empty');
+    ok(set()->is_empty, 'empty set');
+    ok(set([5, 5])->is_empty, 'set of empty intervals');
+
+    my %contains = (-1 => 0, 0 => 1, 19 => 1, 20 => 0, 29 => 0, 30 => 1,
+                    45 => 0, 69 => 1, 70 => 0, 100 => 0);
+    foreach my $m (sort { $a <=> $b } keys %contains) {
+        is(!!$set->contains(tm($m)), !!$contains{$m}, "contains minute $m");
+    }
+    ok($set->find(tm(35))->is_equal(iv(30, 40)), 'find');
+    is($set->find(tm(25)), undef, 'find in gap');
+
+    ok( $set->overlaps(iv(19, 21)), 'overlaps');
+    ok( $set->overlaps(iv(25, 65)), 'overlaps spanning');
+    ok(!$set->overlaps(iv(20, 30)), 'gap does not overlap');
+    ok(!$set->overlaps(iv(70, 80)), 'after does not overlap');
+    ok(!$set->overlaps(iv(35, 35)), 'empty does not overlap');
+
+    is_deeply(minutes($set->union(iv(20, 30))), [[0, 40], [60, 70]],
+      'union with an interval');
+    is_deeply(minutes($set->intersection(set([5, 35], [65, 90]))),
+      [[5, 20], [30, 35], [65, 70]], 'intersection');
+    is_deeply(minutes($set->difference(set([5, 10], [15, 65]))),
+      [[0, 5], [10, 15], [65, 70]], 'difference');
+    is_deeply(minutes($set->difference(set())), minutes($set),
+      'difference with empty set');
+
+    like(exception { $set->union(tm(0)) },
+      qr/^other is not an instance of Time::Moment::IntervalSet or Time::Moment::Interval/,
+      'union with a moment');
+    like(exception { Time::Moment::IntervalSet::contains(iv(0, 1), tm(0)) },
+      qr/^self is not an instance of Time::Moment::IntervalSet/,
+      'interval is not a set');
+}
+
+# Compares the set operations with the same operations on a minute grid
+{
+    my $N = 120;
+
+    sub random_set {
+        my @iv;
+        for (1..int(rand(8))) {
+            my $s = int(rand($N));
+            push @iv, [$s, $s + int(rand(20))];
+        }
+        return @iv;
+    }
+
+    sub grid {
+        my %g;
+        foreach my $iv (@_) {
+            $g{$_} = 1 for $iv->[0] .. $iv->[1] - 1;
+        }
+        return \%g;
+    }
+
+    sub grid_intervals {
+        my ($g) = @_;
+        my @r;
+        foreach my $m (sort { $a <=> $b } keys %$g) {
+            if (@r && $r[-1][1] == $m) { $r[-1][1]++ }
+            else                       { push @r, [$m, $m + 1] }
+        }
+        return \@r;
+    }
+
+    srand(20121224);
+    for my $i (1..200) {
+        my @a = random_set();
+        my @b = random_set();
+        my ($ga, $gb) = (grid(@a), grid(@b));
+        my ($sa, $sb) = (set(@a), set(@b));
+
+        is_deeply(minutes($sa), grid_intervals($ga), "#$i canonical form");
+        is_deeply(minutes($sa->union($sb)),
+          grid_intervals({ %$ga, %$gb }), "#$i union");
+        is_deeply(minutes($sa->intersection($sb)),
+          grid_intervals({ map { $_ => 1 } grep { $gb->{$_} } keys %$ga }), "#$i intersection");
+        is_deeply(minutes($sa->difference($sb)),
+          grid_intervals({ map { $_ => 1 } grep { !$gb->{$_} } keys %$ga }), "#$i difference");
+
+        my @probe = map { int(rand($N + 20)) - 10 } 1..5;
+        is_deeply([ map { $sa->contains(tm($_)) ? 1 : 0 } @probe ],
+                  [ map { $ga->{$_} ? 1 : 0 } @probe ], "#$i contains");
+    }
+}
+
+done_testing();
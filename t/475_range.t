@@ -0,0 +1,166 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Range');
+}
+
+sub tm { Time::Moment->from_string(@_) }
+
+sub strings {
+    my ($range) = @_;
+    my @r;
+    while (my $tm = $range->next) {
+        push @r, $tm->to_string;
+    }
+    return \@r;
+}
+
+{
+    my $range = Time::Moment->range(tm('2012-12-24T00:00Z'), tm('2012-12-27T00:00Z'), 'days');
+    isa_ok($range, 'Time::Moment::Range');
+    is_deeply(strings($range), [qw(
+        2012-12-24T00:00:00Z
+        2012-12-25T00:00:00Z
+        2012-12-26T00:00:00Z
+    )], 'days, end is exclusive');
+    is($range->next, undef, 'exhausted');
+    is_deeply(strings($range->reset), [qw(
+        2012-12-24T00:00:00Z
+        2012-12-25T00:00:00Z
+        2012-12-26T00:00:00Z
+    )], 'reset');
+}
+
+{
+    my $range = Time::Moment->range(tm('2012-12-24T10:00+01:00'),
+      tm('2012-12-24T10:00Z'), 'minutes', 15);
+    is_deeply(strings($range), [qw(
+        2012-12-24T10:00:00+01:00
+        2012-12-24T10:15:00+01:00
+        2012-12-24T10:30:00+01:00
+        2012-12-24T10:45:00+01:00
+    )], '15 minute slots, end compared as an instant');
+}
+
+{
+    my $range = Time::Moment->range(tm('2012-01-31T12:00Z'), tm('2012-06-01T00:00Z'), 'months');
+    is_deeply(strings($range), [qw(
+        2012-01-31T12:00:00Z
+        2012-02-29T12:00:00Z
+        2012-03-31T12:00:00Z
+        2012-04-30T12:00:00Z
+        2012-05-31T12:00:00Z
+    )], 'months are clamped to the end of the month from the start');
+
+    my @expected = map { tm('2012-01-31T12:00Z')->plus_months($_)->to_string } 0..4;
+    is_deeply(strings($range->reset), \@expected, 'months agree with plus_months');
+
+    $range = Time::Moment->range(tm('2012-02-29T00:00Z'), tm('2021-01-01T00:00Z'), 'years', 4);
+    is_deeply(strings($range), [qw(
+        2012-02-29T00:00:00Z
+        2016-02-29T00:00:00Z
+        2020-02-29T00:00:00Z
+    )], 'years');
+}
+
+{
+    my $range = Time::Moment->range(tm('2012-12-24T00:00:01Z'),
+      tm('2012-12-24T00:00:00Z'), 'milliseconds', -250);
+    is_deeply(strings($range), [qw(
+        2012-12-24T00:00:01Z
+        2012-12-24T00:00:00.750Z
+        2012-12-24T00:00:00.500Z
+        2012-12-24T00:00:00.250Z
+    )], 'negative step');
+
+    $range = Time::Moment->range(tm('2012-12-24T00:00Z'), tm('2012-12-23T00:00Z'), 'days');
+    is($range->next, undef, 'end before start with positive step is empty');
+    $range = Time::Moment->range(tm('2012-12-24T00:00Z'), tm('2012-12-24T00:00Z'), 'days');
+    is($range->next, undef, 'end equal to start is empty');
+}
+
+{
+    my $range = Time::Moment->range(tm('9999-12-29T00:00Z'), tm('9999-12-31T23:59:59.999999999Z'), 'days');
+    is_deeply(strings($range), [qw(
+        9999-12-29T00:00:00Z
+        9999-12-30T00:00:00Z
+        9999-12-31T00:00:00Z
+    )], 'ends at the end of the supported range');
+
+    $range = Time::Moment->range(tm('0001-01-01T00:00Z'), tm('9999-12-31T00:00Z'), 'years', 5000);
+    is_deeply(strings($range), [qw(
+        0001-01-01T00:00:00Z
+        5001-01-01T00:00:00Z
+    )], 'stops when a step leaves the supported range');
+
+    $range = Time::Moment->range(tm('0001-01-01T00:00Z'), tm('9999-12-31T00:00Z'),
+      'nanoseconds', '9000000000000000000');
+    is(scalar @{ strings($range) }, 36, 'nanosecond steps across the whole range');
+}
+
+{
+    my $range = Time::Moment->range(tm('2012-12-24T00:00Z'), tm('2012-12-24T03:00Z'), 'hours');
+    my $tm;
+    my @seen;
+    ok($range->next($tm), 'next($tm) returns true');
+    isa_ok($tm, 'Time::Moment');
+    push @seen, $tm->to_string;
+    while ($range->next($tm)) {
+        push @seen, $tm->to_string;
+    }
+    is_deeply(\@seen, [qw(
+        2012-12-24T00:00:00Z
+        2012-12-24T01:00:00Z
+        2012-12-24T02:00:00Z
+    )], 'next($tm)');
+    is($tm->to_string, '2012-12-24T02:00:00Z', 'target is left at the last moment');
+    ok(!$range->next($tm), 'next($tm) returns false when exhausted');
+
+    $range->reset;
+    $range->next($tm);
+    my $copy = $tm;
+    $range->next($tm);
+    is($copy->to_string, '2012-12-24T00:00:00Z', 'shared moments are not modified');
+    is($tm->to_string, '2012-12-24T01:00:00Z', 'shared target is replaced');
+}
+
+{
+    my $range = Time::Moment->range(tm('2012-01-31T12:00+01:00'), tm('2012-06-01T00:00Z'), 'months');
+    $range->next;
+    my $packed = $range->to_packed;
+    is(length $packed, 5 * 16, 'to_packed contains the whole range');
+
+    my @moments = @{ strings($range->reset) };
+    my $i = 0;
+    foreach my $string (@moments) {
+        my $tm = tm($string);
+        my ($sec, $nsec, $offset) = unpack 'q l l', substr($packed, 16 * $i++, 16);
+        is_deeply([$sec, $nsec, $offset],
+          [$tm->rdn * 86400 + $tm->hour * 3600 + $tm->minute * 60 + $tm->second,
+           $tm->nanosecond, $tm->offset], "packed moment $string");
+    }
+    is(Time::Moment->range(tm('2012-01-01T00:00Z'), tm('2012-01-01T00:00Z'), 'days')->to_packed,
+      '', 'to_packed of an empty range');
+}
+
+{
+    my ($s, $e) = (tm('2012-12-24T00:00Z'), tm('2012-12-25T00:00Z'));
+    like(exception { Time::Moment->range($s, $e, 'fortnights') },
+      qr/^Unrecognised unit: 'fortnights'/, 'unknown unit');
+    like(exception { Time::Moment->range($s, $e, 'days', 0) },
+      qr/^Parameter 'step' is out of range/, 'zero step');
+    like(exception { Time::Moment->range($s, $e, 'days', 10_000_000) },
+      qr/^Parameter 'days' is out of range/, 'step out of range');
+    like(exception { Time::Moment->range($s, $e, 'months', 10_000_000) },
+      qr/^Parameter 'months' is out of range/, 'calendar step out of range');
+    like(exception { Time::Moment->range($s, 'x', 'days') },
+      qr/^end is not an instance of Time::Moment/, 'end not a moment');
+}
+
+done_testing();
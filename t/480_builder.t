@@ -0,0 +1,103 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Builder');
+}
+
+my $tm = Time::Moment->from_string('2012-12-24T15:30:45.123456789+01:00');
+
+{
+    my $b = Time::Moment::Builder->new($tm);
+    isa_ok($b, 'Time::Moment::Builder');
+    my $frozen = $b->freeze;
+    isa_ok($frozen, 'Time::Moment');
+    ok($frozen->is_equal($tm), 'freeze');
+    is($frozen->to_string, $tm->to_string, 'freeze keeps the offset');
+
+    is($b->add_days(1), $b, 'add_* returns the builder');
+    is($frozen->to_string, $tm->to_string, 'frozen moment is not modified');
+    is($b->freeze->to_string, '2012-12-25T15:30:45.123456789+01:00', 'add_days');
+
+    $b->add_hours(1)->add_minutes(-30)->set_second(0)->at_utc;
+    is($b->freeze->to_string, '2012-12-25T15:00:00.123456789Z', 'chained');
+}
+
+{
+    my @units = qw(years months weeks days hours minutes seconds
+                   milliseconds microseconds nanoseconds);
+    foreach my $unit (@units) {
+        foreach my $value (-3, 0, 7) {
+            my $b = Time::Moment::Builder->new($tm);
+            my $add  = "add_$unit";
+            my $plus = "plus_$unit";
+            $b->$add($value);
+            is($b->freeze->to_string, $tm->$plus($value)->to_string, "$add($value)");
+        }
+    }
+
+    my %fields = (
+        year => 2000, quarter => 3, month => 2, week => 10, day_of_year => 60,
+        day_of_quarter => 45, day_of_month => 29, day_of_week => 7, hour => 23,
+        minute => 59, minute_of_day => 600, second => 30, second_of_day => 3600,
+        millisecond => 500, millisecond_of_day => 1000, microsecond => 500000,
+        microsecond_of_day => 1000000, nanosecond => 1, nanosecond_of_day => 1,
+        precision => 0, rdn => 730000,
+    );
+    foreach my $field (sort keys %fields) {
+        my $b = Time::Moment::Builder->new($tm);
+        my $set  = "set_$field";
+        my $with = "with_$field";
+        $b->$set($fields{$field});
+        is($b->freeze->to_string, $tm->$with($fields{$field})->to_string,
+          "$set($fields{$field})");
+    }
+
+    foreach my $method (qw(offset_same_instant offset_same_local)) {
+        my $b = Time::Moment::Builder->new($tm);
+        my $set  = "set_$method";
+        my $with = "with_$method";
+        $b->$set(-330);
+        is($b->freeze->to_string, $tm->$with(-330)->to_string, "$set(-330)");
+    }
+
+    foreach my $at (qw(at_utc at_midnight at_noon at_last_day_of_year
+                       at_last_day_of_quarter at_last_day_of_month)) {
+        my $b = Time::Moment::Builder->new($tm);
+        $b->$at;
+        is($b->freeze->to_string, $tm->$at->to_string, $at);
+    }
+}
+
+{
+    my $b = Time::Moment::Builder->new(Time::Moment->from_string('2012-01-31T00:00Z'));
+    my $step = Time::Moment->from_string('2012-01-31T00:00Z');
+    for (1..3) {
+        $b->add_months(1);
+        $step = $step->plus_months(1);
+    }
+    is($b->freeze->to_string, $step->to_string, 'repeated add_months clamps like plus_months');
+}
+
+{
+    my $b = Time::Moment::Builder->new($tm);
+    like(exception { $b->add_years(10_000) }, qr/^Time::Moment is out of range/,
+      'add_* out of range');
+    like(exception { $b->set_month(13) }, qr/^Parameter 'month' is out of the range/,
+      'set_* out of range');
+    is($b->freeze->to_string, $tm->to_string, 'builder is unchanged after an error');
+
+    like(exception { Time::Moment::Builder->new('x') },
+      qr/^moment is not an instance of Time::Moment/, 'new with a non-moment');
+    like(exception { Time::Moment::Builder::add_days($tm, 1) },
+      qr/^self is not an instance of Time::Moment::Builder/, 'moment is not a builder');
+    like(exception { $tm->plus_days(1)->is_equal($b) },
+      qr/^other is not an instance of Time::Moment/, 'builder is not a moment');
+}
+
+done_testing();
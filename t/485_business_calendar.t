@@ -0,0 +1,257 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::BusinessCalendar');
+}
+
+sub tm { Time::Moment->from_string(@_) }
+
+# Returns the weekdays in [from, to) that are not business days
+sub closed_weekdays {
+    my ($calendar, $from, $to) = @_;
+    my @r;
+    for (my $tm = tm("${from}T00Z"); $tm->is_before(tm("${to}T00Z")); $tm = $tm->plus_days(1)) {
+        next if $tm->day_of_week > 5;
+        push @r, $tm->strftime('%Y-%m-%d') unless $calendar->is_business_day($tm);
+    }
+    return \@r;
+}
+
+# Federal law 5 USC 6103, as in eg/us_federal_holidays.pl
+{
+    my $calendar = Time::Moment::BusinessCalendar->new(
+        from     => 1990,
+        to       => 2030,
+        holidays => [
+            { month =>  1, day => 1, observed => 'nearest' },
+            { month =>  1, day_of_week => 1, ordinal => 3 },
+            { month =>  2, day_of_week => 1, ordinal => 3 },
+            { month =>  5, day_of_week => 1, ordinal => -1 },
+            { month =>  7, day => 4, observed => 'nearest' },
+            { month =>  9, day_of_week => 1, ordinal => 1 },
+            { month => 10, day_of_week => 1, ordinal => 2 },
+            { month => 11, day => 11, observed => 'nearest' },
+            { month => 11, day_of_week => 4, ordinal => 4 },
+            { month => 12, day => 25, observed => 'nearest' },
+        ],
+    );
+    isa_ok($calendar, 'Time::Moment::BusinessCalendar');
+    my @expected = qw(
+    1997-01-01 1997-01-20 1997-02-17 1997-05-26 1997-07-04 1997-09-01
+    1997-10-13 1997-11-11 1997-11-27 1997-12-25 1998-01-01 1998-01-19
+    1998-02-16 1998-05-25 1998-07-03 1998-09-07 1998-10-12 1998-11-11
+    1998-11-26 1998-12-25 1999-01-01 1999-01-18 1999-02-15 1999-05-31
+    1999-07-05 1999-09-06 1999-10-11 1999-11-11 1999-11-25 1999-12-24
+    1999-12-31 2000-01-17 2000-02-21 2000-05-29 2000-07-04 2000-09-04
+    2000-10-09 2000-11-10 2000-11-23 2000-12-25 2001-01-01 2001-01-15
+    2001-02-19 2001-05-28 2001-07-04 2001-09-03 2001-10-08 2001-11-12
+    2001-11-22 2001-12-25 2002-01-01 2002-01-21 2002-02-18 2002-05-27
+    2002-07-04 2002-09-02 2002-10-14 2002-11-11 2002-11-28 2002-12-25
+    2003-01-01 2003-01-20 2003-02-17 2003-05-26 2003-07-04 2003-09-01
+    2003-10-13 2003-11-11 2003-11-27 2003-12-25 2004-01-01 2004-01-19
+    2004-02-16 2004-05-31 2004-07-05 2004-09-06 2004-10-11 2004-11-11
+    2004-11-25 2004-12-24 2004-12-31 2005-01-17 2005-02-21 2005-05-30
+    2005-07-04 2005-09-05 2005-10-10 2005-11-11 2005-11-24 2005-12-26
+    2006-01-02 2006-01-16 2006-02-20 2006-05-29 2006-07-04 2006-09-04
+    2006-10-09 2006-11-10 2006-11-23 2006-12-25 2007-01-01 2007-01-15
+    2007-02-19 2007-05-28 2007-07-04 2007-09-03 2007-10-08 2007-11-12
+    2007-11-22 2007-12-25 2008-01-01 2008-01-21 2008-02-18 2008-05-26
+    2008-07-04 2008-09-01 2008-10-13 2008-11-11 2008-11-27 2008-12-25
+    2009-01-01 2009-01-19 2009-02-16 2009-05-25 2009-07-03 2009-09-07
+    2009-10-12 2009-11-11 2009-11-26 2009-12-25 2010-01-01 2010-01-18
+    2010-02-15 2010-05-31 2010-07-05 2010-09-06 2010-10-11 2010-11-11
+    2010-11-25 2010-12-24 2010-12-31 2011-01-17 2011-02-21 2011-05-30
+    2011-07-04 2011-09-05 2011-10-10 2011-11-11 2011-11-24 2011-12-26
+    2012-01-02 2012-01-16 2012-02-20 2012-05-28 2012-07-04 2012-09-03
+    2012-10-08 2012-11-12 2012-11-22 2012-12-25 2013-01-01 2013-01-21
+    2013-02-18 2013-05-27 2013-07-04 2013-09-02 2013-10-14 2013-11-11
+    2013-11-28 2013-12-25 2014-01-01 2014-01-20 2014-02-17 2014-05-26
+    2014-07-04 2014-09-01 2014-10-13 2014-11-11 2014-11-27 2014-12-25
+    2015-01-01 2015-01-19 2015-02-16 2015-05-25 2015-07-03 2015-09-07
+    2015-10-12 2015-11-11 2015-11-26 2015-12-25 2016-01-01 2016-01-18
+    2016-02-15 2016-05-30 2016-07-04 2016-09-05 2016-10-10 2016-11-11
+    2016-11-24 2016-12-26 2017-01-02 2017-01-16 2017-02-20 2017-05-29
+    2017-07-04 2017-09-04 2017-10-09 2017-11-10 2017-11-23 2017-12-25
+    2018-01-01 2018-01-15 2018-02-19 2018-05-28 2018-07-04 2018-09-03
+    2018-10-08 2018-11-12 2018-11-22 2018-12-25 2019-01-01 2019-01-21
+    2019-02-18 2019-05-27 2019-07-04 2019-09-02 2019-10-14 2019-11-11
+    2019-11-28 2019-12-25 2020-01-01 2020-01-20 2020-02-17 2020-05-25
+    2020-07-03 2020-09-07 2020-10-12 2020-11-11 2020-11-26 2020-12-25
+    );
+    is_deeply(closed_weekdays($calendar, '1997-01-01', '2021-01-01'), \@expected,
+      'U.S. federal holidays 1997-2020');
+}
+
+# Swedish bank holidays, as in eg/se_bank_holidays.pl
+{
+    my $calendar = Time::Moment::BusinessCalendar->new(
+        from     => 1990,
+        to       => 2030,
+        weekend  => [6, 7],
+        holidays => [
+            { month =>  1, day =>  1 },
+            { month =>  1, day =>  6 },
+            { easter => -2 },
+            { easter =>  1 },
+            { easter => 39 },
+            { easter => 50, to => 2004 },
+            { month =>  5, day =>  1 },
+            { month =>  6, day =>  6, from => 2005 },
+            { month =>  6, day => 19, day_of_week => 5, ordinal => 1 },
+            { month => 12, day => 24 },
+            { month => 12, day => 25 },
+            { month => 12, day => 26 },
+            { month => 12, day => 31 },
+        ],
+    );
+    my @expected = qw(
+    2000-01-06 2000-04-21 2000-04-24 2000-05-01 2000-06-01 2000-06-12
+    2000-06-23 2000-12-25 2000-12-26 2001-01-01 2001-04-13 2001-04-16
+    2001-05-01 2001-05-24 2001-06-04 2001-06-22 2001-12-24 2001-12-25
+    2001-12-26 2001-12-31 2002-01-01 2002-03-29 2002-04-01 2002-05-01
+    2002-05-09 2002-05-20 2002-06-21 2002-12-24 2002-12-25 2002-12-26
+    2002-12-31 2003-01-01 2003-01-06 2003-04-18 2003-04-21 2003-05-01
+    2003-05-29 2003-06-09 2003-06-20 2003-12-24 2003-12-25 2003-12-26
+    2003-12-31 2004-01-01 2004-01-06 2004-04-09 2004-04-12 2004-05-20
+    2004-05-31 2004-06-25 2004-12-24 2004-12-31 2005-01-06 2005-03-25
+    2005-03-28 2005-05-05 2005-06-06 2005-06-24 2005-12-26 2006-01-06
+    2006-04-14 2006-04-17 2006-05-01 2006-05-25 2006-06-06 2006-06-23
+    2006-12-25 2006-12-26 2007-01-01 2007-04-06 2007-04-09 2007-05-01
+    2007-05-17 2007-06-06 2007-06-22 2007-12-24 2007-12-25 2007-12-26
+    2007-12-31 2008-01-01 2008-03-21 2008-03-24 2008-05-01 2008-06-06
+    2008-06-20 2008-12-24 2008-12-25 2008-12-26 2008-12-31 2009-01-01
+    2009-01-06 2009-04-10 2009-04-13 2009-05-01 2009-05-21 2009-06-19
+    2009-12-24 2009-12-25 2009-12-31 2010-01-01 2010-01-06 2010-04-02
+    2010-04-05 2010-05-13 2010-06-25 2010-12-24 2010-12-31 2011-01-06
+    2011-04-22 2011-04-25 2011-06-02 2011-06-06 2011-06-24 2011-12-26
+    2012-01-06 2012-04-06 2012-04-09 2012-05-01 2012-05-17 2012-06-06
+    2012-06-22 2012-12-24 2012-12-25 2012-12-26 2012-12-31 2013-01-01
+    2013-03-29 2013-04-01 2013-05-01 2013-05-09 2013-06-06 2013-06-21
+    2013-12-24 2013-12-25 2013-12-26 2013-12-31 2014-01-01 2014-01-06
+    2014-04-18 2014-04-21 2014-05-01 2014-05-29 2014-06-06 2014-06-20
+    2014-12-24 2014-12-25 2014-12-26 2014-12-31 2015-01-01 2015-01-06
+    2015-04-03 2015-04-06 2015-05-01 2015-05-14 2015-06-19 2015-12-24
+    2015-12-25 2015-12-31 2016-01-01 2016-01-06 2016-03-25 2016-03-28
+    2016-05-05 2016-06-06 2016-06-24 2016-12-26 2017-01-06 2017-04-14
+    2017-04-17 2017-05-01 2017-05-25 2017-06-06 2017-06-23 2017-12-25
+    2017-12-26 2018-01-01 2018-03-30 2018-04-02 2018-05-01 2018-05-10
+    2018-06-06 2018-06-22 2018-12-24 2018-12-25 2018-12-26 2018-12-31
+    2019-01-01 2019-04-19 2019-04-22 2019-05-01 2019-05-30 2019-06-06
+    2019-06-21 2019-12-24 2019-12-25 2019-12-26 2019-12-31 2020-01-01
+    2020-01-06 2020-04-10 2020-04-13 2020-05-01 2020-05-21 2020-06-19
+    2020-12-24 2020-12-25 2020-12-31
+    );
+    is_deeply(closed_weekdays($calendar, '2000-01-01', '2021-01-01'), \@expected,
+      'Swedish bank holidays 2000-2020');
+}
+
+{
+    my $calendar = Time::Moment::BusinessCalendar->new(
+        from     => 2012,
+        to       => 2013,
+        weekend  => [5, 6],
+        holidays => [
+            { month => 12, day => 25, observed => 'next' },
+            { easter => 1, computus => 'orthodox' },
+            { month => 1, day => 31, day_of_week => 7, ordinal => -1 },
+            tm('2013-03-04T00:00Z'),
+        ],
+    );
+    ok(!$calendar->is_business_day(tm('2012-12-25T00:00Z')), 'fixed date');
+    ok(!$calendar->is_business_day(tm('2013-05-06T00:00Z')), 'orthodox easter');
+    ok(!$calendar->is_business_day(tm('2013-01-27T00:00Z')), 'last sunday on or before a date');
+    ok(!$calendar->is_business_day(tm('2013-03-04T00:00Z')), 'ad hoc date');
+    ok(!$calendar->is_business_day(tm('2013-03-08T00:00Z')), 'friday is a weekend day');
+    ok($calendar->is_business_day(tm('2013-03-10T00:00Z')), 'sunday is a business day');
+    ok($calendar->is_business_day(tm('2013-03-10T23:59:59+14:00')), 'local date is used');
+}
+
+# plus and delta against stepping one day at a time
+{
+    my $calendar = Time::Moment::BusinessCalendar->new(
+        from     => 2012,
+        to       => 2014,
+        holidays => [
+            { month => 12, day => 25 },
+            { month =>  6, day => 15, observed => 'previous' },
+            { month =>  7, day =>  4 },
+            { easter => 1 },
+            { month =>  2, day => 29 },
+        ],
+    );
+    my $start = tm('2013-06-15T10:30:00.5+02:00');
+    foreach my $n (-300, -64, -63, -1, 0, 1, 2, 63, 64, 65, 300) {
+        my ($tm, $k) = ($start, 0);
+        my $step = $n < 0 ? -1 : 1;
+        while ($k != $n) {
+            $tm = $tm->plus_days($step);
+            $k += $step if $calendar->is_business_day($tm);
+        }
+        my $got = $calendar->plus_business_days($start, $n);
+        is($got->to_string, $tm->to_string, "plus_business_days($n)");
+        is($calendar->minus_business_days($start, -$n)->to_string, $tm->to_string,
+          "minus_business_days(@{[ -$n ]})");
+    }
+
+    my $d1 = tm('2012-01-01T00:00Z');
+    foreach my $days (0, 1, 6, 7, 63, 64, 65, 200, 1095) {
+        my $d2 = $d1->plus_days($days);
+        my $n = 0;
+        for (my $tm = $d1; $tm->is_before($d2); $tm = $tm->plus_days(1)) {
+            $n++ if $calendar->is_business_day($tm);
+        }
+        is($calendar->delta_business_days($d1, $d2), $n, "delta_business_days over $days days");
+        is($calendar->delta_business_days($d2, $d1), -$n, "negated delta over $days days");
+    }
+    ok(!$calendar->is_business_day(tm('2012-02-29T00:00Z')), 'february 29 in a leap year');
+    ok(!$calendar->is_business_day(tm('2013-06-14T00:00Z')), 'observed on the previous day');
+    ok($calendar->is_business_day(tm('2014-12-31T00:00Z')), 'last day of the calendar');
+}
+
+{
+    my $calendar = Time::Moment::BusinessCalendar->new(from => 2012, to => 2012);
+    like(exception { $calendar->is_business_day(tm('2013-01-01T00:00Z')) },
+      qr/^Date is outside the range of the business calendar/, 'is_business_day out of range');
+    like(exception { $calendar->plus_business_days(tm('2012-12-31T00:00Z'), 1) },
+      qr/^Date is outside the range of the business calendar/, 'plus_business_days out of range');
+    like(exception { $calendar->plus_business_days(tm('2012-01-02T00:00Z'), -1) },
+      qr/^Date is outside the range of the business calendar/, 'minus past the first day');
+    is($calendar->plus_business_days(tm('2012-01-02T00:00Z'), 260)->strftime('%F'),
+      '2012-12-31', 'last business day');
+    for my $n ('9223372036854775807', '-9223372036854775808') {
+        like(exception { $calendar->plus_business_days(tm('2012-06-01T00:00Z'), $n) },
+          qr/^Date is outside the range of the business calendar/, "plus_business_days($n)");
+        like(exception { $calendar->minus_business_days(tm('2012-06-01T00:00Z'), $n) },
+          qr/^Date is outside the range of the business calendar/, "minus_business_days($n)");
+    }
+
+    my $C = 'Time::Moment::BusinessCalendar';
+    like(exception { $C->new(from => 2013, to => 2012) },
+      qr/^Parameter 'to' precedes parameter 'from'/, 'to before from');
+    like(exception { $C->new(from => 0) },
+      qr/^Parameter 'year' is out of the range/, 'year out of range');
+    like(exception { $C->new(weekend => [0]) },
+      qr/^Parameter 'day_of_week' is out of the range/, 'weekend day out of range');
+    like(exception { $C->new(holidays => [{ month => 13, day => 1 }]) },
+      qr/^Parameter 'month' is out of the range/, 'holiday month out of range');
+    like(exception { $C->new(holidays => [{ month => 1, day_of_week => 1, ordinal => 5 }]) },
+      qr/^Parameter 'ordinal' is out of the range/, 'ordinal out of range');
+    like(exception { $C->new(holidays => [{ month => 1 }]) },
+      qr/^Holiday must have a month and a day/, 'holiday without a day');
+    like(exception { $C->new(holidays => [{ easter => 1, observed => 'later' }]) },
+      qr/^Parameter 'observed' must be one of/, 'unknown observance');
+    like(exception { $C->new(holidays => [{ month => 1, day => 1, date => 1 }]) },
+      qr/^Unrecognised parameter: 'date'/, 'unknown holiday parameter');
+    like(exception { $C->new(holidays => ['x']) },
+      qr/^holiday is not a HASH reference or an instance of Time::Moment/, 'holiday not a hash');
+    like(exception { Time::Moment::BusinessCalendar::is_business_day(tm('2012-01-01T00:00Z'), tm('2012-01-01T00:00Z')) },
+      qr/^self is not an instance of Time::Moment::BusinessCalendar/, 'self not a calendar');
+}
+
+done_testing();
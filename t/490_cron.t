@@ -0,0 +1,120 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Cron');
+}
+
+sub tm { Time::Moment->from_string(@_) }
+
+sub next_after {
+    my ($expression, $string) = @_;
+    my $tm = Time::Moment::Cron->new($expression)->next_after(tm($string));
+    return defined $tm ? $tm->to_string : undef;
+}
+
+sub prev_before {
+    my ($expression, $string) = @_;
+    my $tm = Time::Moment::Cron->new($expression)->prev_before(tm($string));
+    return defined $tm ? $tm->to_string : undef;
+}
+
+{
+    my $cron = Time::Moment::Cron->new('*/15 9-17 * * 1-5');
+    isa_ok($cron, 'Time::Moment::Cron');
+    is($cron->next_after(tm('2012-12-24T17:50+01:00'))->to_string,
+      '2012-12-25T09:00:00+01:00', 'next_after jumps to the next day');
+    is($cron->next_after(tm('2012-12-28T17:45+01:00'))->to_string,
+      '2012-12-31T09:00:00+01:00', 'next_after skips the weekend');
+    is($cron->prev_before(tm('2012-12-24T09:00+01:00'))->to_string,
+      '2012-12-21T17:45:00+01:00', 'prev_before skips the weekend');
+    ok($cron->matches(tm('2012-12-24T09:15:59+01:00')), 'matches');
+    ok(!$cron->matches(tm('2012-12-24T09:16+01:00')), 'does not match the minute');
+    ok(!$cron->matches(tm('2012-12-23T09:15+01:00')), 'does not match the day');
+}
+
+{
+    is(next_after('* * * * *', '2012-12-24T10:00:30Z'), '2012-12-24T10:01:00Z', 'next within the minute');
+    is(next_after('* * * * *', '2012-12-24T10:00:00Z'), '2012-12-24T10:01:00Z', 'next is strictly after');
+    is(prev_before('* * * * *', '2012-12-24T10:00:30Z'), '2012-12-24T10:00:00Z', 'prev within the minute');
+    is(prev_before('* * * * *', '2012-12-24T10:00:00.000000001Z'), '2012-12-24T10:00:00Z', 'prev with nanoseconds');
+    is(prev_before('* * * * *', '2012-12-24T10:00:00Z'), '2012-12-24T09:59:00Z', 'prev is strictly before');
+    is(next_after('59 23 31 12 *', '2012-12-31T23:59Z'), '2013-12-31T23:59:00Z', 'next year');
+    is(prev_before('0 0 1 1 *', '2013-01-01T00:00Z'), '2012-01-01T00:00:00Z', 'previous year');
+    is(next_after('0 0 29 2 *', '2013-01-01T00:00Z'), '2016-02-29T00:00:00Z', 'february 29');
+    is(prev_before('0 0 29 2 *', '2016-02-29T00:00Z'), '2012-02-29T00:00:00Z', 'previous february 29');
+    is(next_after('0 0 31 * *', '2013-01-31T00:00Z'), '2013-03-31T00:00:00Z', 'skips short months');
+    is(next_after('30 4 1,15 JAN-mar *', '2013-03-15T04:30+02:00'), '2014-01-01T04:30:00+02:00', 'month names');
+    is(next_after('0 12 13 * *', '2012-12-24T00:00Z'), '2013-01-13T12:00:00Z', 'day of month');
+    is(next_after('0 12 * * fri', '2012-12-24T00:00Z'), '2012-12-28T12:00:00Z', 'day of week');
+    is(next_after('0 12 13 * 5', '2012-12-24T00:00Z'), '2012-12-28T12:00:00Z', 'day of month or day of week');
+    is(next_after('0 12 13 * 5', '2012-12-28T12:00Z'), '2013-01-04T12:00:00Z', 'day of month or day of week');
+    is(next_after('0 12 */13 * 5', '2012-12-24T00:00Z'), '2013-02-01T12:00:00Z', '*/n day of month requires both');
+    is(next_after('0 0 * * 7', '2012-12-24T00:00Z'), '2012-12-30T00:00:00Z', 'sunday as 7');
+    is(next_after('0 0 * * 0', '2012-12-24T00:00Z'), '2012-12-30T00:00:00Z', 'sunday as 0');
+    is(next_after('5/20 * * * *', '2012-12-24T00:50Z'), '2012-12-24T01:05:00Z', 'n/step');
+    is(next_after('10-30/10,45 * * * *', '2012-12-24T00:30Z'), '2012-12-24T00:45:00Z', 'list of ranges');
+}
+
+{
+    my %macros = (
+        '@yearly'   => '2013-01-01T00:00:00Z',
+        '@annually' => '2013-01-01T00:00:00Z',
+        '@monthly'  => '2013-01-01T00:00:00Z',
+        '@weekly'   => '2012-12-30T00:00:00Z',
+        '@daily'    => '2012-12-25T00:00:00Z',
+        '@midnight' => '2012-12-25T00:00:00Z',
+        '@hourly'   => '2012-12-24T11:00:00Z',
+    );
+    foreach my $macro (sort keys %macros) {
+        is(next_after($macro, '2012-12-24T10:30Z'), $macros{$macro}, $macro);
+    }
+}
+
+{
+    is(next_after('* * * * *', '9999-12-31T23:59Z'), undef, 'no next at the end of the range');
+    is(prev_before('* * * * *', '0001-01-01T00:00Z'), undef, 'no previous at the start of the range');
+    is(next_after('0 0 29 2 *', '9996-02-29T00:00Z'), undef, 'no next february 29');
+}
+
+# The previous minute of the next minute is on or before the moment, and
+# the next minute of that is the same
+{
+    my @expressions = ('*/7 */5 * * *', '0 0 1,15 * 1', '17 3 */10 2,8 *',
+                       '0 0 29 2 *', '59 23 * * 6,7', '1-5 22 31 * *');
+    my $tm = tm('2011-11-30T21:41:17.5+05:30');
+    foreach my $expression (@expressions) {
+        my $cron = Time::Moment::Cron->new($expression);
+        my $ok = 1;
+        for my $i (0..99) {
+            my $t    = $tm->plus_minutes($i * 1237);
+            my $next = $cron->next_after($t);
+            my $prev = $cron->prev_before($next);
+            $ok &&= $cron->matches($next) && $cron->matches($prev)
+                 && $next->is_after($t) && !$prev->is_after($t)
+                 && $cron->next_after($prev)->is_equal($next);
+        }
+        ok($ok, "next_after and prev_before agree for '$expression'");
+    }
+}
+
+{
+    my @invalid = ('', '* * * *', '* * * * * *', '60 * * * *', '* 24 * * *', '* * 0 * *',
+                   '* * * 13 *', '* * * * 8', '*/0 * * * *', '5-1 * * * *', '* * * foo *',
+                   '1,,2 * * * *', '@reboot', '@daily *');
+    foreach my $expression (@invalid) {
+        like(exception { Time::Moment::Cron->new($expression) },
+          qr/^Could not parse the given cron expression/, "invalid expression '$expression'");
+    }
+    like(exception { Time::Moment::Cron->new('0 0 30 2 *') },
+      qr/^Cron expression does not match any date/, 'never matches');
+    like(exception { Time::Moment::Cron::next_after(tm('2012-12-24T00:00Z'), tm('2012-12-24T00:00Z')) },
+      qr/^self is not an instance of Time::Moment::Cron/, 'self not a cron');
+}
+
+done_testing();
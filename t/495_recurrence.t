@@ -0,0 +1,166 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Recurrence');
+}
+
+sub tm { Time::Moment->from_string(@_) }
+
+# Returns the dates of the first n occurrences
+sub dates {
+    my ($dtstart, $rule, $n) = @_;
+    my $rr = Time::Moment::Recurrence->new(tm("${dtstart}T09:00-04:00"), $rule);
+    my @r;
+    while (!defined $n || $n-- > 0) {
+        my $tm = $rr->next or last;
+        push @r, $tm->strftime('%Y-%m-%d');
+    }
+    return \@r;
+}
+
+# Examples from RFC 5545, section 3.8.5.3
+my @tests = (
+    [ '1997-09-02', 'FREQ=DAILY;COUNT=10', undef,
+      [ map { sprintf '1997-09-%02d', $_ } 2..11 ] ],
+    [ '1997-09-02', 'FREQ=DAILY;INTERVAL=10;COUNT=5', undef,
+      [ qw(1997-09-02 1997-09-12 1997-09-22 1997-10-02 1997-10-12) ] ],
+    [ '1997-09-02', 'FREQ=DAILY;INTERVAL=2', 4,
+      [ qw(1997-09-02 1997-09-04 1997-09-06 1997-09-08) ] ],
+    [ '1997-09-02', 'FREQ=WEEKLY;COUNT=4', undef,
+      [ qw(1997-09-02 1997-09-09 1997-09-16 1997-09-23) ] ],
+    [ '1997-09-02', 'FREQ=WEEKLY;UNTIL=19971007T000000Z;WKST=SU;BYDAY=TU,TH', undef,
+      [ qw(1997-09-02 1997-09-04 1997-09-09 1997-09-11 1997-09-16
+           1997-09-18 1997-09-23 1997-09-25 1997-09-30 1997-10-02) ] ],
+    [ '1997-09-01', 'FREQ=WEEKLY;INTERVAL=2;UNTIL=19971224T000000Z;WKST=SU;BYDAY=MO,WE,FR', 7,
+      [ qw(1997-09-01 1997-09-03 1997-09-05 1997-09-15 1997-09-17 1997-09-19 1997-09-29) ] ],
+    [ '1997-09-02', 'FREQ=WEEKLY;INTERVAL=2;COUNT=8;WKST=SU;BYDAY=TU,TH', undef,
+      [ qw(1997-09-02 1997-09-04 1997-09-16 1997-09-18
+           1997-09-30 1997-10-02 1997-10-14 1997-10-16) ] ],
+    [ '1997-09-05', 'FREQ=MONTHLY;COUNT=10;BYDAY=1FR', undef,
+      [ qw(1997-09-05 1997-10-03 1997-11-07 1997-12-05 1998-01-02
+           1998-02-06 1998-03-06 1998-04-03 1998-05-01 1998-06-05) ] ],
+    [ '1997-09-07', 'FREQ=MONTHLY;INTERVAL=2;COUNT=10;BYDAY=1SU,-1SU', undef,
+      [ qw(1997-09-07 1997-09-28 1997-11-02 1997-11-30 1998-01-04
+           1998-01-25 1998-03-01 1998-03-29 1998-05-03 1998-05-31) ] ],
+    [ '1997-09-22', 'FREQ=MONTHLY;COUNT=6;BYDAY=-2MO', undef,
+      [ qw(1997-09-22 1997-10-20 1997-11-17 1997-12-22 1998-01-19 1998-02-16) ] ],
+    [ '1997-09-28', 'FREQ=MONTHLY;BYMONTHDAY=-3', 6,
+      [ qw(1997-09-28 1997-10-29 1997-11-28 1997-12-29 1998-01-29 1998-02-26) ] ],
+    [ '1997-09-02', 'FREQ=MONTHLY;COUNT=10;BYMONTHDAY=2,15', undef,
+      [ qw(1997-09-02 1997-09-15 1997-10-02 1997-10-15 1997-11-02
+           1997-11-15 1997-12-02 1997-12-15 1998-01-02 1998-01-15) ] ],
+    [ '1997-09-30', 'FREQ=MONTHLY;COUNT=10;BYMONTHDAY=1,-1', undef,
+      [ qw(1997-09-30 1997-10-01 1997-10-31 1997-11-01 1997-11-30
+           1997-12-01 1997-12-31 1998-01-01 1998-01-31 1998-02-01) ] ],
+    [ '1997-09-10', 'FREQ=MONTHLY;INTERVAL=18;COUNT=10;BYMONTHDAY=10,11,12,13,14,15', undef,
+      [ qw(1997-09-10 1997-09-11 1997-09-12 1997-09-13 1997-09-14
+           1997-09-15 1999-03-10 1999-03-11 1999-03-12 1999-03-13) ] ],
+    [ '1997-09-02', 'FREQ=MONTHLY;INTERVAL=2;BYDAY=TU', 6,
+      [ qw(1997-09-02 1997-09-09 1997-09-16 1997-09-23 1997-09-30 1997-11-04) ] ],
+    [ '1997-06-10', 'FREQ=YEARLY;COUNT=10;BYMONTH=6,7', undef,
+      [ qw(1997-06-10 1997-07-10 1998-06-10 1998-07-10 1999-06-10
+           1999-07-10 2000-06-10 2000-07-10 2001-06-10 2001-07-10) ] ],
+    [ '1997-03-10', 'FREQ=YEARLY;INTERVAL=2;COUNT=10;BYMONTH=1,2,3', undef,
+      [ qw(1997-03-10 1999-01-10 1999-02-10 1999-03-10 2001-01-10
+           2001-02-10 2001-03-10 2003-01-10 2003-02-10 2003-03-10) ] ],
+    [ '1997-05-19', 'FREQ=YEARLY;BYDAY=20MO', 3,
+      [ qw(1997-05-19 1998-05-18 1999-05-17) ] ],
+    [ '1997-03-13', 'FREQ=YEARLY;BYMONTH=3;BYDAY=TH', 11,
+      [ qw(1997-03-13 1997-03-20 1997-03-27 1998-03-05 1998-03-12 1998-03-19
+           1998-03-26 1999-03-04 1999-03-11 1999-03-18 1999-03-25) ] ],
+    [ '1997-09-02', 'FREQ=MONTHLY;BYDAY=FR;BYMONTHDAY=13', 5,
+      [ qw(1998-02-13 1998-03-13 1998-11-13 1999-08-13 2000-10-13) ] ],
+    [ '1997-09-13', 'FREQ=MONTHLY;BYDAY=SA;BYMONTHDAY=7,8,9,10,11,12,13', 10,
+      [ qw(1997-09-13 1997-10-11 1997-11-08 1997-12-13 1998-01-10
+           1998-02-07 1998-03-07 1998-04-11 1998-05-09 1998-06-13) ] ],
+    [ '1996-11-05', 'FREQ=YEARLY;INTERVAL=4;BYMONTH=11;BYDAY=TU;BYMONTHDAY=2,3,4,5,6,7,8', 3,
+      [ qw(1996-11-05 2000-11-07 2004-11-02) ] ],
+    [ '1997-09-04', 'FREQ=MONTHLY;COUNT=3;BYDAY=TU,WE,TH;BYSETPOS=3', undef,
+      [ qw(1997-09-04 1997-10-07 1997-11-06) ] ],
+    [ '1997-09-29', 'FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-2', 7,
+      [ qw(1997-09-29 1997-10-30 1997-11-27 1997-12-30 1998-01-29 1998-02-26 1998-03-30) ] ],
+    [ '2007-01-15', 'FREQ=MONTHLY;BYMONTHDAY=15,30;COUNT=5', undef,
+      [ qw(2007-01-15 2007-01-30 2007-02-15 2007-03-15 2007-03-30) ] ],
+    [ '1997-08-05', 'FREQ=WEEKLY;INTERVAL=2;COUNT=4;BYDAY=TU,SU;WKST=MO', undef,
+      [ qw(1997-08-05 1997-08-10 1997-08-19 1997-08-24) ] ],
+    [ '1997-08-05', 'FREQ=WEEKLY;INTERVAL=2;COUNT=4;BYDAY=TU,SU;WKST=SU', undef,
+      [ qw(1997-08-05 1997-08-17 1997-08-19 1997-08-31) ] ],
+);
+
+foreach my $test (@tests) {
+    my ($dtstart, $rule, $n, $expected) = @$test;
+    is_deeply(dates($dtstart, $rule, $n), $expected, "$rule from $dtstart");
+}
+
+{
+    my $all = dates('1998-01-01', 'FREQ=YEARLY;UNTIL=20000131T140000Z;BYMONTH=1;BYDAY=SU,MO,TU,WE,TH,FR,SA');
+    is(scalar @$all, 93, 'every day in January for 3 years, yearly');
+    is_deeply(dates('1998-01-01', 'RRULE:FREQ=DAILY;UNTIL=20000131T140000Z;BYMONTH=1'), $all,
+      'every day in January for 3 years, daily');
+    my $until = dates('1997-09-02', 'FREQ=DAILY;UNTIL=19971224T000000Z');
+    is(scalar @$until, 113, 'daily until a UTC date and time');
+    is($until->[-1], '1997-12-23', 'UNTIL is exclusive of later occurrences');
+    is_deeply(dates('1997-09-02', 'FREQ=WEEKLY;UNTIL=19970916'),
+      [ qw(1997-09-02 1997-09-09 1997-09-16) ], 'UNTIL as a date is inclusive');
+    is_deeply(dates('1997-09-02', 'FREQ=WEEKLY;UNTIL=19970916T085959'),
+      [ qw(1997-09-02 1997-09-09) ], 'floating UNTIL in the offset of DTSTART');
+}
+
+{
+    my $rr = Time::Moment::Recurrence->new(tm('2012-01-31T12:30:15.5+01:00'), 'FREQ=MONTHLY;COUNT=3');
+    isa_ok($rr, 'Time::Moment::Recurrence');
+    my @strings;
+    while (my $tm = $rr->next) {
+        push @strings, $tm->to_string;
+    }
+    is_deeply(\@strings, [ qw(2012-01-31T12:30:15.500+01:00 2012-03-31T12:30:15.500+01:00
+                              2012-05-31T12:30:15.500+01:00) ],
+      'time of day and offset of DTSTART, months without the day are skipped');
+    is($rr->next, undef, 'exhausted');
+
+    my $tm;
+    ok($rr->reset->next($tm), 'next($tm) after reset');
+    is($tm->to_string, '2012-01-31T12:30:15.500+01:00', 'next($tm)');
+
+    my $packed = $rr->to_packed;
+    is(length $packed, 3 * 16, 'to_packed of a bounded rule');
+    my ($sec, $nsec, $offset) = unpack 'q l l', substr($packed, 16, 16);
+    my $second = tm('2012-03-31T12:30:15.5+01:00');
+    is_deeply([$sec, $nsec, $offset],
+      [$second->rdn * 86400 + 12 * 3600 + 30 * 60 + 15, 500_000_000, 60], 'packed moment');
+    ok($rr->next($tm), 'to_packed does not advance the iterator');
+
+    my $daily = Time::Moment::Recurrence->new(tm('2012-01-01T00:00Z'), 'FREQ=DAILY');
+    is(length $daily->to_packed(10), 10 * 16, 'to_packed with a limit');
+    like(exception { $daily->to_packed }, qr/^Recurrence rule has neither COUNT nor UNTIL/,
+      'to_packed of an unbounded rule');
+
+    my $end = Time::Moment::Recurrence->new(tm('9999-12-30T00:00Z'), 'FREQ=DAILY');
+    is(length $end->to_packed(10), 2 * 16, 'ends at the end of the supported range');
+}
+
+{
+    my $dtstart = tm('2012-01-01T00:00Z');
+    my @invalid = ('', 'COUNT=1', 'FREQ=FORTNIGHTLY', 'FREQ=DAILY;COUNT=0', 'FREQ=DAILY;COUNT=1;UNTIL=20120101',
+                   'FREQ=DAILY;INTERVAL=0', 'FREQ=DAILY;BYMONTH=13', 'FREQ=DAILY;BYMONTHDAY=0',
+                   'FREQ=DAILY;BYDAY=XX', 'FREQ=WEEKLY;BYDAY=1MO', 'FREQ=MONTHLY;BYDAY=6MO',
+                   'FREQ=DAILY;FREQ=DAILY', 'FREQ=DAILY;', 'FREQ=DAILY;UNTIL=20120230', 'FREQ=DAILY;X-FOO=1');
+    foreach my $rule (@invalid) {
+        like(exception { Time::Moment::Recurrence->new($dtstart, $rule) },
+          qr/^Could not parse the given recurrence rule/, "invalid rule '$rule'");
+    }
+    foreach my $rule ('FREQ=HOURLY', 'FREQ=YEARLY;BYYEARDAY=1', 'FREQ=DAILY;BYHOUR=9') {
+        like(exception { Time::Moment::Recurrence->new($dtstart, $rule) },
+          qr/^Recurrence rule part is not supported/, "unsupported rule '$rule'");
+    }
+    like(exception { Time::Moment::Recurrence::next($dtstart) },
+      qr/^self is not an instance of Time::Moment::Recurrence/, 'self not a recurrence');
+}
+
+done_testing();
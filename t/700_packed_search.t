@@ -0,0 +1,89 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use lib 't';
+use Util qw[pack_moments unpack_moments];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+my @formats = qw(seconds milliseconds microseconds nanoseconds moment);
+
+# Sorted moments with duplicates, in various offsets, around the Unix epoch
+srand(42);
+my $base = Time::Moment->from_string('1969-12-31T12:00:00Z');
+my @moments = sort { $a->compare($b) } map {
+    $base->plus_seconds(int(rand(86400 * 2)))
+         ->plus_nanoseconds(int(rand(4)) * 250_000_000)
+         ->with_offset_same_instant(int(rand(5)) * 60 - 120)
+} 1 .. 200;
+push @moments, ($moments[-1]) x 3;
+
+my @keys = (
+    $base->minus_days(1),
+    $base->plus_days(3),
+    $moments[0],
+    $moments[-1],
+    $moments[100],
+    $moments[100]->plus_nanoseconds(1),
+    $moments[100]->minus_nanoseconds(1),
+    $moments[100]->with_offset_same_instant(600),
+    map { $base->plus_seconds(int(rand(86400 * 2)))->plus_nanoseconds(int(rand(1e9))) } 1 .. 50,
+);
+
+foreach my $format (@formats) {
+    my $packed = pack_moments($format, @moments);
+    my @stored = unpack_moments($format, $packed);
+    my $ok = 1;
+    foreach my $key (@keys) {
+        my $lower = grep { $_->is_before($key) } @stored;
+        my $upper = grep { !$_->is_after($key) } @stored;
+        my $got_lower = Time::Moment::Packed::lower_bound($packed, $format, $key);
+        my $got_upper = Time::Moment::Packed::upper_bound($packed, $format, $key);
+        unless ($got_lower == $lower && $got_upper == $upper) {
+            diag("$format $key: lower $got_lower != $lower or upper $got_upper != $upper");
+            $ok = 0;
+        }
+    }
+    ok($ok, "lower_bound and upper_bound of $format agree with a linear scan");
+
+    my ($from, $to) = ($moments[50], $moments[150]);
+    my @bounds = Time::Moment::Packed::bounds($packed, $format, $from, $to);
+    is_deeply(\@bounds, [
+        Time::Moment::Packed::lower_bound($packed, $format, $from),
+        Time::Moment::Packed::lower_bound($packed, $format, $to),
+    ], "bounds of $format");
+    is_deeply([Time::Moment::Packed::bounds($packed, $format, $to, $from)],
+      [ ($bounds[1]) x 2 ], "bounds of $format with to before from is empty");
+}
+
+{
+    my $far = Time::Moment->from_string('9999-12-31T23:59:59Z');
+    my $near = Time::Moment->from_string('0001-01-01T00:00:00Z');
+    my $packed = pack 'q*', -5, 0, 5, 9_223_372_036_854_775_807;
+    is(Time::Moment::Packed::lower_bound($packed, 'nanoseconds', $far), 4,
+      'key after the range of int64 nanoseconds');
+    is(Time::Moment::Packed::upper_bound($packed, 'nanoseconds', $near), 0,
+      'key before the range of int64 nanoseconds');
+    is(Time::Moment::Packed::lower_bound('', 'moment', $far), 0, 'empty buffer');
+}
+
+{
+    my $tm = Time::Moment->now;
+    like(exception { Time::Moment::Packed::lower_bound('x' x 9, 'seconds', $tm) },
+      qr/^buffer is not a packed buffer of 8-byte elements/, 'odd buffer length');
+    like(exception { Time::Moment::Packed::lower_bound('x' x 8, 'moment', $tm) },
+      qr/^buffer is not a packed buffer of 16-byte elements/, 'odd moment buffer length');
+    like(exception { Time::Moment::Packed::lower_bound('', 'days', $tm) },
+      qr/^Unrecognised packed format: 'days'/, 'unknown format');
+    like(exception { Time::Moment::Packed::lower_bound('', 'seconds', 1) },
+      qr/^moment is not an instance of Time::Moment/, 'key not a moment');
+}
+
+done_testing();
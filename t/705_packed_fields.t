@@ -0,0 +1,71 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use lib 't';
+use Util qw[pack_moments %range random_nanosecond random_offset];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+my @fields = qw(year quarter month week day_of_year day_of_quarter
+                day_of_month day_of_week hour minute minute_of_day second
+                second_of_day millisecond millisecond_of_day microsecond
+                nanosecond precision rdn);
+
+srand(42);
+
+foreach my $format (sort keys %range) {
+    my ($min, $max) = @{ $range{$format} };
+    my @epochs = ($min, $max, -1, 0, 951782400, 951868800, 1104537600, 1230681600);
+    push @epochs, map { $min + int(rand($max - $min)) } 1 .. 500;
+    my @moments = map {
+        my $nsec = random_nanosecond($format);
+        $nsec = 0 if rand() < 0.3;
+        Time::Moment->from_epoch($_, $nsec)
+                    ->with_offset_same_instant(random_offset());
+    } @epochs;
+    my $packed = pack_moments($format, @moments);
+
+    foreach my $offset (0, 330, -1080) {
+        my @columns = Time::Moment::Packed::fields($packed, $format, $offset, @fields);
+        is(scalar @columns, scalar @fields, "$format: one column per field");
+        foreach my $i (0 .. $#fields) {
+            my $field = $fields[$i];
+            my @got = unpack 'l*', $columns[$i];
+            my @exp = map { $_->with_offset_same_instant($offset)->$field } @moments;
+            is_deeply(\@got, \@exp, "$format: $field at offset $offset");
+        }
+    }
+}
+
+{
+    my $packed = pack 'q*', 0, 86399;
+    is_deeply([Time::Moment::Packed::fields($packed, 'seconds', 0)], [], 'no fields');
+    is_deeply([map { [unpack 'l*', $_] } Time::Moment::Packed::fields('', 'seconds', 0, 'year', 'rdn')],
+      [[], []], 'empty buffer');
+    is_deeply([map { [unpack 'l*', $_] } Time::Moment::Packed::fields($packed, 'seconds', 60, 'hour', 'hour')],
+      [[1, 0], [1, 0]], 'repeated field');
+}
+
+{
+    like(exception { Time::Moment::Packed::fields(pack('q', 0), 'seconds', 0, 'offset') },
+      qr/^Unrecognised field: 'offset'/, 'unknown field');
+    like(exception { Time::Moment::Packed::fields(pack('q', 0), 'seconds', 1081, 'year') },
+      qr/^Parameter 'offset' is out of the range/, 'offset out of range');
+    like(exception { Time::Moment::Packed::fields(pack('q', 253402300800), 'seconds', 0, 'year') },
+      qr/^Time::Moment is out of range/, 'element after 9999-12-31');
+    like(exception { Time::Moment::Packed::fields(pack('q', 253402300799), 'seconds', 1, 'year') },
+      qr/^Time::Moment is out of range/, 'element after 9999-12-31 at the offset');
+    like(exception { Time::Moment::Packed::fields(pack('q', -62135596801), 'seconds', 0, 'year') },
+      qr/^Time::Moment is out of range/, 'element before 0001-01-01');
+    like(exception { Time::Moment::Packed::fields(pack('q l l', 86400, 1e9, 0), 'moment', 0, 'year') },
+      qr/^Time::Moment is out of range/, 'moment with an invalid nanosecond');
+}
+
+done_testing();
@@ -0,0 +1,115 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+use Math::BigInt;
+
+use lib 't';
+use Util qw[pack_moments %scale %range random_nanosecond random_offset];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+my @units = qw(years months weeks days hours minutes seconds
+               milliseconds microseconds nanoseconds);
+
+srand(42);
+
+sub random_moment {
+    my ($format, $min, $max) = @_;
+    my $nsec = random_nanosecond($format);
+    my $tm = Time::Moment->from_epoch($min + int(rand($max - $min)), $nsec);
+    $tm = $tm->with_offset_same_instant(random_offset())
+      if $format eq 'moment';
+    return $tm;
+}
+
+foreach my $format (sort keys %range) {
+    my ($min, $max) = @{ $range{$format} };
+    my (@start, @end);
+    foreach my $i (1 .. 300) {
+        my $tm = random_moment($format, $min, $max);
+        push @start, $tm;
+        if ($i % 3 == 0) {
+            # Pairs close to each other, to exercise the rounding of small differences
+            my $delta = int(rand(200_000)) - 100_000;
+            my $other = $tm->plus_seconds($delta)->plus_nanoseconds(random_nanosecond($format));
+            $other = $tm unless $other->epoch >= $min && $other->epoch <= $max;
+            push @end, $other;
+        }
+        else {
+            push @end, random_moment($format, $min, $max);
+        }
+    }
+    my $start_packed = pack_moments($format, @start);
+    my $end_packed   = pack_moments($format, @end);
+
+    foreach my $unit (@units) {
+        my ($deltas, $overflow) = Time::Moment::Packed::delta($start_packed, $end_packed, $format, $unit);
+        my @got = unpack 'q*', $deltas;
+        my $method = "delta_$unit";
+        my (@exp, @flags);
+        foreach my $i (0 .. $#start) {
+            my $d = eval { $start[$i]->$method($end[$i]) };
+            push @exp, defined $d ? $d : 0;
+            push @flags, defined $d ? 0 : 1;
+        }
+        # Epoch differences in nanoseconds are exact where Time::Moment overflows
+        if ($unit eq 'nanoseconds' && $format ne 'moment') {
+            foreach my $i (grep { $flags[$_] } 0 .. $#start) {
+                my $e = Math::BigInt->new(unpack 'q', substr($end_packed, $i * 8, 8))
+                      - Math::BigInt->new(unpack 'q', substr($start_packed, $i * 8, 8));
+                $e *= $scale{$format};
+                if ($e >= Math::BigInt->new('-9223372036854775808') && $e <= Math::BigInt->new('9223372036854775807')) {
+                    $exp[$i] = "$e";
+                    $flags[$i] = 0;
+                }
+            }
+        }
+        is_deeply(\@got, \@exp, "$format: $unit");
+        is_deeply([map { vec($overflow, $_, 1) } 0 .. $#start], \@flags,
+          "$format: $unit overflow flags");
+    }
+}
+
+{
+    my $start = pack 'q*', -9223372036854775807 - 1, 0, 9223372036854775807, 1;
+    my $end   = pack 'q*', 1, 9223372036854775807, -1, 2;
+    my ($deltas, $overflow) = Time::Moment::Packed::delta($start, $end, 'nanoseconds', 'nanoseconds');
+    is_deeply([unpack 'q*', $deltas], [0, 9223372036854775807, 0, 1], 'int64 overflow of the difference');
+    is(unpack('b*', $overflow), '10100000', 'overflow flags');
+
+    ($deltas, $overflow) = Time::Moment::Packed::delta(pack('q*', 0, 0), pack('q*', 9223372037, 1), 'seconds', 'nanoseconds');
+    is_deeply([unpack 'q*', $deltas], [0, 1e9], 'overflow of the unit conversion');
+    is(unpack('b*', $overflow), '10000000', 'overflow flags');
+
+    ($deltas, $overflow) = Time::Moment::Packed::delta(pack('q*', 0, 0), pack('q*', 253402300800, 86400 * 31), 'seconds', 'months');
+    is_deeply([unpack 'q*', $deltas], [0, 1], 'calendar unit of an element out of range');
+    is(unpack('b*', $overflow), '10000000', 'overflow flags');
+
+    ($deltas, $overflow) = Time::Moment::Packed::delta(pack('q l l', 86400, 0, 1081), pack('q l l', 86400, 0, 0), 'moment', 'seconds');
+    is_deeply([unpack 'q*', $deltas], [0], 'invalid moment');
+    is(unpack('b*', $overflow), '10000000', 'overflow flags');
+
+    my $scalar = Time::Moment::Packed::delta(pack('q', 0), pack('q', 60), 'seconds', 'minutes');
+    is_deeply([unpack 'q*', $scalar], [1], 'deltas in scalar context');
+
+    ($deltas, $overflow) = Time::Moment::Packed::delta('', '', 'moment', 'days');
+    is($deltas, '', 'empty buffers');
+    is($overflow, '', 'empty buffers');
+}
+
+{
+    like(exception { Time::Moment::Packed::delta(pack('q', 0), pack('q*', 0, 1), 'seconds', 'days') },
+      qr/^start and end do not have the same number of elements/, 'different lengths');
+    like(exception { Time::Moment::Packed::delta('', '', 'seconds', 'fortnights') },
+      qr/^Unrecognised unit: 'fortnights'/, 'unknown unit');
+    like(exception { Time::Moment::Packed::delta('', 'x', 'seconds', 'days') },
+      qr/^end is not a packed buffer of 8-byte elements/, 'odd buffer length');
+}
+
+done_testing();
@@ -0,0 +1,121 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use lib 't';
+use Util qw[pack_moments unpack_moments];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+srand(42);
+my @moments = map {
+    Time::Moment->from_epoch(-62135596800 + int(rand(315537897599)), int(rand(1e9)))
+                ->with_offset_same_instant(int(rand(2161)) - 1080)
+} 1 .. 300;
+push @moments, Time::Moment->from_string('9999-12-31T23:00:00Z'),
+               Time::Moment->from_string('0001-01-01T00:30:00-01:00');
+
+sub check {
+    my ($name, $code, $expected) = @_;
+    my $packed = pack_moments('moment', @moments);
+    my ($count, $failed) = $code->($packed);
+    my (@exp, @flags);
+    foreach my $tm (@moments) {
+        my $r = eval { $expected->($tm) };
+        push @exp, ($r || $tm)->to_string;
+        push @flags, $r ? 0 : 1;
+    }
+    my $n = grep { $_ } @flags;
+    is_deeply([map { $_->to_string } unpack_moments('moment', $packed)], \@exp, $name);
+    is($count, $n, "$name: number of failed elements");
+    is_deeply([map { vec($failed, $_, 1) } 0 .. $#moments], \@flags, "$name: failed elements");
+}
+
+foreach my $unit (qw(years months weeks days hours minutes seconds
+                     milliseconds microseconds nanoseconds)) {
+    foreach my $value (-7, 1, 1000) {
+        my $method = "plus_$unit";
+        check("plus_unit($unit, $value)",
+          sub { Time::Moment::Packed::plus_unit($_[0], $unit, $value) },
+          sub { $_[0]->$method($value) });
+    }
+}
+
+foreach my $offset (-1080, -330, 0, 120, 1080) {
+    check("with_offset_same_instant($offset)",
+      sub { Time::Moment::Packed::with_offset_same_instant($_[0], $offset) },
+      sub { $_[0]->with_offset_same_instant($offset) });
+}
+
+foreach my $precision (-3 .. 9) {
+    check("with_precision($precision)",
+      sub { Time::Moment::Packed::with_precision($_[0], $precision) },
+      sub { $_[0]->with_precision($precision) });
+}
+
+check('at_midnight',
+  sub { Time::Moment::Packed::at_midnight($_[0]) },
+  sub { $_[0]->at_midnight });
+
+{
+    my %truncate = (
+        years        => sub { $_[0]->with_day_of_year(1)->at_midnight },
+        months       => sub { $_[0]->with_day_of_month(1)->at_midnight },
+        weeks        => sub { $_[0]->with_day_of_week(1)->at_midnight },
+        days         => sub { $_[0]->with_precision(-3) },
+        hours        => sub { $_[0]->with_precision(-2) },
+        minutes      => sub { $_[0]->with_precision(-1) },
+        seconds      => sub { $_[0]->with_precision(0) },
+        milliseconds => sub { $_[0]->with_precision(3) },
+        microseconds => sub { $_[0]->with_precision(6) },
+        nanoseconds  => sub { $_[0] },
+    );
+    foreach my $unit (sort keys %truncate) {
+        check("truncate_to($unit)",
+          sub { Time::Moment::Packed::truncate_to($_[0], $unit) },
+          $truncate{$unit});
+    }
+}
+
+{
+    my $tm = Time::Moment->from_string('2012-12-24T15:30:45.123456789+01:00');
+    my $packed = pack_moments('moment', $tm, $tm) . pack('q l l', 0, 0, 0);
+    my $count = Time::Moment::Packed::plus_unit($packed, 'days', 1);
+    is($count, 1, 'invalid moment is counted in scalar context');
+    is_deeply([map { $_->to_string } unpack_moments('moment', substr($packed, 0, 32))],
+      [('2012-12-25T15:30:45.123456789+01:00') x 2], 'valid moments are transformed');
+    is(substr($packed, 32), pack('q l l', 0, 0, 0), 'invalid moment is unchanged');
+
+    my $empty = '';
+    is(Time::Moment::Packed::at_midnight($empty), 0, 'empty buffer');
+}
+
+{
+    my $tm = Time::Moment->from_string('2012-12-24T15:30:45Z');
+    my $packed = pack_moments('moment', $tm);
+    my $copy = $packed;
+    like(exception { Time::Moment::Packed::with_precision($packed, 10) },
+      qr/^Parameter 'precision' is out of the range/, 'precision out of range');
+    like(exception { Time::Moment::Packed::with_offset_same_instant($packed, 1081) },
+      qr/^Parameter 'offset' is out of the range/, 'offset out of range');
+    like(exception { Time::Moment::Packed::plus_unit($packed, 'days', 10_000_000) },
+      qr/^Parameter 'days' is out of range/, 'value out of range');
+    is($packed, $copy, 'buffer is unchanged after a parameter error');
+    like(exception { Time::Moment::Packed::plus_unit($packed, 'fortnights', 1) },
+      qr/^Unrecognised unit: 'fortnights'/, 'unknown unit');
+    my $readonly = 'x' x 16;
+    Internals::SvREADONLY($readonly, 1);
+    like(exception { Time::Moment::Packed::at_midnight($readonly) },
+      qr/^Modification of a read-only value attempted/, 'read-only buffer');
+    my $odd = 'x' x 8;
+    like(exception { Time::Moment::Packed::at_midnight($odd) },
+      qr/^buffer is not a packed buffer of 16-byte elements/, 'odd buffer length');
+}
+
+done_testing();
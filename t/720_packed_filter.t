@@ -0,0 +1,107 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use lib 't';
+use Util qw[pack_moments unpack_moments %range random_nanosecond random_offset];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+srand(42);
+
+sub selected {
+    my ($bitmap, $n) = @_;
+    return [grep { vec($bitmap, $_, 1) } 0 .. $n - 1];
+}
+
+foreach my $format (sort keys %range) {
+    my ($min, $max) = @{ $range{$format} };
+    # Mostly within a week, so that the predicates select something
+    my $base = Time::Moment->from_epoch($min + int(rand($max - $min - 86400 * 7)));
+    my @moments = map {
+        my $nsec = random_nanosecond($format);
+        my $tm = $_ % 10 ? $base->plus_seconds(int(rand(86400 * 7)))
+                         : Time::Moment->from_epoch($min + int(rand($max - $min)));
+        $tm->plus_nanoseconds($nsec)->with_offset_same_instant(random_offset());
+    } 1 .. 1000;
+    my $n = @moments;
+    my $packed = pack_moments($format, @moments);
+    my @stored = unpack_moments($format, $packed);
+
+    my $from = $base->plus_seconds(86400)->plus_nanoseconds(int(rand(1e9)));
+    my $to   = $from->plus_seconds(86400 * 3);
+    my @cases = (
+        [ 'no predicates', [], sub { 1 } ],
+        [ 'from', [from => $from], sub { !$_[0]->is_before($from) } ],
+        [ 'to', [to => $to], sub { $_[0]->is_before($to) } ],
+        [ 'from and to', [from => $from, to => $to],
+          sub { !$_[0]->is_before($from) && $_[0]->is_before($to) } ],
+        [ 'to before from', [from => $to, to => $from], sub { 0 } ],
+        [ 'day_of_week', [day_of_week => [6, 7]],
+          sub { $_[0]->at_utc->day_of_week >= 6 } ],
+        [ 'hour at an offset', [hour => [9 .. 17], offset => 60],
+          sub { my $h = $_[0]->with_offset_same_instant(60)->hour; $h >= 9 && $h <= 17 } ],
+        [ 'single value', [day_of_month => 1],
+          sub { $_[0]->at_utc->day_of_month == 1 } ],
+        [ 'empty set', [month => []], sub { 0 } ],
+        [ 'range and fields', [from => $from, to => $to, day_of_week => [1, 3, 5], minute => [0 .. 29]],
+          sub {
+            my $utc = $_[0]->at_utc;
+            !$_[0]->is_before($from) && $_[0]->is_before($to)
+              && $utc->day_of_week % 2 && $utc->day_of_week < 7 && $utc->minute < 30
+          } ],
+        [ 'year', [year => [$base->year - 1 .. $base->year + 1]],
+          sub { abs($_[0]->at_utc->year - $base->year) <= 1 } ],
+    );
+    foreach my $case (@cases) {
+        my ($name, $params, $predicate) = @$case;
+        my @expected = grep { $predicate->($stored[$_]) } 0 .. $n - 1;
+        my ($bitmap, $count) = Time::Moment::Packed::filter($packed, $format, @$params);
+        is(length $bitmap, int(($n + 7) / 8), "$format: $name: bitmap length");
+        is_deeply(selected($bitmap, $n), \@expected, "$format: $name");
+        is($count, scalar @expected, "$format: $name: count");
+        my $indices = Time::Moment::Packed::filter_indices($packed, $format, @$params);
+        is_deeply([unpack 'q*', $indices], \@expected, "$format: $name: indices");
+    }
+}
+
+{
+    my $packed = pack 'q*', -9223372036854775807 - 1, -1, 0, 1, 9223372036854775807;
+    my $far  = Time::Moment->from_string('9999-12-31T23:59:59Z');
+    my $near = Time::Moment->from_string('0001-01-01T00:00:00Z');
+    my $epoch = Time::Moment->from_epoch(0);
+    is_deeply(selected(scalar Time::Moment::Packed::filter($packed, 'nanoseconds', from => $near, to => $far), 5),
+      [0 .. 4], 'bounds beyond the range of int64 nanoseconds');
+    is_deeply(selected(scalar Time::Moment::Packed::filter($packed, 'nanoseconds', from => $far), 5),
+      [], 'from after the range of int64 nanoseconds');
+    is_deeply(selected(scalar Time::Moment::Packed::filter($packed, 'nanoseconds', to => $near), 5),
+      [], 'to before the range of int64 nanoseconds');
+    is_deeply(selected(scalar Time::Moment::Packed::filter($packed, 'nanoseconds', to => $epoch->plus_nanoseconds(1)), 5),
+      [0 .. 2], 'to is exclusive');
+    is_deeply(selected(scalar Time::Moment::Packed::filter($packed, 'seconds', hour => [0 .. 23]), 5),
+      [1 .. 3], 'elements out of range do not match a field');
+    is(Time::Moment::Packed::filter('', 'moment', hour => 1), '', 'empty buffer');
+}
+
+{
+    like(exception { Time::Moment::Packed::filter('', 'seconds', 'from') },
+      qr/^Odd number of elements in named parameters/, 'odd number of parameters');
+    like(exception { Time::Moment::Packed::filter('', 'seconds', colour => 1) },
+      qr/^Unrecognised parameter: 'colour'/, 'unknown parameter');
+    like(exception { Time::Moment::Packed::filter('', 'seconds', from => 1) },
+      qr/^from is not an instance of Time::Moment/, 'from not a moment');
+    like(exception { Time::Moment::Packed::filter('', 'seconds', hour => {}) },
+      qr/^Parameter 'hour' is not an integer or an ARRAY reference/, 'hash of values');
+    like(exception { Time::Moment::Packed::filter('', 'seconds', nanosecond => [0, 999_999_999]) },
+      qr/^Parameter 'nanosecond' has values spanning more than 1048576/, 'values too far apart');
+    like(exception { Time::Moment::Packed::filter('', 'seconds', offset => 1081) },
+      qr/^Parameter 'offset' is out of the range/, 'offset out of range');
+}
+
+done_testing();
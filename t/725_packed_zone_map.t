@@ -0,0 +1,148 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use List::Util qw[];
+
+use lib 't';
+use Util qw[pack_moments unpack_moments %scale random_nanosecond random_offset];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+srand(42);
+
+sub candidates {
+    my ($zone_map, $from, $to) = @_;
+    return [unpack 'q*', Time::Moment::Packed::candidate_blocks($zone_map, $from, $to)];
+}
+
+# The blocks whose smallest and largest moments overlap [from, to)
+sub overlapping {
+    my ($moments, $block, $from, $to) = @_;
+    my @r;
+    return \@r unless $from->is_before($to);
+    for (my $b = 0; $b * $block < @$moments; $b++) {
+        my @m = @$moments[$b * $block .. List::Util::min(($b + 1) * $block, scalar @$moments) - 1];
+        my ($min, $max) = ($m[0], $m[0]);
+        foreach my $tm (@m) {
+            $min = $tm if $tm->is_before($min);
+            $max = $tm if $tm->is_after($max);
+        }
+        push @r, $b if !$max->is_before($from) && $min->is_before($to);
+    }
+    return \@r;
+}
+
+my $base = Time::Moment->from_string('2012-12-24T00:00:00Z');
+foreach my $format (sort keys %scale) {
+    # Roughly ascending with some disorder, as appended by a logger
+    my @moments = map {
+        my $nsec = random_nanosecond($format);
+        $base->plus_seconds($_ * 60 + int(rand(600)))->plus_nanoseconds($nsec)
+             ->with_offset_same_instant(random_offset());
+    } 0 .. 999;
+    my $packed = pack_moments($format, @moments);
+    @moments = unpack_moments($format, $packed);
+
+    foreach my $block (1, 64, 100, 1000, 4096) {
+        my $zm = Time::Moment::Packed::zone_map($packed, $format, $block);
+        my $blocks = int((@moments + $block - 1) / $block);
+        is(length $zm, 24 + 16 * $blocks, "$format/$block: size");
+        is_deeply([Time::Moment::Packed::zone_map_info($zm)], [$format, $block, 1000],
+          "$format/$block: zone_map_info");
+
+        foreach my $case ([100, 160], [0, 1], [500, 2000], [-50, 10], [998, 999], [300, 300]) {
+            my $from = $base->plus_minutes($case->[0])->plus_nanoseconds(int(rand(1e9)));
+            my $to   = $base->plus_minutes($case->[1])->plus_nanoseconds(int(rand(1e9)));
+            my $got  = candidates($zm, $from, $to);
+            my $name = "$format/$block: [$case->[0], $case->[1])";
+            if ($format eq 'moment') {
+                my %got = map { $_ => 1 } @$got;
+                my @missing = grep { !$got{$_} } @{ overlapping(\@moments, $block, $from, $to) };
+                is_deeply(\@missing, [], "$name: no block is missed");
+                my %near = map { $_ => 1 } @{ overlapping(\@moments, $block,
+                  $from->minus_seconds(1), $to->plus_seconds(1)) };
+                is_deeply([grep { !$near{$_} } @$got], [], "$name: candidates are within a second");
+            }
+            else {
+                # Elements are whole units, so a range is the same as the one
+                # with its bounds rounded up to the next unit
+                my ($f, $t) = map {
+                    my $r = $_->nanosecond % $scale{$format};
+                    $r ? $_->plus_nanoseconds($scale{$format} - $r) : $_
+                } ($from, $to);
+                is_deeply($got, overlapping(\@moments, $block, $f, $t), $name);
+            }
+        }
+    }
+
+    {
+        my $zm = Time::Moment::Packed::zone_map($packed, $format, 64);
+        my $width = $format eq 'moment' ? 16 : 8;
+        foreach my $n (0, 1, 63, 64, 65, 640, 999) {
+            my $old = Time::Moment::Packed::zone_map(substr($packed, 0, $n * $width), $format, 64);
+            is(Time::Moment::Packed::zone_map_extend($old, $packed), $zm,
+              "$format: zone_map_extend from $n elements");
+        }
+        is(Time::Moment::Packed::zone_map_extend($zm, $packed), $zm,
+          "$format: zone_map_extend without new elements");
+
+        # A copy at an odd address, as read from a file into the middle of a string
+        my $copy = substr("x$zm", 1);
+        is_deeply(candidates($copy, $base, $base->plus_hours(2)),
+          candidates($zm, $base, $base->plus_hours(2)), "$format: unaligned zone map");
+    }
+}
+
+{
+    my $zm = Time::Moment::Packed::zone_map('', 'seconds', 16);
+    is(length $zm, 24, 'empty buffer');
+    is_deeply(candidates($zm, $base, $base->plus_days(1)), [], 'empty buffer has no candidates');
+
+    my $packed = pack 'q*', map { $base->epoch + $_ } 0 .. 99;
+    $zm = Time::Moment::Packed::zone_map($packed, 'seconds', 16);
+    is_deeply(candidates($zm, $base->plus_seconds(16), $base->plus_seconds(32)), [1],
+      'to is exclusive');
+    is_deeply(candidates($zm, $base->plus_seconds(15), $base->plus_seconds(33)), [0, 1, 2],
+      'from is inclusive');
+    is_deeply(candidates($zm, $base->plus_seconds(50), $base->plus_seconds(50)), [],
+      'empty range');
+    is_deeply(candidates($zm, $base->plus_seconds(50), $base), [], 'to before from');
+    is_deeply(candidates($zm, $base->plus_seconds(96), $base->plus_days(1)), [6],
+      'last partial block');
+}
+
+{
+    my $packed = pack 'q*', 1 .. 10;
+    like(exception { Time::Moment::Packed::zone_map($packed, 'seconds', 0) },
+      qr/^Parameter 'block_size' is out of the range/, 'block size of zero');
+    like(exception { Time::Moment::Packed::zone_map($packed, 'seconds', 2**31) },
+      qr/^Parameter 'block_size' is out of the range/, 'block size too large');
+    like(exception { Time::Moment::Packed::zone_map('abc', 'seconds', 16) },
+      qr/^buffer is not a packed buffer of 8-byte elements/, 'not a packed buffer');
+    like(exception { Time::Moment::Packed::zone_map($packed, 'days', 16) },
+      qr/^Unrecognised packed format: 'days'/, 'unknown format');
+
+    my $zm = Time::Moment::Packed::zone_map($packed, 'seconds', 4);
+    like(exception { Time::Moment::Packed::zone_map_extend($zm, pack 'q*', 1 .. 9) },
+      qr/^Buffer has fewer elements than the zone map/, 'zone_map_extend of a shorter buffer');
+    foreach my $case (['', 'empty'], [substr($zm, 0, -1), 'truncated'], ["$zm\0", 'trailing byte'],
+                      ['x' . substr($zm, 1), 'bad magic'], [pack('q*', 1 .. 8), 'not a zone map'],
+                      [substr($zm, 0, 8) . pack('L L Q', 1, 0, 2**62), 'number of blocks wraps the size']) {
+        like(exception { Time::Moment::Packed::zone_map_info($case->[0]) },
+          qr/^Zone map is invalid/, "invalid zone map: $case->[1]");
+    }
+    like(exception { Time::Moment::Packed::candidate_blocks('', $base, $base) },
+      qr/^Zone map is invalid/, 'candidate_blocks of an invalid zone map');
+    like(exception { Time::Moment::Packed::candidate_blocks(
+      substr($zm, 0, 8) . pack('L L Q', 1, 0, 2**62), $base, $base) },
+      qr/^Zone map is invalid/, 'candidate_blocks of a zone map with a forged number of elements');
+}
+
+done_testing();
@@ -0,0 +1,117 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use lib 't';
+use Util qw[pack_moments unpack_moments %scale random_nanosecond random_sorted_moments];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+srand(42);
+
+# The multiset operations, as std::set_union and friends
+sub setop {
+    my ($op, $a, $b) = @_;
+    my ($i, $j, @r) = (0, 0);
+    while ($i < @$a && $j < @$b) {
+        my $c = $a->[$i]->compare($b->[$j]);
+        if ($c < 0) {
+            push @r, $a->[$i] if $op ne 'intersection';
+            $i++;
+        }
+        elsif ($c > 0) {
+            push @r, $b->[$j] if $op eq 'union';
+            $j++;
+        }
+        else {
+            push @r, $a->[$i] if $op ne 'difference';
+            $i++, $j++;
+        }
+    }
+    push @r, @$a[$i .. $#$a] if $op ne 'intersection';
+    push @r, @$b[$j .. $#$b] if $op eq 'union';
+    return @r;
+}
+
+sub strings { [map { $_->to_string } @_] }
+
+my $base = Time::Moment->from_string('2012-12-24T00:00:00Z');
+foreach my $format (sort keys %scale) {
+    # Few distinct instants so that the buffers share many, some of them repeated
+    my @pool = map {
+        my $nsec = random_nanosecond($format);
+        $base->plus_seconds(int(rand(86400 * 3)))->plus_nanoseconds($nsec);
+    } 1 .. 50;
+    my @sets = map {
+        my $n = $_;
+        [ random_sorted_moments($format, $n, sub { $pool[rand @pool] }) ]
+    } (0, 1, 40, 100);
+
+    foreach my $x (@sets) {
+        foreach my $y (@sets) {
+            my $pa = pack_moments($format, @$x);
+            my $pb = pack_moments($format, @$y);
+            foreach my $op (qw(union intersection difference)) {
+                my $got = Time::Moment::Packed->can($op)->($pa, $pb, $format);
+                is_deeply(strings(unpack_moments($format, $got)), strings(setop($op, $x, $y)),
+                  sprintf '%s: %s of %d and %d elements', $format, $op, scalar @$x, scalar @$y);
+            }
+        }
+    }
+
+    my @moments = @{ $sets[-1] };
+    my $packed = pack_moments($format, @moments);
+    foreach my $precision (-3 .. 9) {
+        my @expected;
+        foreach my $tm (@moments) {
+            push @expected, $tm
+              unless @expected && $expected[-1]->compare($tm, precision => $precision) == 0;
+        }
+        my $got = Time::Moment::Packed::dedupe($packed, $format, $precision);
+        is_deeply(strings(unpack_moments($format, $got)), strings(@expected),
+          "$format: dedupe at precision $precision");
+    }
+    is(Time::Moment::Packed::dedupe($packed, $format),
+       Time::Moment::Packed::dedupe($packed, $format, 9), "$format: dedupe at full precision by default");
+    is(Time::Moment::Packed::dedupe('', $format), '', "$format: dedupe of an empty buffer");
+}
+
+{
+    # Epoch counts before 1970 are truncated downwards
+    my $packed = pack 'q*', -86401, -86400, -1, 0, 1, 86399, 86400;
+    is_deeply([unpack 'q*', Time::Moment::Packed::dedupe($packed, 'seconds', -3)],
+      [-86401, -86400, 0, 86400], 'dedupe by day of counts before the epoch');
+    $packed = pack 'q*', -1500, -1000, -999, -1, 0, 999;
+    is_deeply([unpack 'q*', Time::Moment::Packed::dedupe($packed, 'milliseconds', 0)],
+      [-1500, -1000, 0], 'dedupe by second of milliseconds before the epoch');
+    is_deeply([unpack 'q*', Time::Moment::Packed::dedupe($packed, 'milliseconds', 9)],
+      [unpack 'q*', $packed], 'a precision finer than the unit compares the counts');
+
+    # Records of the same instant at different offsets are the same element
+    my $a = pack_moments('moment', map { Time::Moment->from_string($_) }
+      '2012-12-24T12:00Z', '2012-12-24T13:00Z');
+    my $b = pack_moments('moment', map { Time::Moment->from_string($_) }
+      '2012-12-24T14:00+01:00', '2012-12-24T15:00+01:00');
+    is_deeply(strings(unpack_moments('moment', Time::Moment::Packed::union($a, $b, 'moment'))),
+      [qw(2012-12-24T12:00:00Z 2012-12-24T13:00:00Z 2012-12-24T15:00:00+01:00)],
+      'union compares instants and copies common elements from a');
+}
+
+{
+    like(exception { Time::Moment::Packed::union('abc', '', 'seconds') },
+      qr/^a is not a packed buffer of 8-byte elements/, 'a is not a packed buffer');
+    like(exception { Time::Moment::Packed::difference('', 'abc', 'seconds') },
+      qr/^b is not a packed buffer of 8-byte elements/, 'b is not a packed buffer');
+    like(exception { Time::Moment::Packed::dedupe('', 'seconds', 10) },
+      qr/^Parameter 'precision' is out of the range/, 'precision out of range');
+    like(exception { Time::Moment::Packed::intersection('', '', 'days') },
+      qr/^Unrecognised packed format: 'days'/, 'unknown format');
+}
+
+done_testing();
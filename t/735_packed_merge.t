@@ -0,0 +1,74 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use lib 't';
+use Util qw[pack_moments %scale random_nanosecond random_sorted_moments];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+srand(42);
+
+sub merged {
+    my ($format, @buffers) = @_;
+    my ($sources, $indices) = Time::Moment::Packed::merge($format, @buffers);
+    my @s = unpack 'l*', $sources;
+    my @i = unpack 'q*', $indices;
+    is(scalar @s, scalar @i, "$format: as many sources as indices");
+    return [map { [$s[$_], $i[$_]] } 0 .. $#s];
+}
+
+my $base = Time::Moment->from_string('2012-12-24T00:00:00Z');
+foreach my $format (sort keys %scale) {
+    my @pool = map {
+        my $nsec = random_nanosecond($format);
+        $base->plus_seconds(int(rand(86400)))->plus_nanoseconds($nsec);
+    } 1 .. 200;
+
+    foreach my $k (0, 1, 2, 7, 30) {
+        my @streams = map {
+            my $n = int(rand(60)) * ($_ % 5 != 3);
+            [ random_sorted_moments($format, $n, sub { $pool[rand @pool] }) ]
+        } 1 .. $k;
+
+        # A stable sort of all elements by instant, then by stream
+        my @expected = sort {
+            $streams[$a->[0]][$a->[1]]->compare($streams[$b->[0]][$b->[1]]) || $a->[0] <=> $b->[0]
+        } map { my $s = $_; map { [$s, $_] } 0 .. $#{ $streams[$s] } } 0 .. $#streams;
+
+        my $got = merged($format, map { pack_moments($format, @$_) } @streams);
+        is_deeply($got, \@expected, "$format: merge of $k buffers");
+    }
+}
+
+{
+    my $a = pack 'q*', 1, 3, 3, 5;
+    my $b = pack 'q*', 3, 4;
+    is_deeply(merged('seconds', $a, $b, '', $a),
+      [[0,0], [3,0], [0,1], [0,2], [1,0], [3,1], [3,2], [1,1], [0,3], [3,3]],
+      'equal elements are ordered by buffer, then by index');
+    is_deeply(merged('seconds'), [], 'no buffers');
+    is_deeply(merged('seconds', '', ''), [], 'empty buffers');
+
+    my $m = pack_moments('moment', map { Time::Moment->from_string($_) }
+      '2012-12-24T12:00+02:00', '2012-12-24T11:00Z');
+    my $n = pack_moments('moment', map { Time::Moment->from_string($_) }
+      '2012-12-24T10:30Z', '2012-12-24T12:59:59+02:00');
+    is_deeply(merged('moment', $m, $n), [[0,0], [1,0], [1,1], [0,1]],
+      'moments are ordered by instant');
+}
+
+{
+    like(exception { Time::Moment::Packed::merge('seconds', pack('q', 1), 'abc') },
+      qr/^buffer is not a packed buffer of 8-byte elements/, 'not a packed buffer');
+    like(exception { Time::Moment::Packed::merge('days') },
+      qr/^Unrecognised packed format: 'days'/, 'unknown format');
+}
+
+done_testing();
@@ -0,0 +1,127 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use lib 't';
+use Util qw[pack_moments %scale random_nanosecond random_sorted_moments];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+srand(42);
+
+# The match of each element of left, by scanning right
+sub expected {
+    my ($left, $right, $direction, $tolerance, $unit) = @_;
+    my @r;
+    foreach my $l (@$left) {
+        my ($back, $fwd);
+        for my $j (0 .. $#$right) {
+            $back = $j unless $right->[$j]->is_after($l);
+        }
+        for my $j (reverse 0 .. $#$right) {
+            $fwd = $j unless $right->[$j]->is_before($l);
+        }
+        if (defined $tolerance) {
+            if (defined $back) {
+                my $limit = eval { $l->${\"minus_$unit"}($tolerance) };
+                undef $back if $limit && $right->[$back]->is_before($limit);
+            }
+            if (defined $fwd) {
+                my $limit = eval { $l->${\"plus_$unit"}($tolerance) };
+                undef $fwd if $limit && $right->[$fwd]->is_after($limit);
+            }
+        }
+        undef $fwd  if $direction eq 'backward';
+        undef $back if $direction eq 'forward';
+        if (defined $back && defined $fwd) {
+            push @r, $right->[$fwd]->delta_nanoseconds($l) * -1 < $l->delta_nanoseconds($right->[$back]) * -1
+              ? $fwd : $back;
+        }
+        else {
+            push @r, $back // $fwd // -1;
+        }
+    }
+    return \@r;
+}
+
+sub asof {
+    my ($indices, $count) = Time::Moment::Packed::asof(@_);
+    my @r = unpack 'q*', $indices;
+    is($count, scalar(grep { $_ >= 0 } @r), 'number of matches');
+    return \@r;
+}
+
+my $base = Time::Moment->from_string('2012-01-30T00:00:00Z');
+foreach my $format (sort keys %scale) {
+    my $sorted = sub {
+        my ($n, $spread) = @_;
+        [ random_sorted_moments($format, $n, sub {
+            my $nsec = random_nanosecond($format);
+            $base->plus_seconds(int(rand($spread)))->plus_nanoseconds($nsec);
+        }) ]
+    };
+    my @left  = @{ $sorted->(120, 86400 * 70) };
+    my @right = @{ $sorted->(40, 86400 * 60) };
+    # Exact matches and a run of equal elements
+    push @right, $left[50], $left[50], $left[60];
+    @right = sort { $a->compare($b) } @right;
+    my $pl = pack_moments($format, @left);
+    my $pr = pack_moments($format, @right);
+
+    foreach my $direction (qw(backward forward nearest)) {
+        is_deeply(asof($pl, $pr, $format, $direction), expected(\@left, \@right, $direction),
+          "$format: $direction");
+        foreach my $tolerance ([0, 'seconds'], [3, 'hours'], [90, 'minutes'], [1500, 'milliseconds'],
+                               [2, 'days'], [1, 'weeks'], [1, 'months'], [10000, 'years'],
+                               ['9000000000000000000', 'nanoseconds']) {
+            my ($value, $unit) = @$tolerance;
+            is_deeply(asof($pl, $pr, $format, $direction, $value, $unit),
+              expected(\@left, \@right, $direction, $value, $unit),
+              "$format: $direction within $value $unit");
+        }
+    }
+    is_deeply(asof($pl, $pr, $format), asof($pl, $pr, $format, 'backward'),
+      "$format: backward by default");
+    is_deeply(asof($pl, '', $format), [(-1) x @left], "$format: empty right");
+    is_deeply(asof('', $pr, $format), [], "$format: empty left");
+}
+
+{
+    my $left  = pack 'q*', 10, 20, 30, 40;
+    my $right = pack 'q*', 15, 20, 20, 35;
+    is_deeply(asof($left, $right, 'seconds', 'backward'), [-1, 2, 2, 3], 'backward takes the last of equal elements');
+    is_deeply(asof($left, $right, 'seconds', 'forward'), [0, 1, 3, -1], 'forward takes the first of equal elements');
+    is_deeply(asof($left, $right, 'seconds', 'nearest'), [0, 2, 3, 3], 'nearest');
+    is_deeply(asof(pack('q', 25), pack('q*', 20, 30), 'seconds', 'nearest'), [0], 'nearest prefers backward on a tie');
+    is_deeply(asof($left, $right, 'seconds', 'nearest', 4, 'seconds'), [-1, 2, -1, -1], 'nearest within a tolerance');
+
+    # Counts far beyond the range of Time::Moment
+    my $big = pack 'q*', -9e18, 9e18;
+    is_deeply(asof($big, $big, 'seconds', 'nearest', 1, 'seconds'), [0, 1], 'counts out of range');
+    is_deeply(asof(pack('q', 9e18), pack('q', -9e18), 'seconds', 'backward', '9000000000000000000', 'seconds'),
+      [-1], 'difference of counts beyond int64');
+}
+
+{
+    my $buf = pack 'q*', 1, 2;
+    like(exception { Time::Moment::Packed::asof($buf, $buf, 'seconds', 'sideways') },
+      qr/^Unrecognised direction: 'sideways'/, 'unknown direction');
+    like(exception { Time::Moment::Packed::asof($buf, $buf, 'seconds', 'nearest', -1, 'seconds') },
+      qr/^Parameter 'tolerance' is out of range/, 'negative tolerance');
+    like(exception { Time::Moment::Packed::asof($buf, $buf, 'seconds', 'nearest', 1) },
+      qr/^Parameter 'unit' is required with a tolerance/, 'tolerance without a unit');
+    like(exception { Time::Moment::Packed::asof($buf, $buf, 'seconds', 'nearest', 1, 'fortnights') },
+      qr/^Unrecognised unit: 'fortnights'/, 'unknown unit');
+    like(exception { Time::Moment::Packed::asof('abc', $buf, 'seconds') },
+      qr/^left is not a packed buffer of 8-byte elements/, 'left is not a packed buffer');
+    like(exception { Time::Moment::Packed::asof($buf, 'abc', 'seconds') },
+      qr/^right is not a packed buffer of 8-byte elements/, 'right is not a packed buffer');
+}
+
+done_testing();
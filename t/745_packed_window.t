@@ -0,0 +1,128 @@
+#!perl
+use strict;
+use warnings;
+
+use Test::More;
+use Test::Fatal;
+
+use lib 't';
+use Util qw[pack_moments unpack_moments %scale random_nanosecond];
+
+BEGIN {
+    use_ok('Time::Moment');
+    use_ok('Time::Moment::Packed');
+}
+
+srand(42);
+
+# The window of each element, by scanning the whole buffer
+sub expected {
+    my ($moments, $window, $unit) = @_;
+    my $delta = "delta_$unit";
+    my (@counts, @first, @last);
+    foreach my $tm (@$moments) {
+        my @in = grep {
+            my $other = $moments->[$_];
+            !$other->is_after($tm) && $other->$delta($tm) < $window
+        } 0 .. $#$moments;
+        push @counts, scalar @in;
+        push @first, @in ? $in[0] : -1;
+        push @last, @in ? $in[-1] : -1;
+    }
+    return (\@counts, \@first, \@last);
+}
+
+my $base = Time::Moment->from_string('2012-01-30T00:00:00Z');
+foreach my $format (sort keys %scale) {
+    # Bursts of events, some at the same instant, at a single offset so that
+    # the calendar units count days in the same local time
+    my $offset = $format eq 'moment' ? 330 : 0;
+    my @moments;
+    my $tm = $base;
+    for (1 .. 150) {
+        my $nsec = random_nanosecond($format);
+        $tm = $tm->plus_seconds(int(rand(4)) ? int(rand(600)) : int(rand(86400 * 20)))
+                 ->with_nanosecond($nsec) unless $_ % 7 == 0;
+        push @moments, $tm->with_offset_same_instant($offset);
+    }
+    @moments = unpack_moments($format, pack_moments($format, @moments));
+    my $packed = pack_moments($format, @moments);
+
+    foreach my $case ([1, 'seconds'], [300, 'seconds'], [2, 'hours'], [45, 'minutes'],
+                      [1500, 'milliseconds'], [1, 'days'], [3, 'weeks'], [1, 'months'],
+                      [1, 'years'], ['9000000000000000000', 'nanoseconds']) {
+        my ($window, $unit) = @$case;
+        my ($counts, $first, $last) = Time::Moment::Packed::window_counts($packed, $format, $window, $unit);
+        my ($ec, $ef, $el) = expected(\@moments, $window, $unit);
+        is_deeply([unpack 'q*', $counts], $ec, "$format: counts in $window $unit");
+        is_deeply([unpack 'q*', $first], $ef, "$format: first index in $window $unit");
+        is_deeply([unpack 'q*', $last], $el, "$format: last index in $window $unit");
+        is(scalar Time::Moment::Packed::window_counts($packed, $format, $window, $unit), $counts,
+          "$format: counts in scalar context in $window $unit");
+    }
+}
+
+{
+    my $packed = pack 'q*', 0, 10, 10, 15, 20, 40;
+    my ($counts, $first, $last) = Time::Moment::Packed::window_counts($packed, 'seconds', 10, 'seconds');
+    is_deeply([unpack 'q*', $counts], [1, 2, 2, 3, 2, 1], 'window is half-open towards the past');
+    is_deeply([unpack 'q*', $first], [0, 1, 1, 1, 3, 5], 'first index');
+    is_deeply([unpack 'q*', $last], [0, 2, 2, 3, 4, 5], 'last index includes elements of the same instant');
+    is(Time::Moment::Packed::window_counts('', 'seconds', 10, 'seconds'), '', 'empty buffer');
+
+    # Counts out of the range of Time::Moment have no calendar date
+    $packed = pack 'q*', -9e18, 0, 9e18;
+    is_deeply([unpack 'q*', scalar Time::Moment::Packed::window_counts($packed, 'seconds', 1, 'days')],
+      [0, 1, 0], 'elements that are not valid moments have empty windows');
+    $counts = Time::Moment::Packed::window_counts($packed, 'seconds', '9000000000000000001', 'seconds');
+    is_deeply([unpack 'q*', $counts], [1, 2, 2], 'time units are computed from the counts');
+}
+
+{
+    # Records that are not valid moments in the middle of a buffer
+    my $t = Time::Moment->from_string('2012-12-24T12:00:00Z');
+    my $invalid = pack 'q l l', $t->rdn * 86400 + $t->second_of_day, -1, 0;
+    my $packed = pack_moments('moment', $t) . $invalid . pack_moments('moment', $t->plus_seconds(1));
+    my ($counts, $first, $last) = Time::Moment::Packed::window_counts($packed, 'moment', 10, 'seconds');
+    is_deeply([unpack 'q*', $counts], [1, 0, 2], 'invalid record is not counted');
+    is_deeply([unpack 'q*', $first], [0, -1, 0], 'invalid record does not move the first index');
+    is_deeply([unpack 'q*', $last], [0, -1, 2], 'invalid record is not an element of the same instant');
+
+    my @moments = map { $t->plus_seconds($_ * 7) } 0 .. 59;
+    my %invalid = map { $_ => 1 } (0, 1, 13, 14, 15, 30, 59);
+    my (@records, @valid);
+    foreach my $i (0 .. $#moments) {
+        push @records, $invalid if $invalid{$i};
+        push @valid, scalar @records;
+        push @records, pack_moments('moment', $moments[$i]);
+    }
+    foreach my $case ([1, 'minutes'], [30, 'seconds'], [1, 'days']) {
+        my ($window, $unit) = @$case;
+        my ($ec, $ef, $el) = expected(\@moments, $window, $unit);
+        # The records that are not valid moments have empty windows
+        my @c = (0) x @records;
+        my @f = (-1) x @records;
+        my @l = (-1) x @records;
+        foreach my $k (0 .. $#valid) {
+            $c[$valid[$k]] = $ec->[$k];
+            $f[$valid[$k]] = $valid[$ef->[$k]];
+            $l[$valid[$k]] = $valid[$el->[$k]];
+        }
+        my ($counts, $first, $last) =
+          Time::Moment::Packed::window_counts(join('', @records), 'moment', $window, $unit);
+        is_deeply([unpack 'q*', $counts], \@c, "counts with invalid records in $window $unit");
+        is_deeply([unpack 'q*', $first], \@f, "first index with invalid records in $window $unit");
+        is_deeply([unpack 'q*', $last], \@l, "last index with invalid records in $window $unit");
+    }
+}
+
+{
+    like(exception { Time::Moment::Packed::window_counts('', 'seconds', 0, 'seconds') },
+      qr/^Parameter 'window' is out of range/, 'empty window');
+    like(exception { Time::Moment::Packed::window_counts('', 'seconds', 1, 'fortnights') },
+      qr/^Unrecognised unit: 'fortnights'/, 'unknown unit');
+    like(exception { Time::Moment::Packed::window_counts('abc', 'seconds', 1, 'seconds') },
+      qr/^buffer is not a packed buffer of 8-byte elements/, 'not a packed buffer');
+}
+
+done_testing();
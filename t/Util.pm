@@ -7,7 +7,9 @@ use Carp        qw[];
 use Test::Fatal qw[exception lives_ok];
 
 BEGIN {
-    our @EXPORT_OK  = qw[ throws_ok warns_ok lives_ok ];
+    our @EXPORT_OK  = qw[ throws_ok warns_ok lives_ok pack_moments unpack_moments
+                          %scale %range random_nanosecond random_offset
+                          random_sorted_moments ];
     our %EXPORT_TAGS = (
         all => [ @EXPORT_OK ],
     );
@@ -72,5 +74,90 @@ sub warns_ok (&$;$) {
     }
 }
 
+my %UnitsPerSecond = (
+    seconds      => 1,
+    milliseconds => 1_000,
+    microseconds => 1_000_000,
+    nanoseconds  => 1_000_000_000,
+);
+
+# Packs instances of Time::Moment in the formats of Time::Moment::Packed
+sub pack_moments {
+    my ($format, @moments) = @_;
+
+    if ($format eq 'moment') {
+        return join '', map {
+            pack 'q l l', $_->rdn * 86400 + $_->second_of_day, $_->nanosecond, $_->offset
+        } @moments;
+    }
+    my $u = $UnitsPerSecond{$format} or Carp::croak("Unknown format: '$format'");
+    return pack 'q*', map {
+        $_->epoch * $u + int($_->nanosecond / (1_000_000_000 / $u))
+    } @moments;
+}
+
+sub unpack_moments {
+    my ($format, $packed) = @_;
+
+    if ($format eq 'moment') {
+        return map {
+            my ($sec, $nsec, $offset) = unpack 'q l l', substr($packed, 16 * $_, 16);
+            my $rdn = int($sec / 86400);
+            my $sod = $sec % 86400;
+            Time::Moment->from_rd($rdn, offset => $offset)
+                        ->with_second_of_day($sod)
+                        ->with_nanosecond($nsec);
+        } 0 .. length($packed) / 16 - 1;
+    }
+    my $u = $UnitsPerSecond{$format} or Carp::croak("Unknown format: '$format'");
+    return map {
+        my $sec = int($_ / $u);
+        my $rem = $_ - $sec * $u;
+        if ($rem < 0) {
+            $sec--;
+            $rem += $u;
+        }
+        Time::Moment->from_epoch($sec, $rem * (1_000_000_000 / $u));
+    } unpack 'q*', $packed;
+}
+
+# Nanoseconds per unit of resolution of the formats of Time::Moment::Packed
+our %scale = (
+    seconds      => 1e9,
+    milliseconds => 1e6,
+    microseconds => 1e3,
+    nanoseconds  => 1,
+    moment       => 1,
+);
+
+# Epoch seconds representable in each format, a day inside the range of
+# Time::Moment so that any offset can be applied
+our %range = (
+    seconds      => [-62135596800 + 86400, 253402300799 - 86400],
+    milliseconds => [-62135596800 + 86400, 253402300799 - 86400],
+    microseconds => [-62135596800 + 86400, 253402300799 - 86400],
+    nanoseconds  => [-9223372036, 9223372035],
+    moment       => [-62135596800 + 86400, 253402300799 - 86400],
+);
+
+sub random_nanosecond {
+    my ($format) = @_;
+    my $s = $scale{$format} or Carp::croak("Unknown format: '$format'");
+    return int(rand(1e9) / $s) * $s;
+}
+
+sub random_offset {
+    return int(rand(2161)) - 1080;
+}
+
+# Returns $n moments made by $generator at random offsets, sorted by instant
+# and as stored in the given format
+sub random_sorted_moments {
+    my ($format, $n, $generator) = @_;
+    return unpack_moments($format, pack_moments($format, sort { $a->compare($b) } map {
+        $generator->()->with_offset_same_instant(random_offset())
+    } 1 .. $n));
+}
+
 1;
 